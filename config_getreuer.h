@@ -33,6 +33,16 @@
 #define IS_COMMAND() (get_mods() == MOD_MASK_CTRL)
 
 #define ACHORDION_STREAK
+// Settle up to 4 tap-hold keys together, so that fast same-hand rolls over
+// home row mods are typed as taps.
+#define ACHORDION_MAX_PENDING 4
+// Use the per-key handedness table ACHORDION_HAND_LAYOUT_LR in layout.h.
+#define ACHORDION_HAND_LAYOUT
+// Where deferred execution is enabled, use it for Achordion's timeouts rather
+// than polling in achordion_task().
+#ifdef DEFERRED_EXEC_ENABLE
+#define ACHORDION_DEFER_EXEC
+#endif  // DEFERRED_EXEC_ENABLE
 
 // Holding Shift while Caps Word is active inverts the shift state.
 #define CAPS_WORD_INVERT_ON_SHIFT
@@ -42,14 +52,33 @@
 // Don't apply custom shift keys with mods other than Shift.
 #define CUSTOM_SHIFT_KEYS_NEGMODS ~MOD_MASK_SHIFT
 
-// Only apply custom shift keys on layer 0.
-#define CUSTOM_SHIFT_KEYS_LAYER_MASK (1 << 0)
+// Custom shift keys are defined per layer, currently only for the base layer.
+#define CUSTOM_SHIFT_KEYS_PER_LAYER
+
+// The custom shift keys tables are sorted by keycode.
+#define CUSTOM_SHIFT_KEYS_SORTED
+
+// Persist Key Stats in the EEPROM user datablock.
+#ifdef KEY_STATS_ENABLE
+#define EECONFIG_USER_DATA_SIZE 512
+#endif  // KEY_STATS_ENABLE
+
+// Look up keycode names for debug logging with a hash index.
+#define KEYCODE_STRING_INDEX
 
 // When idle, turn off Layer Lock after 60 seconds.
 #define LAYER_LOCK_IDLE_TIMEOUT 60000
 
+// Where deferred execution is enabled, use it for the shared idle timeouts
+// (features/idle_timeout.h) rather than checking in idle_timeout_task().
+#ifdef DEFERRED_EXEC_ENABLE
+#define IDLE_TIMEOUT_DEFER_EXEC
+#endif  // DEFERRED_EXEC_ENABLE
+
 // When idle, turn off Sentence Case after 2 seconds.
 #define SENTENCE_CASE_TIMEOUT 2000
+// Don't end sentences at the abbreviations in sentence_case_abbrev_dict.txt.
+#define SENTENCE_CASE_ABBREVIATIONS
 
 // Enable all effects and palettes in PaletteFx.
 #define PALETTEFX_ENABLE_ALL_EFFECTS
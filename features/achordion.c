@@ -26,6 +26,10 @@
 // Attempt to detect out-of-date QMK installation, which would fail with
 // implicit-function-declaration errors in the code below.
 #error "achordion: QMK version is too old to build. Please update QMK."
+#elif defined(ACHORDION_DEFER_EXEC) && !defined(DEFERRED_EXEC_ENABLE)
+// ACHORDION_DEFER_EXEC uses the deferred execution API, which must be enabled
+// by adding `DEFERRED_EXEC_ENABLE = yes` in rules.mk.
+#error "achordion: ACHORDION_DEFER_EXEC requires DEFERRED_EXEC_ENABLE."
 #else
 
 // Copy of the `record` and `keycode` args for the current active tap-hold key.
@@ -33,11 +37,30 @@ static keyrecord_t tap_hold_record;
 static uint16_t tap_hold_keycode = KC_NO;
 // Timeout timer. When it expires, the key is considered held.
 static uint16_t hold_timer = 0;
+#ifdef ACHORDION_DEFER_EXEC
+// Deferred execution tokens for the hold timeout and streak expiry.
+static deferred_token hold_token = INVALID_DEFERRED_TOKEN;
+#ifdef ACHORDION_STREAK
+static deferred_token streak_token = INVALID_DEFERRED_TOKEN;
+#endif  // ACHORDION_STREAK
+#endif  // ACHORDION_DEFER_EXEC
 // Eagerly applied mods, if any.
 static uint8_t eager_mods = 0;
 // Flag to determine whether another key is pressed within the timeout.
 static bool pressed_another_key_before_release = false;
 
+#if ACHORDION_MAX_PENDING > 1
+// Tap-hold keys pressed while the active tap-hold key is unsettled, in the
+// order they were pressed. They are settled along with the active key.
+static keyrecord_t pending_records[ACHORDION_MAX_PENDING - 1];
+static uint16_t pending_keycodes[ACHORDION_MAX_PENDING - 1];
+static uint8_t num_pending = 0;
+// Positions of pending keys that were settled as tapped. Their releases are
+// blocked, since the tap has already been plumbed.
+static keypos_t tapped_keys[ACHORDION_MAX_PENDING - 1];
+static uint8_t num_tapped = 0;
+#endif  // ACHORDION_MAX_PENDING > 1
+
 #ifdef ACHORDION_STREAK
 // Timer for typing streak
 static uint16_t streak_timer = 0;
@@ -63,11 +86,78 @@ enum {
 };
 static uint8_t achordion_state = STATE_RELEASED;
 
+#ifdef ACHORDION_STREAK_ADAPTIVE
+// Moving average of the interval between presses in a streak, in units of
+// 1/16 ms (Q12.4 fixed point).
+static uint16_t interval_q4 = ACHORDION_STREAK_ADAPTIVE_INITIAL_INTERVAL << 4;
+// Time of the last press in a streak.
+static uint16_t last_press_time = 0;
+
+// Updates the moving average with the interval since the last press.
+static void update_interval(keyrecord_t* record) {
+  const uint16_t elapsed = record->event.time - last_press_time;
+  // Skip replayed events, which are no newer than the last press. Only times
+  // up to 256 ms before the last press count as replays: after a long pause,
+  // `elapsed` is also large, and that press must still reset the timer.
+  if (elapsed == 0 || elapsed > 0xFF00) { return; }
+  last_press_time = record->event.time;
+  if (elapsed > ACHORDION_STREAK_ADAPTIVE_MAX_INTERVAL) { return; }
+  // Exponentially weighted moving average with a weight of 1/8 on the new
+  // sample.
+  interval_q4 += ((int16_t)(elapsed << 4) - (int16_t)interval_q4) >> 3;
+}
+
+uint16_t achordion_streak_interval(void) { return interval_q4 >> 4; }
+
+// Returns `x` clamped to [lo, hi].
+static uint16_t clamp_u16(uint16_t x, uint16_t lo, uint16_t hi) {
+  return x < lo ? lo : (x > hi ? hi : x);
+}
+
+uint16_t achordion_adaptive_streak_timeout(void) {
+  return clamp_u16((3 * (uint32_t)interval_q4) >> 5,
+                   ACHORDION_STREAK_ADAPTIVE_MIN_TIMEOUT,
+                   ACHORDION_STREAK_ADAPTIVE_MAX_TIMEOUT);
+}
+
+uint16_t achordion_adaptive_timeout(void) {
+  return clamp_u16((5 * (uint32_t)interval_q4) >> 4,
+                   ACHORDION_ADAPTIVE_MIN_TIMEOUT,
+                   ACHORDION_ADAPTIVE_MAX_TIMEOUT);
+}
+#endif  // ACHORDION_STREAK_ADAPTIVE
+
 #ifdef ACHORDION_STREAK
+#ifdef ACHORDION_DEFER_EXEC
+// Deferred execution callback that clears the streak timer once it expires.
+// While the streak continues, the callback reschedules itself for the new
+// expiry time, rather than being canceled and scheduled on every key.
+static uint32_t streak_expiry_callback(uint32_t trigger_time, void* cb_arg) {
+  if (streak_timer) {
+    const uint16_t elapsed = timer_read() - streak_timer;
+    if (elapsed < ACHORDION_STREAK_MAX_TIMEOUT) {
+      return ACHORDION_STREAK_MAX_TIMEOUT - elapsed;  // Not yet expired.
+    }
+    streak_timer = 0;  // Expired.
+  }
+  streak_token = INVALID_DEFERRED_TOKEN;
+  return 0;
+}
+#endif  // ACHORDION_DEFER_EXEC
+
 static void update_streak_timer(uint16_t keycode, keyrecord_t* record) {
   if (achordion_streak_continue(keycode)) {
+#ifdef ACHORDION_STREAK_ADAPTIVE
+    if (record->event.pressed) { update_interval(record); }
+#endif  // ACHORDION_STREAK_ADAPTIVE
     // We use 0 to represent an unset timer, so `| 1` to force a nonzero value.
     streak_timer = record->event.time | 1;
+#ifdef ACHORDION_DEFER_EXEC
+    if (streak_token == INVALID_DEFERRED_TOKEN) {
+      streak_token = defer_exec(ACHORDION_STREAK_MAX_TIMEOUT,
+                                streak_expiry_callback, NULL);
+    }
+#endif  // ACHORDION_DEFER_EXEC
   } else {
     streak_timer = 0;
   }
@@ -97,8 +187,41 @@ static void recursively_process_record(keyrecord_t* record, uint8_t state) {
   achordion_state = state;
 }
 
+// Plumbs a tap press and release for `record`, leaving the state as `state`.
+static void plumb_tap(keyrecord_t* record, uint8_t state) {
+  dprintln("Achordion: Plumbing tap press.");
+  record->event.pressed = true;
+  record->tap.count = 1;  // Revise event as a tap.
+  record->tap.interrupted = true;
+  // Plumb tap press event.
+  recursively_process_record(record, state);
+
+  send_keyboard_report();
+#if TAP_CODE_DELAY > 0
+  wait_ms(TAP_CODE_DELAY);
+#endif  // TAP_CODE_DELAY > 0
+
+  dprintln("Achordion: Plumbing tap release.");
+  record->event.pressed = false;
+  // Plumb tap release event.
+  recursively_process_record(record, state);
+}
+
+#ifdef ACHORDION_DEFER_EXEC
+// Cancels the hold timeout, if scheduled.
+static void stop_hold_timer(void) {
+  if (hold_token != INVALID_DEFERRED_TOKEN) {
+    cancel_deferred_exec(hold_token);
+    hold_token = INVALID_DEFERRED_TOKEN;
+  }
+}
+#else
+#define stop_hold_timer()
+#endif  // ACHORDION_DEFER_EXEC
+
 // Sends hold press event and settles the active tap-hold key as held.
 static void settle_as_hold(void) {
+  stop_hold_timer();
   if (eager_mods) {
     // If eager mods are being applied, nothing needs to be done besides
     // updating the state.
@@ -113,6 +236,7 @@ static void settle_as_hold(void) {
 
 // Sends tap press and release and settles the active tap-hold key as tapped.
 static void settle_as_tap(void) {
+  stop_hold_timer();
   if (eager_mods) {  // Clear eager mods if set.
 #if defined(RETRO_TAPPING) || defined(RETRO_TAPPING_PER_KEY)
 #ifdef DUMMY_MOD_NEUTRALIZER_KEYCODE
@@ -128,22 +252,79 @@ static void settle_as_tap(void) {
     eager_mods = 0;
   }
 
-  dprintln("Achordion: Plumbing tap press.");
-  tap_hold_record.event.pressed = true;
-  tap_hold_record.tap.count = 1;  // Revise event as a tap.
-  tap_hold_record.tap.interrupted = true;
-  // Plumb tap press event.
-  recursively_process_record(&tap_hold_record, STATE_TAPPING);
+  plumb_tap(&tap_hold_record, STATE_TAPPING);
+}
 
-  send_keyboard_report();
-#if TAP_CODE_DELAY > 0
-  wait_ms(TAP_CODE_DELAY);
-#endif  // TAP_CODE_DELAY > 0
+#if ACHORDION_MAX_PENDING > 1
+// Settles the pending tap-hold keys in the order they were pressed, after the
+// active key has been settled. If `other_record` is NULL, all pending keys are
+// settled as held. Otherwise, each is settled by `achordion_chord()` with the
+// other key.
+static void settle_pending(uint16_t other_keycode, keyrecord_t* other_record) {
+  for (uint8_t i = 0; i < num_pending; ++i) {
+    keyrecord_t* pending_record = &pending_records[i];
+    if (other_record == NULL ||
+        // If there is no room to block the release, settle as held.
+        num_tapped >= ACHORDION_MAX_PENDING - 1 ||
+        achordion_chord(pending_keycodes[i], pending_record, other_keycode,
+                        other_record)) {
+      dprintln("Achordion: Plumbing pending hold press.");
+      recursively_process_record(pending_record, achordion_state);
+    } else {
+      plumb_tap(pending_record, achordion_state);
+      tapped_keys[num_tapped++] = pending_record->event.key;
+    }
+  }
+  num_pending = 0;
+}
 
-  dprintln("Achordion: Plumbing tap release.");
-  tap_hold_record.event.pressed = false;
-  // Plumb tap release event.
-  recursively_process_record(&tap_hold_record, STATE_TAPPING);
+// Returns true if `key` is the position of the active or a pending key.
+static bool is_active_or_pending(keypos_t key) {
+  if (KEYEQ(key, tap_hold_record.event.key)) { return true; }
+  for (uint8_t i = 0; i < num_pending; ++i) {
+    if (KEYEQ(key, pending_records[i].event.key)) { return true; }
+  }
+  return false;
+}
+
+// If `key` is a pending key settled as tapped, forgets it and returns true.
+static bool unblock_tapped_key(keypos_t key) {
+  for (uint8_t i = 0; i < num_tapped; ++i) {
+    if (KEYEQ(key, tapped_keys[i])) {
+      tapped_keys[i] = tapped_keys[--num_tapped];
+      return true;
+    }
+  }
+  return false;
+}
+#else
+#define settle_pending(other_keycode, other_record)
+#endif  // ACHORDION_MAX_PENDING > 1
+
+#ifdef ACHORDION_DEFER_EXEC
+// Deferred execution callback for when the hold timeout expires.
+static uint32_t hold_timeout_callback(uint32_t trigger_time, void* cb_arg) {
+  hold_token = INVALID_DEFERRED_TOKEN;
+  if (achordion_state == STATE_UNSETTLED) {
+    settle_as_hold();  // Timeout expired, settle the key as held.
+    settle_pending(KC_NO, NULL);
+  }
+  return 0;
+}
+#endif  // ACHORDION_DEFER_EXEC
+
+// Starts the hold timeout to expire `timeout` ms after `time`.
+static void start_hold_timer(uint16_t time, uint16_t timeout) {
+  hold_timer = time + timeout;
+#ifdef ACHORDION_DEFER_EXEC
+  stop_hold_timer();
+  const int16_t delay = (int16_t)(hold_timer - timer_read());
+  hold_token = defer_exec(delay > 0 ? delay : 1, hold_timeout_callback, NULL);
+  if (hold_token == INVALID_DEFERRED_TOKEN) {
+    // The deferred execution pool is full. achordion_task() polls instead.
+    dprintln("Achordion: Failed to schedule timeout, polling instead.");
+  }
+#endif  // ACHORDION_DEFER_EXEC
 }
 
 bool process_achordion(uint16_t keycode, keyrecord_t* record) {
@@ -158,6 +339,23 @@ bool process_achordion(uint16_t keycode, keyrecord_t* record) {
   // Check that this is a normal key event, don't act on combos.
   const bool is_key_event = IS_KEYEVENT(record->event);
 
+#if ACHORDION_MAX_PENDING > 1
+  if (!record->event.pressed && is_key_event) {
+    // Block the release of a pending key that was settled as tapped.
+    if (num_tapped && unblock_tapped_key(record->event.key)) {
+      dprintln("Achordion: Pending key released.");
+      return false;
+    }
+    // If the active or a pending key is released while keys are pending,
+    // settle all as held, then continue below to handle the release.
+    if (num_pending && achordion_state == STATE_UNSETTLED &&
+        is_active_or_pending(record->event.key)) {
+      settle_as_hold();
+      settle_pending(KC_NO, NULL);
+    }
+  }
+#endif  // ACHORDION_MAX_PENDING > 1
+
   // Event while no tap-hold key is active.
   if (achordion_state == STATE_RELEASED) {
     if (is_tap_hold && record->tap.count == 0 && record->event.pressed &&
@@ -169,7 +367,7 @@ bool process_achordion(uint16_t keycode, keyrecord_t* record) {
         // Save info about this key.
         tap_hold_keycode = keycode;
         tap_hold_record = *record;
-        hold_timer = record->event.time + timeout;
+        start_hold_timer(record->event.time, timeout);
         pressed_another_key_before_release = false;
         eager_mods = 0;
 
@@ -225,6 +423,7 @@ bool process_achordion(uint16_t keycode, keyrecord_t* record) {
       dprintln("Achordion: Key released.");
     }
 
+    stop_hold_timer();
     achordion_state = STATE_RELEASED;
     tap_hold_keycode = KC_NO;
     return false;
@@ -235,9 +434,31 @@ bool process_achordion(uint16_t keycode, keyrecord_t* record) {
     const uint16_t s_timeout =
         achordion_streak_chord_timeout(tap_hold_keycode, keycode);
     const bool is_streak =
+#if ACHORDION_MAX_PENDING > 1
+        !num_pending &&
+#endif  // ACHORDION_MAX_PENDING > 1
         streak_timer && s_timeout &&
         !timer_expired(record->event.time, (streak_timer + s_timeout));
 #endif
+    // Whether the active tap-hold key must be settled as held regardless of
+    // `achordion_chord()`.
+    const bool force_hold =
+        !is_key_event || (is_tap_hold && record->tap.count == 0);
+
+#if ACHORDION_MAX_PENDING > 1
+    if (!is_streak && is_key_event && is_tap_hold && record->tap.count == 0 &&
+        num_pending < ACHORDION_MAX_PENDING - 1 &&
+        achordion_timeout(keycode) > 0) {
+      // Another tap-hold key is considered by QMK to be held. Hold off on
+      // settling, so that it is settled along with the active key. As when no
+      // key is active, a key with timeout 0 bypasses Achordion and is not held.
+      pending_keycodes[num_pending] = keycode;
+      pending_records[num_pending] = *record;
+      ++num_pending;
+      dprintf("Achordion: Key 0x%04X pending.\n", keycode);
+      return false;  // Skip default handling.
+    }
+#endif  // ACHORDION_MAX_PENDING > 1
 
     // Press event occurred on a key other than the active tap-hold key.
 
@@ -251,11 +472,14 @@ bool process_achordion(uint16_t keycode, keyrecord_t* record) {
     // events back into the handling pipeline so that QMK features and other
     // user code can see them. This is done by calling `process_record()`, which
     // in turn calls most handlers including `process_record_user()`.
+    //
+    // With ACHORDION_MAX_PENDING, held tap-hold keys are instead queued above,
+    // and are settled here with the active key.
     if (!is_streak &&
-        (!is_key_event || (is_tap_hold && record->tap.count == 0) ||
-         achordion_chord(tap_hold_keycode, &tap_hold_record, keycode,
-                         record))) {
+        (force_hold || achordion_chord(tap_hold_keycode, &tap_hold_record,
+                                       keycode, record))) {
       settle_as_hold();
+      settle_pending(keycode, force_hold ? NULL : record);
 
 #ifdef REPEAT_KEY_ENABLE
       // Edge case involving LT + Repeat Key: in a sequence of "LT down, other
@@ -269,6 +493,7 @@ bool process_achordion(uint16_t keycode, keyrecord_t* record) {
 #endif  // REPEAT_KEY_ENABLE
     } else {
       settle_as_tap();
+      settle_pending(keycode, force_hold ? NULL : record);
 
 #ifdef ACHORDION_STREAK
       update_streak_timer(keycode, record);
@@ -279,7 +504,7 @@ bool process_achordion(uint16_t keycode, keyrecord_t* record) {
         const uint16_t timeout = achordion_timeout(keycode);
         tap_hold_keycode = keycode;
         tap_hold_record = *record;
-        hold_timer = record->event.time + timeout;
+        start_hold_timer(record->event.time, timeout);
         achordion_state = STATE_UNSETTLED;
         pressed_another_key_before_release = false;
         return false;
@@ -300,14 +525,22 @@ bool process_achordion(uint16_t keycode, keyrecord_t* record) {
 
 void achordion_task(void) {
   if (achordion_state == STATE_UNSETTLED &&
+#ifdef ACHORDION_DEFER_EXEC
+      // Poll only if the timeout could not be scheduled.
+      hold_token == INVALID_DEFERRED_TOKEN &&
+#endif  // ACHORDION_DEFER_EXEC
       timer_expired(timer_read(), hold_timer)) {
     settle_as_hold();  // Timeout expired, settle the key as held.
+    settle_pending(KC_NO, NULL);
   }
 
 #ifdef ACHORDION_STREAK
-#define MAX_STREAK_TIMEOUT 800
   if (streak_timer &&
-      timer_expired(timer_read(), (streak_timer + MAX_STREAK_TIMEOUT))) {
+#ifdef ACHORDION_DEFER_EXEC
+      streak_token == INVALID_DEFERRED_TOKEN &&
+#endif  // ACHORDION_DEFER_EXEC
+      timer_expired(timer_read(),
+                    (streak_timer + ACHORDION_STREAK_MAX_TIMEOUT))) {
     streak_timer = 0;  // Expired.
   }
 #endif
@@ -323,11 +556,69 @@ static bool on_left_hand(keypos_t pos) {
 #endif
 }
 
+#ifdef ACHORDION_HAND_LAYOUT
+// Hands of keys, as 2-bit codes packed four to a byte.
+enum {
+  HAND_LEFT = 1,
+  HAND_RIGHT = 2,
+  HAND_EXEMPT = HAND_LEFT | HAND_RIGHT,
+};
+static uint8_t hand_bits[(MATRIX_ROWS * MATRIX_COLS + 3) / 4];
+static bool hand_bits_ready = false;
+
+// Packs `achordion_hand_layout` into `hand_bits`.
+static void init_hand_bits(void) {
+  for (uint8_t row = 0; row < MATRIX_ROWS; ++row) {
+    for (uint8_t col = 0; col < MATRIX_COLS; ++col) {
+      const keypos_t pos = {.row = row, .col = col};
+      uint8_t hand;
+      switch (pgm_read_byte(&achordion_hand_layout[row][col])) {
+        case 'L': hand = HAND_LEFT; break;
+        case 'R': hand = HAND_RIGHT; break;
+        case '*': hand = HAND_EXEMPT; break;
+        default: hand = on_left_hand(pos) ? HAND_LEFT : HAND_RIGHT; break;
+      }
+      const uint16_t i = row * MATRIX_COLS + col;
+      hand_bits[i / 4] |= hand << (2 * (i % 4));
+    }
+  }
+  hand_bits_ready = true;
+}
+
+// Returns the HAND_* code of the key at `pos`.
+static uint8_t get_hand(keypos_t pos) {
+  if (!hand_bits_ready) { init_hand_bits(); }
+  if (pos.row >= MATRIX_ROWS || pos.col >= MATRIX_COLS) {
+    return HAND_EXEMPT;  // Invalid position, such as a combo.
+  }
+  const uint16_t i = pos.row * MATRIX_COLS + pos.col;
+  return (hand_bits[i / 4] >> (2 * (i % 4))) & 3;
+}
+
+char achordion_hand(keypos_t pos) {
+  switch (get_hand(pos)) {
+    case HAND_LEFT: return 'L';
+    case HAND_RIGHT: return 'R';
+    default: return '*';
+  }
+}
+
+bool achordion_opposite_hands(const keyrecord_t* tap_hold_record,
+                              const keyrecord_t* other_record) {
+  // The keys are on opposite hands if together they cover both hands, which
+  // is also the case when either is exempt.
+  return (get_hand(tap_hold_record->event.key) |
+          get_hand(other_record->event.key)) == HAND_EXEMPT;
+}
+#else
+char achordion_hand(keypos_t pos) { return on_left_hand(pos) ? 'L' : 'R'; }
+
 bool achordion_opposite_hands(const keyrecord_t* tap_hold_record,
                               const keyrecord_t* other_record) {
   return on_left_hand(tap_hold_record->event.key) !=
          on_left_hand(other_record->event.key);
 }
+#endif  // ACHORDION_HAND_LAYOUT
 
 // By default, use the BILATERAL_COMBINATIONS rule to consider the tap-hold key
 // "held" only when it and the other key are on opposite hands.
@@ -338,9 +629,14 @@ __attribute__((weak)) bool achordion_chord(uint16_t tap_hold_keycode,
   return achordion_opposite_hands(tap_hold_record, other_record);
 }
 
-// By default, the timeout is 1000 ms for all keys.
+// By default, the timeout is 1000 ms for all keys, or with
+// ACHORDION_STREAK_ADAPTIVE, derived from the typing speed.
 __attribute__((weak)) uint16_t achordion_timeout(uint16_t tap_hold_keycode) {
+#ifdef ACHORDION_STREAK_ADAPTIVE
+  return achordion_adaptive_timeout();
+#else
   return 1000;
+#endif  // ACHORDION_STREAK_ADAPTIVE
 }
 
 // By default, Shift and Ctrl mods are eager, and Alt and GUI are not.
@@ -376,7 +672,11 @@ __attribute__((weak)) uint16_t achordion_streak_chord_timeout(
 
 __attribute__((weak)) uint16_t
 achordion_streak_timeout(uint16_t tap_hold_keycode) {
+#ifdef ACHORDION_STREAK_ADAPTIVE
+  return achordion_adaptive_streak_timeout();
+#else
   return 200;
+#endif  // ACHORDION_STREAK_ADAPTIVE
 }
 #endif
 
@@ -80,6 +80,13 @@ bool process_achordion(uint16_t keycode, keyrecord_t* record);
  *     void housekeeping_task_user(void) {
  *       achordion_task();
  *     }
+ *
+ * Alternatively, define ACHORDION_DEFER_EXEC in config.h to have Achordion
+ * schedule its timeouts with QMK's deferred execution API, so that nothing is
+ * polled when no timeout is pending. This requires `DEFERRED_EXEC_ENABLE = yes`
+ * in rules.mk. In this mode, `achordion_task()` should still be called. It only
+ * polls a timeout that failed to be scheduled because the deferred execution
+ * pool was full, so that the key is still settled.
  */
 void achordion_task(void);
 
@@ -152,6 +159,8 @@ bool achordion_eager_mod(uint8_t mod);
 /**
  * Returns true if the args come from keys on opposite hands.
  *
+ * With ACHORDION_HAND_LAYOUT, this is also true if either key is exempt.
+ *
  * @param tap_hold_record keyrecord_t from the tap-hold key's event.
  * @param other_record keyrecord_t from the other key's event.
  * @return True if the keys are on opposite hands.
@@ -159,6 +168,60 @@ bool achordion_eager_mod(uint8_t mod);
 bool achordion_opposite_hands(const keyrecord_t* tap_hold_record,
                               const keyrecord_t* other_record);
 
+/**
+ * Returns the hand of the key at `pos`: 'L' for left, 'R' for right, or with
+ * ACHORDION_HAND_LAYOUT, '*' if the key is exempt.
+ */
+char achordion_hand(keypos_t pos);
+
+/**
+ * Define per-key handedness in a table by defining ACHORDION_HAND_LAYOUT.
+ *
+ * By default, the hand of a key is determined from its matrix position,
+ * assuming the left hand is the first half of the rows on split keyboards or
+ * of the columns otherwise. Alternatively, define ACHORDION_HAND_LAYOUT in
+ * config.h and a table `achordion_hand_layout` in keymap.c, with 'L' for keys
+ * on the left hand, 'R' for the right hand, and '*' for keys exempt from the
+ * opposite hands rule, which are considered opposite to either hand:
+ *
+ *     const char achordion_hand_layout[MATRIX_ROWS][MATRIX_COLS] PROGMEM =
+ *         LAYOUT(
+ *             'L', 'L', 'L', 'L', 'L',  'R', 'R', 'R', 'R', 'R',
+ *             'L', 'L', 'L', 'L', 'L',  'R', 'R', 'R', 'R', 'R',
+ *             'L', 'L', 'L', 'L', 'L',  'R', 'R', 'R', 'R', 'R',
+ *                            '*', '*',  '*', '*'
+ *         );
+ *
+ * The table is packed on first use into a bitmap of 2 bits per key, so that
+ * `achordion_opposite_hands()` is a lookup. Unused matrix positions may be
+ * left as 0 (e.g. KC_NO), in which case the default rule is used.
+ */
+#ifdef ACHORDION_HAND_LAYOUT
+extern const char achordion_hand_layout[MATRIX_ROWS][MATRIX_COLS];
+#endif  // ACHORDION_HAND_LAYOUT
+
+/**
+ * Settle multiple tap-hold keys together by defining ACHORDION_MAX_PENDING.
+ *
+ * By default, when another tap-hold key is pressed and considered by QMK as
+ * held while the active tap-hold key is unsettled, the active key is settled
+ * right away as held. Fast rolls over several home row mods then produce
+ * mods, even when the key pressed after the roll is on the same hand.
+ *
+ * Defining ACHORDION_MAX_PENDING as 2 or more allows up to that many tap-hold
+ * keys to be unsettled at a time. Once a different key is pressed, each of the
+ * unsettled keys is settled according to `achordion_chord()` with that key. If
+ * instead one of the unsettled keys is released, the timeout expires, or more
+ * keys are pressed than fit, all of them are settled as held.
+ *
+ *     #define ACHORDION_MAX_PENDING 4
+ *
+ * No memory is allocated dynamically; the storage is fixed at compile time.
+ */
+#ifndef ACHORDION_MAX_PENDING
+#define ACHORDION_MAX_PENDING 1
+#endif  // ACHORDION_MAX_PENDING
+
 /**
  * Suppress tap-hold mods within a *typing streak* by defining
  * ACHORDION_STREAK. This can help preventing accidental mod
@@ -188,6 +251,70 @@ bool achordion_streak_continue(uint16_t keycode);
 uint16_t achordion_streak_timeout(uint16_t tap_hold_keycode);
 #endif
 
+/**
+ * Time after the last key in a streak at which the streak ends, regardless of
+ * `achordion_streak_chord_timeout()`. Default 800 ms.
+ */
+#ifndef ACHORDION_STREAK_MAX_TIMEOUT
+#define ACHORDION_STREAK_MAX_TIMEOUT 800
+#endif  // ACHORDION_STREAK_MAX_TIMEOUT
+
+/**
+ * Adapt timeouts to the typing speed by defining ACHORDION_STREAK_ADAPTIVE
+ * along with ACHORDION_STREAK.
+ *
+ * Achordion then keeps an exponentially weighted moving average of the
+ * interval between presses of keys that continue a streak (see
+ * `achordion_streak_continue()`), ignoring pauses longer than
+ * ACHORDION_STREAK_ADAPTIVE_MAX_INTERVAL. The default callbacks derive
+ * timeouts from it:
+ *
+ *  * streak timeout: 1.5 times the average interval, clamped to
+ *    [ACHORDION_STREAK_ADAPTIVE_MIN_TIMEOUT,
+ *     ACHORDION_STREAK_ADAPTIVE_MAX_TIMEOUT].
+ *
+ *  * tap-hold timeout: 5 times the average interval, clamped to
+ *    [ACHORDION_ADAPTIVE_MIN_TIMEOUT, ACHORDION_ADAPTIVE_MAX_TIMEOUT].
+ *
+ * Keymaps that define `achordion_timeout()` or
+ * `achordion_streak_chord_timeout()` may call `achordion_adaptive_timeout()`
+ * and `achordion_adaptive_streak_timeout()` to use these values as a base.
+ * The state is 4 bytes.
+ */
+#ifdef ACHORDION_STREAK_ADAPTIVE
+#ifndef ACHORDION_STREAK
+#error "achordion: ACHORDION_STREAK_ADAPTIVE requires ACHORDION_STREAK."
+#endif  // ACHORDION_STREAK
+
+#ifndef ACHORDION_STREAK_ADAPTIVE_INITIAL_INTERVAL
+#define ACHORDION_STREAK_ADAPTIVE_INITIAL_INTERVAL 133
+#endif  // ACHORDION_STREAK_ADAPTIVE_INITIAL_INTERVAL
+#ifndef ACHORDION_STREAK_ADAPTIVE_MAX_INTERVAL
+#define ACHORDION_STREAK_ADAPTIVE_MAX_INTERVAL 500
+#endif  // ACHORDION_STREAK_ADAPTIVE_MAX_INTERVAL
+#ifndef ACHORDION_STREAK_ADAPTIVE_MIN_TIMEOUT
+#define ACHORDION_STREAK_ADAPTIVE_MIN_TIMEOUT 80
+#endif  // ACHORDION_STREAK_ADAPTIVE_MIN_TIMEOUT
+#ifndef ACHORDION_STREAK_ADAPTIVE_MAX_TIMEOUT
+#define ACHORDION_STREAK_ADAPTIVE_MAX_TIMEOUT 300
+#endif  // ACHORDION_STREAK_ADAPTIVE_MAX_TIMEOUT
+#ifndef ACHORDION_ADAPTIVE_MIN_TIMEOUT
+#define ACHORDION_ADAPTIVE_MIN_TIMEOUT 300
+#endif  // ACHORDION_ADAPTIVE_MIN_TIMEOUT
+#ifndef ACHORDION_ADAPTIVE_MAX_TIMEOUT
+#define ACHORDION_ADAPTIVE_MAX_TIMEOUT 1000
+#endif  // ACHORDION_ADAPTIVE_MAX_TIMEOUT
+
+/** Returns the average interval between presses in a streak in ms. */
+uint16_t achordion_streak_interval(void);
+
+/** Returns the streak timeout derived from the typing speed in ms. */
+uint16_t achordion_adaptive_streak_timeout(void);
+
+/** Returns the tap-hold timeout derived from the typing speed in ms. */
+uint16_t achordion_adaptive_timeout(void);
+#endif  // ACHORDION_STREAK_ADAPTIVE
+
 #ifdef __cplusplus
 }
 #endif
@@ -22,10 +22,25 @@
 
 #include "autocorrection.h"
 
-#include <string.h>
-
 #include "autocorrection_data.h"
 
+#ifdef KEY_EVENT_ENABLE
+#include "key_event.h"
+#endif  // KEY_EVENT_ENABLE
+
+#ifdef TAP_QUEUE_ENABLE
+#include "tap_queue.h"
+
+// With the tap queue, corrections are queued and sent without blocking.
+#define correction_tap_code(kc) tap_queue_tap(kc)
+#define correction_send_char(c) tap_queue_send_char(c)
+#define correction_send_string_P(str) tap_queue_send_string_P(str)
+#else
+#define correction_tap_code(kc) tap_code(kc)
+#define correction_send_char(c) send_char(c)
+#define correction_send_string_P(str) send_string_P(str)
+#endif  // TAP_QUEUE_ENABLE
+
 #pragma message \
     "Autocorrect is now a core QMK feature! To use it, update your QMK set up and see https://docs.qmk.fm/features/autocorrect"
 
@@ -37,8 +52,65 @@
 #error "Min typo length is less than 4. Autocorrection may behave poorly."
 #endif
 
+#if AUTOCORRECTION_MAX_LENGTH > 255
+#error "Max typo length must be at most 255."
+#endif
+
+#if defined(AUTOCORRECTION_BITMAP_TRIE) != defined(AUTOCORRECTION_DATA_BITMAP)
+// The lookup must match how autocorrection_data.h was serialized. Regenerate it
+// with make_autocorrection_data.py, passing --format=bitmap if and only if
+// AUTOCORRECTION_BITMAP_TRIE is defined.
+#error "autocorrection_data.h format does not match AUTOCORRECTION_BITMAP_TRIE."
+#endif
+
+#ifdef AUTOCORRECTION_BITMAP_TRIE
+// Returns the bit of typo buffer keycode `key` in branch node bitmaps: a-z map
+// to bits 0-25, ' to bit 26, and the word break to bit 27.
+static uint32_t bitmap_bit(uint8_t key) {
+  switch (key) {
+    case KC_QUOT:
+      return UINT32_C(1) << 26;
+    case KC_SPC:
+      return UINT32_C(1) << 27;
+  }
+  return UINT32_C(1) << (key - KC_A);
+}
+
+// Reads the little endian 32-bit bitmap at `state` in `autocorrection_data`.
+static uint32_t read_bitmap(uint16_t state) {
+  uint32_t bitmap = 0;
+  for (int8_t i = 3; i >= 0; --i) {
+    bitmap = (bitmap << 8) | pgm_read_byte(autocorrection_data + state + i);
+  }
+  return bitmap;
+}
+#endif  // AUTOCORRECTION_BITMAP_TRIE
+
+#ifdef AUTOCORRECTION_DATA_TOKENS
+// Sends the correction string at `state` in `autocorrection_data`. Bytes
+// 128-255 are tokens, expanded to the corresponding null-terminated strings in
+// `autocorrection_tokens`.
+static void send_correction(uint16_t state) {
+  uint8_t c;
+  while ((c = pgm_read_byte(autocorrection_data + state++))) {
+    if (c & 128) {
+      const uint8_t* token = autocorrection_tokens;
+      for (c &= 127; c; --c) {  // Skip to the token's string.
+        while (pgm_read_byte(token++)) {}
+      }
+      correction_send_string_P((const char*)token);
+    } else {
+      correction_send_char((char)c);
+    }
+  }
+}
+#endif  // AUTOCORRECTION_DATA_TOKENS
+
 bool process_autocorrection(uint16_t keycode, keyrecord_t* record) {
+  // The typo buffer is a circular buffer of the last typed characters, with
+  // the newest character at index `typo_buffer_end - 1`, modulo the capacity.
   static uint8_t typo_buffer[AUTOCORRECTION_MAX_LENGTH] = {0};
+  static uint8_t typo_buffer_end = 0;
   static uint8_t typo_buffer_size = 0;
 
   // Ignore key release; we only process key presses.
@@ -61,8 +133,17 @@ bool process_autocorrection(uint16_t keycode, keyrecord_t* record) {
   // split over two switches rather than merged into one. The first switch may
   // extract a basic keycode which is then further handled by the second switch,
   // e.g. a layer-tap key with Caps Lock `LT(layer, KC_CAPS)`.
+#ifdef KEY_EVENT_ENABLE
+  // Get the tap keycode of tap-hold keys, ignoring mods, layer switch keys,
+  // and tap-hold keys when held.
+  const key_event_t* event = key_event_decode(keycode, record);
+  if (event->key_class == KEY_CLASS_NONE) {
+    return true;
+  }
+  keycode = event->keycode;
+#endif  // KEY_EVENT_ENABLE
   switch (keycode) {
-#ifndef NO_ACTION_TAPPING
+#if !defined(NO_ACTION_TAPPING) && !defined(KEY_EVENT_ENABLE)
     case QK_MOD_TAP ... QK_MOD_TAP_MAX:  // Tap-hold keys.
 #ifndef NO_ACTION_LAYER
     case QK_LAYER_TAP ... QK_LAYER_TAP_MAX:
@@ -73,7 +154,7 @@ bool process_autocorrection(uint16_t keycode, keyrecord_t* record) {
       }
       // Otherwise when tapped, get the basic keycode.
       // Fallthrough intended.
-#endif  // NO_ACTION_TAPPING
+#endif  // !NO_ACTION_TAPPING && !KEY_EVENT_ENABLE
 
     // Handle shifted keys, e.g. symbols like KC_EXLM = S(KC_1).
     case QK_LSFT ... QK_LSFT + 255:
@@ -116,6 +197,8 @@ bool process_autocorrection(uint16_t keycode, keyrecord_t* record) {
       // Remove last character from the buffer.
       if (typo_buffer_size > 0) {
         --typo_buffer_size;
+        typo_buffer_end = (typo_buffer_end ? typo_buffer_end
+                                           : AUTOCORRECTION_MAX_LENGTH) - 1;
       }
       return true;
     } else if (KC_1 <= keycode && keycode <= KC_SLSH && keycode != KC_ESC) {
@@ -133,15 +216,16 @@ bool process_autocorrection(uint16_t keycode, keyrecord_t* record) {
     }
   }
 
-  // If the buffer is full, rotate it to discard the oldest character.
-  if (typo_buffer_size >= AUTOCORRECTION_MAX_LENGTH) {
-    memmove(typo_buffer, typo_buffer + 1, AUTOCORRECTION_MAX_LENGTH - 1);
-    typo_buffer_size = AUTOCORRECTION_MAX_LENGTH - 1;
-  }
-
-  // Append `keycode` to the buffer.
+  // Append `keycode` to the buffer. If the buffer is full, this overwrites the
+  // oldest character.
   // NOTE: `keycode` must be a basic keycode (0-255) by this point.
-  typo_buffer[typo_buffer_size++] = (uint8_t)keycode;
+  typo_buffer[typo_buffer_end] = (uint8_t)keycode;
+  if (++typo_buffer_end >= AUTOCORRECTION_MAX_LENGTH) {
+    typo_buffer_end = 0;
+  }
+  if (typo_buffer_size < AUTOCORRECTION_MAX_LENGTH) {
+    ++typo_buffer_size;
+  }
   // Early return if not many characters have been buffered so far.
   if (typo_buffer_size < AUTOCORRECTION_MIN_LENGTH) {
     return true;
@@ -151,10 +235,24 @@ bool process_autocorrection(uint16_t keycode, keyrecord_t* record) {
   // stored in `autocorrection_data`.
   uint16_t state = 0;
   uint8_t code = pgm_read_byte(autocorrection_data + state);
-  for (int i = typo_buffer_size - 1; i >= 0; --i) {
-    const uint8_t key_i = typo_buffer[i];
+  uint8_t j = typo_buffer_end;
+  for (uint8_t i = typo_buffer_size; i > 0; --i) {
+    // Step backward through the circular buffer, from newest to oldest.
+    j = (j ? j : AUTOCORRECTION_MAX_LENGTH) - 1;
+    const uint8_t key_i = typo_buffer[j];
 
     if (code & 64) {  // Check for match in node with multiple children.
+#ifdef AUTOCORRECTION_BITMAP_TRIE
+      // The node is a bitmap of which children are present, followed by their
+      // links in bit order. The link to follow is counted by the set bits
+      // below `key_i`'s bit, so that this takes constant time.
+      const uint32_t bitmap = read_bitmap(state + 1);
+      const uint32_t bit = bitmap_bit(key_i);
+      if (!(bitmap & bit)) {
+        return true;
+      }
+      state += 5 + 2 * __builtin_popcountl(bitmap & (bit - 1));
+#else
       code &= 63;
       for (; code != key_i;
            code = pgm_read_byte(autocorrection_data + (state += 3))) {
@@ -162,12 +260,14 @@ bool process_autocorrection(uint16_t keycode, keyrecord_t* record) {
           return true;
         }
       }
+      ++state;
+#endif  // AUTOCORRECTION_BITMAP_TRIE
 
       // Follow link to child node.
       state = (uint16_t)((uint_fast16_t)pgm_read_byte(autocorrection_data +
-                                                      state + 1) |
+                                                      state) |
                          (uint_fast16_t)pgm_read_byte(autocorrection_data +
-                                                      state + 2)
+                                                      state + 1)
                              << 8);
       // Otherwise check for match in node with a single child.
     } else if (code != key_i) {
@@ -188,12 +288,22 @@ bool process_autocorrection(uint16_t keycode, keyrecord_t* record) {
     if (code & 128) {  // A typo was found! Apply autocorrection.
       const int backspaces = code & 63;
       for (int i = 0; i < backspaces; ++i) {
-        tap_code(KC_BSPC);
+        correction_tap_code(KC_BSPC);
       }
-      send_string_P((char const*)(autocorrection_data + state + 1));
+#ifdef AUTOCORRECTION_DATA_TOKENS
+      send_correction(state + 1);
+#else
+      correction_send_string_P((char const*)(autocorrection_data + state + 1));
+#endif  // AUTOCORRECTION_DATA_TOKENS
 
       if (keycode == KC_SPC) {
+#ifdef TAP_QUEUE_ENABLE
+        // The word break key is sent after this returns, so the correction
+        // must be sent first.
+        tap_queue_flush();
+#endif  // TAP_QUEUE_ENABLE
         typo_buffer[0] = KC_SPC;
+        typo_buffer_end = 1;
         typo_buffer_size = 1;
         return true;
       } else {
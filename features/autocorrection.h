@@ -79,6 +79,33 @@
  *
  * Step 3: Finally, recompile and flash your keymap.
  *
+ * Large dictionaries
+ * ------------------
+ *
+ * By default, a trie node with multiple children lists them to be checked one
+ * by one, so a lookup gets slower the more children a node has. For large
+ * dictionaries, branching nodes can instead be serialized with a bitmap of
+ * which children are present, so that each lookup step takes constant time at
+ * the cost of a few more bytes per branching node. To use it, generate the data
+ * with
+ *
+ *     $ python3 make_autocorrection_data.py --format=bitmap
+ *
+ * and define in your config.h
+ *
+ *     #define AUTOCORRECTION_BITMAP_TRIE
+ *
+ * Compilation fails with an error if the two do not match.
+ *
+ * To save flash, the correction strings can be compressed by passing the
+ * option --compress. Substrings common among the corrections are then stored
+ * once in a token table and expanded when a correction is sent, so this costs
+ * nothing while no typo is found. No config.h change is needed. With the
+ * 400-entry autocorrection_dict_extra.txt, this saves about 380 bytes, 6% of
+ * the table. The savings are modest because corrections are already stored as
+ * short suffixes, and most of the table is trie nodes, which the walk on each
+ * key press reads uncompressed.
+ *
  * For full documentation, see
  * <https://getreuer.info/posts/keyboards/autocorrection>
  *
@@ -0,0 +1,189 @@
+// Copyright 2025 Google LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     https://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+/**
+ * @file autofire.c
+ * @brief Autofire implementation
+ */
+
+#include "autofire.h"
+
+#if !defined(DEFERRED_EXEC_ENABLE)
+#error "autofire: Please set `DEFERRED_EXEC_ENABLE = yes` in rules.mk."
+#else
+
+typedef struct {
+  /** Keycode being pulsed, or KC_NO if the slot is free. */
+  uint16_t keycode;
+  /** Milliseconds that the key is held and released in each period. */
+  uint16_t press_ms;
+  uint16_t release_ms;
+  /** Time of the slot's next press or release. */
+  uint16_t next_time;
+  bool pressed;
+} autofire_slot_t;
+
+static autofire_slot_t slots[AUTOFIRE_NUM_SLOTS] = {0};
+static deferred_token token = INVALID_DEFERRED_TOKEN;
+
+static autofire_slot_t* find_slot(uint16_t keycode) {
+  for (uint8_t i = 0; i < AUTOFIRE_NUM_SLOTS; ++i) {
+    if (slots[i].keycode == keycode) {
+      return &slots[i];
+    }
+  }
+  return NULL;
+}
+
+// Presses or releases the slot's key, and schedules its next toggle.
+static void toggle(autofire_slot_t* slot, uint16_t now) {
+  slot->pressed = !slot->pressed;
+  if (slot->pressed) {
+    register_code16(slot->keycode);
+  } else {
+    unregister_code16(slot->keycode);
+  }
+  const uint16_t duration = slot->pressed ? slot->press_ms : slot->release_ms;
+  slot->next_time += duration;
+  if (timer_expired(now, slot->next_time)) {
+    slot->next_time = now + duration;  // Fell behind; skip ahead.
+  }
+}
+
+// Returns the milliseconds until the next slot is due, or 0 if none are active.
+static uint16_t next_delay(uint16_t now) {
+  uint16_t delay = 0;
+  for (uint8_t i = 0; i < AUTOFIRE_NUM_SLOTS; ++i) {
+    if (slots[i].keycode != KC_NO) {
+      uint16_t remaining = slots[i].next_time - now;
+      if (remaining == 0 || remaining > UINT16_MAX / 2) {
+        remaining = 1;
+      }
+      if (delay == 0 || remaining < delay) {
+        delay = remaining;
+      }
+    }
+  }
+  return delay;
+}
+
+// Callback shared by all slots. It toggles the slots that are due, then runs
+// again when the next slot is due.
+static uint32_t autofire_callback(uint32_t trigger_time, void* cb_arg) {
+  const uint16_t now = timer_read();
+  for (uint8_t i = 0; i < AUTOFIRE_NUM_SLOTS; ++i) {
+    if (slots[i].keycode != KC_NO && timer_expired(now, slots[i].next_time)) {
+      toggle(&slots[i], now);
+    }
+  }
+  const uint16_t delay = next_delay(now);
+  if (delay == 0) {
+    token = INVALID_DEFERRED_TOKEN;  // Returning 0 cancels the callback.
+  }
+  return delay;
+}
+
+static void stop_slot(autofire_slot_t* slot) {
+  if (slot->pressed) {
+    unregister_code16(slot->keycode);
+  }
+  slot->keycode = KC_NO;
+  slot->pressed = false;
+}
+
+// Schedules the callback for when the next slot is due. If no deferred
+// execution slot is free, nothing would release the keys, so all slots are
+// stopped and false is returned.
+static bool reschedule(uint16_t now) {
+  const uint16_t delay = next_delay(now);
+  if (delay == 0) {
+    if (token != INVALID_DEFERRED_TOKEN) {
+      cancel_deferred_exec(token);
+      token = INVALID_DEFERRED_TOKEN;
+    }
+  } else if (token == INVALID_DEFERRED_TOKEN ||
+             !extend_deferred_exec(token, delay)) {
+    token = defer_exec(delay, autofire_callback, NULL);
+    if (token == INVALID_DEFERRED_TOKEN) {
+      for (uint8_t i = 0; i < AUTOFIRE_NUM_SLOTS; ++i) {
+        if (slots[i].keycode != KC_NO) {
+          stop_slot(&slots[i]);
+        }
+      }
+      return false;
+    }
+  }
+  return true;
+}
+
+bool autofire_start(uint16_t keycode, uint16_t period_ms, uint8_t duty) {
+  if (keycode == KC_NO) {
+    return false;
+  }
+  if (period_ms < 2) {
+    period_ms = 2;
+  }
+  if (duty < 1) {
+    duty = 1;
+  } else if (duty > 99) {
+    duty = 99;
+  }
+  uint16_t press_ms = (uint32_t)period_ms * duty / 100;
+  if (press_ms < 1) {
+    press_ms = 1;
+  } else if (press_ms >= period_ms) {
+    press_ms = period_ms - 1;
+  }
+
+  autofire_slot_t* slot = find_slot(keycode);
+  const bool is_new = (slot == NULL);
+  if (is_new && (slot = find_slot(KC_NO)) == NULL) {
+    return false;  // All slots are in use.
+  }
+
+  slot->press_ms = press_ms;
+  slot->release_ms = period_ms - press_ms;
+  if (is_new) {  // Press the key now.
+    const uint16_t now = timer_read();
+    slot->keycode = keycode;
+    slot->pressed = false;
+    slot->next_time = now;
+    toggle(slot, now);
+    return reschedule(now);
+  }
+  return true;
+}
+
+void autofire_stop(uint16_t keycode) {
+  autofire_slot_t* slot;
+  if (keycode != KC_NO && (slot = find_slot(keycode)) != NULL) {
+    stop_slot(slot);
+    reschedule(timer_read());
+  }
+}
+
+void autofire_stop_all(void) {
+  for (uint8_t i = 0; i < AUTOFIRE_NUM_SLOTS; ++i) {
+    if (slots[i].keycode != KC_NO) {
+      stop_slot(&slots[i]);
+    }
+  }
+  reschedule(timer_read());
+}
+
+bool autofire_is_active(uint16_t keycode) {
+  return keycode != KC_NO && find_slot(keycode) != NULL;
+}
+
+#endif
@@ -0,0 +1,107 @@
+// Copyright 2025 Google LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     https://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+/**
+ * @file autofire.h
+ * @brief Autofire: repeatedly press and release keys on a shared timer.
+ *
+ * Overview
+ * --------
+ *
+ * This library pulses keys, pressing and releasing each one periodically, as
+ * used for "turbo" buttons. Each pulsing key occupies a slot in a small fixed
+ * pool with its own keycode, period, and duty cycle, the percentage of each
+ * period that the key is held. All slots are driven by one shared deferred
+ * execution callback, which wakes only when the next slot is due. So several
+ * turbo keys, mouse buttons or keyboard keys, can run at once while using a
+ * single deferred execution slot and a single timer.
+ *
+ * Mouse Turbo Click (features/mouse_turbo_click.h) uses this library when
+ * `AUTOFIRE_ENABLE` is defined.
+ *
+ *
+ * Usage
+ * -----
+ *
+ * Start and stop pulsing a key by calling `autofire_start()` and
+ * `autofire_stop()`, e.g. to click mouse button 1 while a key is held:
+ *
+ *     #include "features/autofire.h"
+ *
+ *     bool process_record_user(uint16_t keycode, keyrecord_t* record) {
+ *       switch (keycode) {
+ *         case TURBO:
+ *           if (record->event.pressed) {
+ *             autofire_start(KC_MS_BTN1, 80, 50);  // 80 ms period, 50% duty.
+ *           } else {
+ *             autofire_stop(KC_MS_BTN1);
+ *           }
+ *           return false;
+ *
+ *         // Your macros ...
+ *       }
+ *       return true;
+ *     }
+ *
+ * In your rules.mk, add
+ *
+ *     DEFERRED_EXEC_ENABLE = yes
+ *     OPT_DEFS += -DAUTOFIRE_ENABLE
+ *     SRC += features/autofire.c
+ *
+ * @warning The keyboard might become unresponsive if periods are too small. I
+ * suggest periods no smaller than 10 ms.
+ */
+
+#pragma once
+
+#include "quantum.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/** Number of keys that may pulse at once. */
+#ifndef AUTOFIRE_NUM_SLOTS
+#define AUTOFIRE_NUM_SLOTS 4
+#endif  // AUTOFIRE_NUM_SLOTS
+
+/**
+ * @brief Starts pulsing `keycode`.
+ *
+ * The key is pressed immediately, held for `duty` percent of `period_ms`, then
+ * released for the rest of the period, and so on until stopped. If `keycode`
+ * is already pulsing, its period and duty cycle are updated.
+ *
+ * @param keycode    Keycode to pulse, as would be passed to `tap_code16()`.
+ * @param period_ms  Period in milliseconds, at least 2.
+ * @param duty       Percentage of the period that the key is held, 1 to 99.
+ * @return False if all slots are in use or the callback could not be scheduled,
+ *         true otherwise. If the callback could not be scheduled, all keys are
+ *         stopped and false is returned.
+ */
+bool autofire_start(uint16_t keycode, uint16_t period_ms, uint8_t duty);
+
+/** Stops pulsing `keycode`, and releases it if it is held. */
+void autofire_stop(uint16_t keycode);
+
+/** Stops pulsing all keys. */
+void autofire_stop_all(void);
+
+/** Returns whether `keycode` is pulsing. */
+bool autofire_is_active(uint16_t keycode);
+
+#ifdef __cplusplus
+}
+#endif
@@ -22,12 +22,80 @@
 
 #include "custom_shift_keys.h"
 
+#ifdef REPORT_COALESCE_ENABLE
+#include "report_coalesce.h"
+#endif  // REPORT_COALESCE_ENABLE
+
 #if !defined(IS_QK_MOD_TAP)
 // Attempt to detect out-of-date QMK installation, which would fail with
 // implicit-function-declaration errors in the code below.
 #error "custom_shift_keys: QMK version is too old to build. Please update QMK."
 #else
 
+#ifdef CUSTOM_SHIFT_KEYS_PER_LAYER
+// Per-layer tables are stored in PROGMEM.
+#define READ_KEYCODE(entry) pgm_read_word(&(entry)->keycode)
+#define READ_SHIFTED_KEYCODE(entry) pgm_read_word(&(entry)->shifted_keycode)
+#else
+#define READ_KEYCODE(entry) ((entry)->keycode)
+#define READ_SHIFTED_KEYCODE(entry) ((entry)->shifted_keycode)
+#endif  // CUSTOM_SHIFT_KEYS_PER_LAYER
+
+#ifdef CUSTOM_SHIFT_KEYS_SORTED
+// Returns whether `table` is sorted by keycode. The result is checked once and
+// cached, where `index` identifies the table (the layer for per-layer tables).
+static bool is_sorted(const custom_shift_key_t *table, uint8_t size,
+                      uint8_t index) {
+  static uint32_t checked = 0;
+  static uint32_t sorted = 0;
+  const uint32_t bit = UINT32_C(1) << (index & 31);
+  if ((checked & bit) == 0) {  // Check that the table is sorted, once.
+    checked |= bit;
+    sorted |= bit;
+    for (uint8_t i = 1; i < size; ++i) {
+      if (READ_KEYCODE(&table[i - 1]) >= READ_KEYCODE(&table[i])) {
+        dprintf("custom_shift_keys: Table %u is not sorted at entry %u.\n",
+                index, i);
+        sorted &= ~bit;
+        break;
+      }
+    }
+  }
+  return (sorted & bit) != 0;
+}
+#endif  // CUSTOM_SHIFT_KEYS_SORTED
+
+// Returns the entry for `keycode` in `table`, or NULL if there is none.
+static const custom_shift_key_t *find_custom_shift_key(
+    const custom_shift_key_t *table, uint8_t size, uint8_t index,
+    uint16_t keycode) {
+#ifdef CUSTOM_SHIFT_KEYS_SORTED
+  if (is_sorted(table, size, index)) {  // Binary search.
+    uint8_t lo = 0;
+    uint8_t hi = size;
+    while (lo < hi) {
+      const uint8_t mid = lo + (hi - lo) / 2;
+      const uint16_t mid_keycode = READ_KEYCODE(&table[mid]);
+      if (mid_keycode < keycode) {
+        lo = mid + 1;
+      } else if (mid_keycode > keycode) {
+        hi = mid;
+      } else {
+        return &table[mid];
+      }
+    }
+    return NULL;
+  }
+#endif  // CUSTOM_SHIFT_KEYS_SORTED
+
+  for (uint8_t i = 0; i < size; ++i) {
+    if (keycode == READ_KEYCODE(&table[i])) {
+      return &table[i];
+    }
+  }
+  return NULL;
+}
+
 bool process_custom_shift_keys(uint16_t keycode, keyrecord_t *record) {
   static uint16_t registered_keycode = KC_NO;
 
@@ -35,7 +103,12 @@ bool process_custom_shift_keys(uint16_t keycode, keyrecord_t *record) {
   // it or manipulating another key at the same time. Either way, we release
   // the currently registered key.
   if (registered_keycode != KC_NO) {
+#ifdef REPORT_COALESCE_ENABLE
+    // The release is sent with the report for the current event.
+    report_coalesce_unregister_code16(registered_keycode);
+#else
     unregister_code16(registered_keycode);
+#endif  // REPORT_COALESCE_ENABLE
     registered_keycode = KC_NO;
   }
 
@@ -46,9 +119,9 @@ bool process_custom_shift_keys(uint16_t keycode, keyrecord_t *record) {
 #else
     const uint8_t mods = saved_mods | get_weak_mods();
 #endif  // NO_ACTION_ONESHOT
-#if CUSTOM_SHIFT_KEYS_LAYER_MASK != 0
+#if defined(CUSTOM_SHIFT_KEYS_PER_LAYER) || CUSTOM_SHIFT_KEYS_LAYER_MASK != 0
     const uint8_t layer = read_source_layers_cache(record->event.key);
-#endif  // CUSTOM_SHIFT_KEYS_LAYER_MASK
+#endif
     if ((mods & MOD_MASK_SHIFT) != 0  // Shift is held.
 #if CUSTOM_SHIFT_KEYS_NEGMODS != 0
         // Nothing in CUSTOM_SHIFT_KEYS_NEGMODS is held.
@@ -65,25 +138,52 @@ bool process_custom_shift_keys(uint16_t keycode, keyrecord_t *record) {
         return true;
       }
 
+#ifdef CUSTOM_SHIFT_KEYS_PER_LAYER
+      // Select the table for the layer, if it has one.
+      const custom_shift_key_t *table = NULL;
+      uint8_t size = 0;
+      if (layer < NUM_CUSTOM_SHIFT_KEYS_LAYERS) {
+        const custom_shift_keys_layer_t *layer_table =
+            &custom_shift_keys_layers[layer];
+        table = (const custom_shift_key_t *)pgm_read_ptr(&layer_table->keys);
+        size = pgm_read_byte(&layer_table->size);
+      }
+      const uint8_t table_index = layer;
+#else
+      const custom_shift_key_t *table = custom_shift_keys;
+      const uint8_t size = NUM_CUSTOM_SHIFT_KEYS;
+      const uint8_t table_index = 0;
+#endif  // CUSTOM_SHIFT_KEYS_PER_LAYER
+
       // Search for a custom shift key whose keycode is `keycode`.
-      for (int i = 0; i < NUM_CUSTOM_SHIFT_KEYS; ++i) {
-        if (keycode == custom_shift_keys[i].keycode) {
-          registered_keycode = custom_shift_keys[i].shifted_keycode;
-          if (IS_QK_MODS(registered_keycode) &&  // Should keycode be shifted?
-              (QK_MODS_GET_MODS(registered_keycode) & MOD_LSFT) != 0) {
-            register_code16(registered_keycode);  // If so, press it directly.
-          } else {
-            // Otherwise cancel shift mods, press the key, and restore mods.
-            del_weak_mods(MOD_MASK_SHIFT);
+      const custom_shift_key_t *entry =
+          find_custom_shift_key(table, size, table_index, keycode);
+      if (entry != NULL) {
+        registered_keycode = READ_SHIFTED_KEYCODE(entry);
+        if (IS_QK_MODS(registered_keycode) &&  // Should keycode be shifted?
+            (QK_MODS_GET_MODS(registered_keycode) & MOD_LSFT) != 0) {
+          register_code16(registered_keycode);  // If so, press it directly.
+        } else {
+          // Otherwise cancel shift mods, press the key, and restore mods.
+          del_weak_mods(MOD_MASK_SHIFT);
 #ifndef NO_ACTION_ONESHOT
-            del_oneshot_mods(MOD_MASK_SHIFT);
+          del_oneshot_mods(MOD_MASK_SHIFT);
 #endif  // NO_ACTION_ONESHOT
-            unregister_mods(MOD_MASK_SHIFT);
-            register_code16(registered_keycode);
-            set_mods(saved_mods);
-          }
-          return false;
+#ifdef REPORT_COALESCE_ENABLE
+          // Send one report with Shift released and the key pressed. The
+          // Shift release is marked dirty, so that it is sent as well if the
+          // key is one that is registered outside the keyboard report.
+          del_mods(MOD_MASK_SHIFT);
+          report_coalesce_mark_dirty();
+          report_coalesce_register_code16(registered_keycode);
+          report_coalesce_flush();
+#else
+          unregister_mods(MOD_MASK_SHIFT);
+          register_code16(registered_keycode);
+#endif  // REPORT_COALESCE_ENABLE
+          set_mods(saved_mods);
         }
+        return false;
       }
     }
   }
@@ -50,6 +50,41 @@
  *
  *     SRC += features/custom_shift_keys.c
  *
+ * Optionally, for a large table, sort the entries by increasing keycode and
+ * define in your config.h
+ *
+ *     #define CUSTOM_SHIFT_KEYS_SORTED
+ *
+ * Then the table is searched by binary search rather than entry by entry in
+ * order. If the table is found to be unsorted, a message is printed to the
+ * debug console and the search falls back to checking each entry.
+ *
+ * To use different custom shift keys on different layers, define in your
+ * config.h
+ *
+ *     #define CUSTOM_SHIFT_KEYS_PER_LAYER
+ *
+ * and in place of `custom_shift_keys`, define a table for each layer in
+ * PROGMEM and list them by layer in `custom_shift_keys_layers`:
+ *
+ *     const custom_shift_key_t base_shift_keys[] PROGMEM = {
+ *       {KC_DOT , KC_QUES}, // Shift . is ?
+ *       {KC_COMM, KC_EXLM}, // Shift , is !
+ *     };
+ *     const custom_shift_key_t sym_shift_keys[] PROGMEM = {
+ *       {KC_MINS, KC_EQL }, // Shift - is =
+ *     };
+ *
+ *     const custom_shift_keys_layer_t custom_shift_keys_layers[] PROGMEM = {
+ *       [BASE] = CUSTOM_SHIFT_KEYS_LAYER(base_shift_keys),
+ *       [SYM] = CUSTOM_SHIFT_KEYS_LAYER(sym_shift_keys),
+ *     };
+ *     uint8_t NUM_CUSTOM_SHIFT_KEYS_LAYERS =
+ *         sizeof(custom_shift_keys_layers) / sizeof(*custom_shift_keys_layers);
+ *
+ * The table is selected by indexing with the key's source layer, and only
+ * that table is searched. Layers without a table have no custom shift keys.
+ *
  *
  * For full documentation, see
  * <https://getreuer.info/posts/keyboards/custom-shift-keys>
@@ -73,10 +108,29 @@ typedef struct {
   uint16_t shifted_keycode;
 } custom_shift_key_t;
 
+#ifdef CUSTOM_SHIFT_KEYS_PER_LAYER
+/** Custom shift keys table for one layer. */
+typedef struct {
+  /** Table of custom shift keys in PROGMEM. */
+  const custom_shift_key_t *keys;
+  /** Number of entries in `keys`. */
+  uint8_t size;
+} custom_shift_keys_layer_t;
+
+/** Makes a `custom_shift_keys_layer_t` for a table defined as an array. */
+#define CUSTOM_SHIFT_KEYS_LAYER(table) \
+  { (table), sizeof(table) / sizeof(*(table)) }
+
+/** Custom shift keys tables indexed by layer, in PROGMEM. */
+extern const custom_shift_keys_layer_t custom_shift_keys_layers[];
+/** Number of entries in the `custom_shift_keys_layers` table. */
+extern uint8_t NUM_CUSTOM_SHIFT_KEYS_LAYERS;
+#else
 /** Table of custom shift keys. */
 extern const custom_shift_key_t custom_shift_keys[];
 /** Number of entries in the `custom_shift_keys` table. */
 extern uint8_t NUM_CUSTOM_SHIFT_KEYS;
+#endif  // CUSTOM_SHIFT_KEYS_PER_LAYER
 
 /**
  * Handler function for custom shift keys.
@@ -0,0 +1,121 @@
+// Copyright 2025 Google LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     https://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+/**
+ * @file event_trace.c
+ * @brief Event trace implementation
+ */
+
+#include "event_trace.h"
+
+#include "sendchar.h"
+
+#if (EVENT_TRACE_SIZE & (EVENT_TRACE_SIZE - 1)) != 0 || \
+    EVENT_TRACE_SIZE > 128
+#error "EVENT_TRACE_SIZE must be a power of 2, at most 128."
+#endif
+
+#define RING_MASK (EVENT_TRACE_SIZE - 1)
+
+// Ring of records. Records from `ring_start` to `ring_end` (mod the size) are
+// waiting to be sent. The indices count freely, so that the number of records
+// waiting is their difference.
+static event_trace_record_t ring[EVENT_TRACE_SIZE];
+static uint8_t ring_start = 0;
+static uint8_t ring_end = 0;
+// Time of the last event, recorded or dropped.
+static uint32_t last_time = 0;
+static bool dropped = false;
+
+static uint8_t read_layer(keyrecord_t* record) {
+#if !defined(NO_ACTION_LAYER) && !defined(STRICT_LAYER_RELEASE)
+  return read_source_layers_cache(record->event.key);
+#else
+  return get_highest_layer(layer_state | default_layer_state);
+#endif  // !defined(NO_ACTION_LAYER) && !defined(STRICT_LAYER_RELEASE)
+}
+
+void event_trace_record(uint16_t keycode, keyrecord_t* record) {
+  const uint32_t now = timer_read32();
+  const uint32_t dt = now - last_time;
+  last_time = now;
+
+  if ((uint8_t)(ring_end - ring_start) >= EVENT_TRACE_SIZE) {
+    dropped = true;  // The ring is full.
+    return;
+  }
+
+  uint8_t flags = dropped ? EVENT_TRACE_DROPPED : 0;
+  if (record->event.pressed) {
+    flags |= EVENT_TRACE_PRESSED;
+  }
+  if (IS_QK_MOD_TAP(keycode) || IS_QK_LAYER_TAP(keycode)) {
+    flags |= EVENT_TRACE_TAP_HOLD;
+    if (record->tap.count) {
+      flags |= EVENT_TRACE_TAP;
+    }
+  }
+  if (IS_COMBOEVENT(record->event)) {
+    flags |= EVENT_TRACE_COMBO;
+  }
+
+  event_trace_record_t* r = &ring[ring_end++ & RING_MASK];
+  r->dt = (dt < UINT16_MAX) ? (uint16_t)dt : UINT16_MAX;
+  r->row = record->event.key.row;
+  r->col = record->event.key.col;
+  r->layer = read_layer(record);
+  r->flags = flags;
+  r->keycode = keycode;
+  dropped = false;
+}
+
+static void send_hex_byte(uint8_t byte) {
+  static const char digits[16] = "0123456789abcdef";
+  sendchar(digits[byte >> 4]);
+  sendchar(digits[byte & 15]);
+}
+
+// Sends the oldest record as "ET <16 hex digits>\n".
+static void send_record(void) {
+  const event_trace_record_t* r = &ring[ring_start++ & RING_MASK];
+  sendchar('E');
+  sendchar('T');
+  sendchar(' ');
+  send_hex_byte(r->dt & 0xff);
+  send_hex_byte(r->dt >> 8);
+  send_hex_byte(r->row);
+  send_hex_byte(r->col);
+  send_hex_byte(r->layer);
+  send_hex_byte(r->flags);
+  send_hex_byte(r->keycode & 0xff);
+  send_hex_byte(r->keycode >> 8);
+  sendchar('\n');
+}
+
+void event_trace_task(void) {
+  if (ring_start == ring_end ||
+      timer_elapsed32(last_time) < EVENT_TRACE_IDLE_MS) {
+    return;
+  }
+  for (uint8_t i = 0; i < EVENT_TRACE_FLUSH_RECORDS && ring_start != ring_end;
+       ++i) {
+    send_record();
+  }
+}
+
+void event_trace_flush(void) {
+  while (ring_start != ring_end) {
+    send_record();
+  }
+}
@@ -0,0 +1,125 @@
+// Copyright 2025 Google LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     https://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+/**
+ * @file event_trace.h
+ * @brief Event trace: compact binary log of key events.
+ *
+ * Overview
+ * --------
+ *
+ * Logging each key event as text over the console, with the layer, position,
+ * and keycode name, is slow enough to perturb the timing being observed.
+ *
+ * This library instead records each event in RAM as a packed 8-byte record:
+ * the time since the previous event, row, col, layer, flags, and keycode.
+ * Records are kept in a ring of `EVENT_TRACE_SIZE` records and sent over the
+ * console later, once no event has been recorded for `EVENT_TRACE_IDLE_MS`, a
+ * few records per call to `event_trace_task()`. Recording is a few stores, so
+ * tracing is cheap enough to leave on. If the ring fills up before it can be
+ * sent, new events are dropped, and the next record is flagged so that the
+ * gap is visible in the decoded log.
+ *
+ * Each record is sent as a line "ET " followed by 16 hex digits, the record's
+ * bytes (multibyte fields are little endian):
+ *
+ *     ET 2500020300031622
+ *
+ * The decoder tools/trace_decode.py turns these lines into the same text as
+ * the keymap's text log, with keycode names from the host bench's
+ * `replay_bench -k` (see tools/host_bench).
+ *
+ *
+ * Usage
+ * -----
+ *
+ * In your keymap.c, record events in `process_record_user()` and call the task
+ * from `housekeeping_task_user()`:
+ *
+ *     #include "features/event_trace.h"
+ *
+ *     bool process_record_user(uint16_t keycode, keyrecord_t* record) {
+ *       event_trace_record(keycode, record);
+ *       // Your macros ...
+ *
+ *       return true;
+ *     }
+ *
+ *     void housekeeping_task_user(void) {
+ *       event_trace_task();
+ *       // Other tasks ...
+ *     }
+ *
+ * In your rules.mk, add
+ *
+ *     CONSOLE_ENABLE = yes
+ *     OPT_DEFS += -DEVENT_TRACE_ENABLE
+ *     SRC += features/event_trace.c
+ */
+
+#pragma once
+
+#include "quantum.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/** Number of records in the ring, a power of 2. Each record is 8 bytes. */
+#ifndef EVENT_TRACE_SIZE
+#define EVENT_TRACE_SIZE 32
+#endif  // EVENT_TRACE_SIZE
+
+/** Time in milliseconds without events after which records are sent. */
+#ifndef EVENT_TRACE_IDLE_MS
+#define EVENT_TRACE_IDLE_MS 250
+#endif  // EVENT_TRACE_IDLE_MS
+
+/** Maximum number of records to send per call to `event_trace_task()`. */
+#ifndef EVENT_TRACE_FLUSH_RECORDS
+#define EVENT_TRACE_FLUSH_RECORDS 4
+#endif  // EVENT_TRACE_FLUSH_RECORDS
+
+/** Bits of `event_trace_record_t::flags`. */
+enum {
+  EVENT_TRACE_PRESSED = 1 << 0,  /**< The key was pressed, not released. */
+  EVENT_TRACE_TAP_HOLD = 1 << 1, /**< The key is a mod-tap or layer-tap. */
+  EVENT_TRACE_TAP = 1 << 2,      /**< The tap-hold key was tapped. */
+  EVENT_TRACE_COMBO = 1 << 3,    /**< The event is from a combo. */
+  EVENT_TRACE_DROPPED = 1 << 7,  /**< Records before this one were dropped. */
+};
+
+/** A traced key event. */
+typedef struct {
+  /** Milliseconds since the previous record, saturated at 0xffff. */
+  uint16_t dt;
+  uint8_t row;
+  uint8_t col;
+  uint8_t layer;
+  uint8_t flags;
+  uint16_t keycode;
+} event_trace_record_t;
+
+/** Records a key event. Call this from `process_record_user()`. */
+void event_trace_record(uint16_t keycode, keyrecord_t* record);
+
+/** Sends records once idle. Call this from `housekeeping_task_user()`. */
+void event_trace_task(void);
+
+/** Sends all records now, regardless of whether idle. */
+void event_trace_flush(void);
+
+#ifdef __cplusplus
+}
+#endif
@@ -0,0 +1,109 @@
+// Copyright 2025 Google LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     https://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+/**
+ * @file idle_timeout.c
+ * @brief Idle timeout implementation
+ */
+
+#include "idle_timeout.h"
+
+#if defined(IDLE_TIMEOUT_DEFER_EXEC) && !defined(DEFERRED_EXEC_ENABLE)
+// IDLE_TIMEOUT_DEFER_EXEC uses the deferred execution API. Enable it by adding
+// `DEFERRED_EXEC_ENABLE = yes` in rules.mk.
+#error "idle_timeout: IDLE_TIMEOUT_DEFER_EXEC requires DEFERRED_EXEC_ENABLE."
+#endif
+
+// Singly-linked list of registered timeouts. A timeout is registered the first
+// time it is started and stays in the list.
+static idle_timeout_t* timeouts = NULL;
+// Whether any timeout may be active, and the earliest deadline among them.
+// Restarting or canceling a timeout does not recompute the earliest deadline,
+// so it may be early, in which case expire() finds nothing to call.
+static bool any_active = false;
+static uint32_t earliest_deadline = 0;
+
+// Calls the callbacks of expired timeouts, then recomputes the earliest
+// deadline among those still active.
+static void expire(uint32_t now) {
+  for (idle_timeout_t* t = timeouts; t; t = t->next) {
+    if (t->active && timer_expired32(now, t->deadline)) {
+      t->active = false;
+      t->callback();
+    }
+  }
+
+  any_active = false;
+  for (idle_timeout_t* t = timeouts; t; t = t->next) {
+    if (t->active &&
+        (!any_active || !timer_expired32(t->deadline, earliest_deadline))) {
+      any_active = true;
+      earliest_deadline = t->deadline;
+    }
+  }
+}
+
+#ifdef IDLE_TIMEOUT_DEFER_EXEC
+static deferred_token token = INVALID_DEFERRED_TOKEN;
+
+static uint32_t idle_timeout_callback(uint32_t trigger_time, void* cb_arg) {
+  const uint32_t now = timer_read32();
+  expire(now);
+  if (!any_active) {
+    token = INVALID_DEFERRED_TOKEN;
+    return 0;  // Cancels the callback.
+  }
+  const uint32_t delay = earliest_deadline - now;
+  return (delay == 0 || delay > UINT32_MAX / 2) ? 1 : delay;
+}
+#endif  // IDLE_TIMEOUT_DEFER_EXEC
+
+void idle_timeout_task(void) {
+#ifdef IDLE_TIMEOUT_DEFER_EXEC
+  if (token != INVALID_DEFERRED_TOKEN) {
+    return;  // The callback is scheduled and handles expiry.
+  }
+#endif  // IDLE_TIMEOUT_DEFER_EXEC
+  if (any_active) {
+    const uint32_t now = timer_read32();
+    if (timer_expired32(now, earliest_deadline)) {
+      expire(now);
+    }
+  }
+}
+
+void idle_timeout_start(idle_timeout_t* timeout, uint32_t timeout_ms) {
+  if (!timeout->registered) {
+    timeout->registered = true;
+    timeout->next = timeouts;
+    timeouts = timeout;
+  }
+  timeout->deadline = timer_read32() + timeout_ms;
+  timeout->active = true;
+
+  if (!any_active || !timer_expired32(timeout->deadline, earliest_deadline)) {
+    any_active = true;
+    earliest_deadline = timeout->deadline;
+#ifdef IDLE_TIMEOUT_DEFER_EXEC
+    if (token == INVALID_DEFERRED_TOKEN ||
+        !extend_deferred_exec(token, timeout_ms)) {
+      // If the deferred execution pool is full, this leaves the token invalid
+      // and idle_timeout_task() polls instead.
+      token = defer_exec(timeout_ms, idle_timeout_callback, NULL);
+    }
+#endif  // IDLE_TIMEOUT_DEFER_EXEC
+  }
+}
+
+void idle_timeout_cancel(idle_timeout_t* timeout) { timeout->active = false; }
@@ -0,0 +1,112 @@
+// Copyright 2025 Google LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     https://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+/**
+ * @file idle_timeout.h
+ * @brief Idle timeout: shared deadlines for features that time out when idle.
+ *
+ * Overview
+ * --------
+ *
+ * Several features turn off after a period of inactivity, like Sentence Case
+ * with `SENTENCE_CASE_TIMEOUT` and Select Word with `SELECT_WORD_TIMEOUT`.
+ * Each would otherwise poll its own timer from the housekeeping task.
+ *
+ * With this library, each feature instead registers an `idle_timeout_t` with
+ * a callback and (re)starts it with a deadline. The library keeps the earliest
+ * deadline, so that `idle_timeout_task()` does a single comparison per call
+ * however many timeouts are registered. Optionally with
+ * `IDLE_TIMEOUT_DEFER_EXEC`, a single deferred execution callback is used
+ * instead, and the task only polls if the callback could not be scheduled.
+ *
+ * When `IDLE_TIMEOUT_ENABLE` is defined, Sentence Case and Select Word use
+ * this library for their timeouts, and their own task functions do nothing.
+ *
+ *
+ * Usage
+ * -----
+ *
+ * In your keymap.c, call the task from `housekeeping_task_user()`:
+ *
+ *     #include "features/idle_timeout.h"
+ *
+ *     void housekeeping_task_user(void) {
+ *       idle_timeout_task();
+ *       // Other tasks ...
+ *     }
+ *
+ * In your rules.mk, add
+ *
+ *     OPT_DEFS += -DIDLE_TIMEOUT_ENABLE
+ *     SRC += features/idle_timeout.c
+ *
+ * To use a timeout in your own code, define it with its callback and start it
+ * on activity:
+ *
+ *     static void my_timeout_callback(void) {
+ *       // Turn off something...
+ *     }
+ *     static idle_timeout_t my_timeout = {.callback = my_timeout_callback};
+ *
+ *     // On activity:
+ *     idle_timeout_start(&my_timeout, 5000);  // Time out after 5 s idle.
+ */
+
+#pragma once
+
+#include "quantum.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/** A registered timeout. Define with `callback` set, other fields zero. */
+typedef struct idle_timeout {
+  /** Function called when the timeout expires. */
+  void (*callback)(void);
+  /** Time at which the timeout expires, if active. */
+  uint32_t deadline;
+  /** Next registered timeout, for use by the library. */
+  struct idle_timeout* next;
+  bool active;
+  bool registered;
+} idle_timeout_t;
+
+/**
+ * @brief Starts or restarts `timeout` to expire after `timeout_ms`.
+ *
+ * When the timeout expires, it is no longer active and its callback is called
+ * from `idle_timeout_task()`. The callback may restart the timeout.
+ */
+void idle_timeout_start(idle_timeout_t* timeout, uint32_t timeout_ms);
+
+/** Stops `timeout` without calling its callback. */
+void idle_timeout_cancel(idle_timeout_t* timeout);
+
+/** Returns whether `timeout` has been started and not yet expired. */
+static inline bool idle_timeout_is_active(const idle_timeout_t* timeout) {
+  return timeout->active;
+}
+
+/**
+ * Calls the callbacks of expired timeouts. Call this function from
+ * `housekeeping_task_user()`. (With `IDLE_TIMEOUT_DEFER_EXEC`, it returns
+ * immediately unless the deferred execution pool was full when the callback
+ * was scheduled, in which case it polls so that timeouts still expire.)
+ */
+void idle_timeout_task(void);
+
+#ifdef __cplusplus
+}
+#endif
@@ -0,0 +1,132 @@
+// Copyright 2025 Google LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     https://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+/**
+ * @file key_event.c
+ * @brief Key event implementation
+ */
+
+#include "key_event.h"
+
+static key_event_t decoded = {0};
+// Event for which `decoded` was computed.
+static const keyrecord_t* decoded_record = NULL;
+static uint16_t decoded_time = 0;
+static uint16_t decoded_input = KC_NO;
+static uint8_t decoded_tap_count = 0;
+
+// Classifies `keycode`, a basic keycode or a basic keycode with mods.
+static uint8_t classify(uint16_t keycode, uint8_t mods) {
+  if (IS_QK_MODS(keycode)) {
+    if ((QK_MODS_GET_MODS(keycode) & ~(MOD_LSFT | MOD_RSFT)) != 0) {
+      return KEY_CLASS_OTHER;  // Chord with mods other than Shift.
+    }
+    keycode = QK_MODS_GET_BASIC_KEYCODE(keycode);
+    mods |= MOD_BIT(KC_LSFT);
+  }
+
+  switch (keycode) {
+    case KC_A ... KC_Z:
+      return KEY_CLASS_LETTER;
+    case KC_1 ... KC_0:
+      return (mods & MOD_MASK_SHIFT) ? KEY_CLASS_SYMBOL : KEY_CLASS_DIGIT;
+    case KC_MINS ... KC_SLSH:
+      return KEY_CLASS_SYMBOL;
+    case KC_SPC:
+      return KEY_CLASS_SPACE;
+    case KC_BSPC:
+      return KEY_CLASS_BACKSPACE;
+  }
+  return KEY_CLASS_OTHER;
+}
+
+static void decode(uint16_t keycode, keyrecord_t* record) {
+  decoded.is_hold = false;
+  decoded.key_class = KEY_CLASS_NONE;
+
+  switch (keycode) {
+    case KC_LCTL ... KC_RGUI:  // Mod keys type nothing.
+    case QK_ONE_SHOT_MOD ... QK_ONE_SHOT_MOD_MAX:
+    // MO, TO, TG, TT, OSL, DF, LM layer switch keys type nothing.
+    case QK_MOMENTARY ... QK_MOMENTARY_MAX:
+    case QK_TO ... QK_TO_MAX:
+    case QK_TOGGLE_LAYER ... QK_TOGGLE_LAYER_MAX:
+    case QK_LAYER_TAP_TOGGLE ... QK_LAYER_TAP_TOGGLE_MAX:
+    case QK_ONE_SHOT_LAYER ... QK_ONE_SHOT_LAYER_MAX:
+    case QK_DEF_LAYER ... QK_DEF_LAYER_MAX:
+    case QK_LAYER_MOD ... QK_LAYER_MOD_MAX:
+#ifdef TRI_LAYER_ENABLE
+    case QK_TRI_LAYER_LOWER:
+    case QK_TRI_LAYER_UPPER:
+#endif  // TRI_LAYER_ENABLE
+      decoded.keycode = keycode;
+      return;
+
+#ifndef NO_ACTION_TAPPING
+    case QK_MOD_TAP ... QK_MOD_TAP_MAX:
+      keycode = QK_MOD_TAP_GET_TAP_KEYCODE(keycode);
+      decoded.is_hold = (record->tap.count == 0);
+      break;
+#ifndef NO_ACTION_LAYER
+    case QK_LAYER_TAP ... QK_LAYER_TAP_MAX:
+      keycode = QK_LAYER_TAP_GET_TAP_KEYCODE(keycode);
+      decoded.is_hold = (record->tap.count == 0);
+      break;
+#endif  // NO_ACTION_LAYER
+#endif  // NO_ACTION_TAPPING
+
+#ifdef SWAP_HANDS_ENABLE
+    case QK_SWAP_HANDS ... QK_SWAP_HANDS_MAX:
+      if (IS_SWAP_HANDS_KEYCODE(keycode)) {
+        decoded.keycode = keycode;
+        return;
+      }
+      keycode = QK_SWAP_HANDS_GET_TAP_KEYCODE(keycode);
+      decoded.is_hold = (record->tap.count == 0);
+      break;
+#endif  // SWAP_HANDS_ENABLE
+  }
+
+  decoded.keycode = keycode;
+  if (!decoded.is_hold) {
+    decoded.key_class = classify(keycode, decoded.mods);
+  }
+}
+
+const key_event_t* key_event_decode(uint16_t keycode, keyrecord_t* record) {
+  // Mods are read on every call, since handlers may change them.
+#ifndef NO_ACTION_ONESHOT
+  const uint8_t mods = get_mods() | get_weak_mods() | get_oneshot_mods();
+#else
+  const uint8_t mods = get_mods() | get_weak_mods();
+#endif  // NO_ACTION_ONESHOT
+
+  if (record != decoded_record || record->event.time != decoded_time ||
+      keycode != decoded_input || record->tap.count != decoded_tap_count) {
+    decoded_record = record;
+    decoded_time = record->event.time;
+    decoded_input = keycode;
+    decoded_tap_count = record->tap.count;
+    decoded.mods = mods;
+    decode(keycode, record);
+  } else if (mods != decoded.mods) {
+    // An earlier handler changed the mods, e.g. with one-shot Shift, which
+    // decides whether a number key is a digit or a symbol.
+    decoded.mods = mods;
+    if (decoded.key_class != KEY_CLASS_NONE) {
+      decoded.key_class = classify(decoded.keycode, mods);
+    }
+  }
+  return &decoded;
+}
@@ -0,0 +1,104 @@
+// Copyright 2025 Google LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     https://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+/**
+ * @file key_event.h
+ * @brief Key event: decode a key event once for all features.
+ *
+ * Overview
+ * --------
+ *
+ * Many features begin by decoding the event: unwrapping the tap keycode of
+ * mod-tap and layer-tap keys, checking whether a tap-hold key is held, getting
+ * the active mods, and classifying the key as a letter, space, and so on.
+ *
+ * This library does that decoding in one place. `key_event_decode()` decodes
+ * the event the first time it is called for the event and returns the cached
+ * result for later calls, so the decoding is done once however many features
+ * ask for it.
+ *
+ * Autocorrection, Key History, Sentence Case, and the keymap's
+ * `remember_last_key_user()` use this library when `KEY_EVENT_ENABLE` is
+ * defined.
+ *
+ *
+ * Usage
+ * -----
+ *
+ * Call `key_event_decode()` from any handler:
+ *
+ *     #include "features/key_event.h"
+ *
+ *     bool process_record_user(uint16_t keycode, keyrecord_t* record) {
+ *       const key_event_t* event = key_event_decode(keycode, record);
+ *       if (event->key_class == KEY_CLASS_LETTER) {
+ *         // ...
+ *       }
+ *       // Your macros ...
+ *
+ *       return true;
+ *     }
+ *
+ * In your rules.mk, add
+ *
+ *     OPT_DEFS += -DKEY_EVENT_ENABLE
+ *     SRC += features/key_event.c
+ */
+
+#pragma once
+
+#include "quantum.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/** Classes of keys. */
+enum key_class {
+  /** Types nothing: held tap-hold keys, mods, and layer switch keys. */
+  KEY_CLASS_NONE,
+  KEY_CLASS_LETTER,    /**< KC_A to KC_Z. */
+  KEY_CLASS_DIGIT,     /**< KC_1 to KC_0, unshifted. */
+  KEY_CLASS_SYMBOL,    /**< Other printable keys, like KC_DOT and KC_EXLM. */
+  KEY_CLASS_SPACE,     /**< KC_SPC. */
+  KEY_CLASS_BACKSPACE, /**< KC_BSPC. */
+  KEY_CLASS_OTHER,     /**< Any other key, like KC_ENT or KC_LEFT. */
+};
+
+/** Decoded key event. */
+typedef struct {
+  /**
+   * The keycode, or for a mod-tap, layer-tap, or swap hands tap key, the tap
+   * keycode, whether tapped or held.
+   */
+  uint16_t keycode;
+  /** The active mods: regular, weak, and one-shot mods. */
+  uint8_t mods;
+  /** Whether the event is a tap-hold key being held. */
+  bool is_hold;
+  /** Class of the key from `enum key_class`. */
+  uint8_t key_class;
+} key_event_t;
+
+/**
+ * Decodes a key event. The result is cached, so that calls for the same event
+ * after the first are cheap. The mods, and the key class that depends on them,
+ * are brought up to date on every call. The returned pointer is valid until the
+ * next call.
+ */
+const key_event_t* key_event_decode(uint16_t keycode, keyrecord_t* record);
+
+#ifdef __cplusplus
+}
+#endif
@@ -0,0 +1,121 @@
+// Copyright 2025 Google LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     https://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+/**
+ * @file key_history.c
+ * @brief Key history implementation
+ */
+
+#include "key_history.h"
+
+#include <string.h>
+
+#include "key_event.h"
+
+#ifndef KEY_EVENT_ENABLE
+#error "key_history: Please enable key_event, which key_history depends on."
+#endif  // KEY_EVENT_ENABLE
+#if KEY_HISTORY_SIZE < 1 || KEY_HISTORY_SIZE > 127
+#error "KEY_HISTORY_SIZE must be between 1 and 127."
+#endif
+
+// The ring holds one more key than KEY_HISTORY_SIZE, so that the key typed
+// KEY_HISTORY_SIZE presses ago is also available.
+#define RING_SIZE (KEY_HISTORY_SIZE + 1)
+
+// Ring buffer of typed keys. The next key is written at `history_end`.
+static uint16_t history[RING_SIZE] = {0};
+static uint8_t history_end = 0;
+// Count of keys added minus keys removed, modulo 256. Views begin at a count.
+static uint8_t history_count = 0;
+// Singly-linked list of registered views. A view is registered the first time
+// it is used and stays in the list.
+static key_history_view_t* views = NULL;
+
+// Number of keys in `view`, at most RING_SIZE.
+static uint8_t view_length(const key_history_view_t* view) {
+  return (uint8_t)(history_count - view->start);
+}
+
+static void push(uint16_t keycode) {
+  history[history_end] = keycode;
+  if (++history_end >= RING_SIZE) {
+    history_end = 0;
+  }
+  ++history_count;
+  // Keep views within the ring, so that their length doesn't wrap around.
+  for (key_history_view_t* v = views; v; v = v->next) {
+    if (view_length(v) > RING_SIZE) {
+      v->start = history_count - RING_SIZE;
+    }
+  }
+}
+
+static void pop(void) {
+  history_end = (history_end ? history_end : RING_SIZE) - 1;
+  history[history_end] = KC_NO;
+  // An empty view stays empty, rather than reaching back before its start.
+  for (key_history_view_t* v = views; v; v = v->next) {
+    if (v->start == history_count) {
+      --v->start;
+    }
+  }
+  --history_count;
+}
+
+bool process_key_history(uint16_t keycode, keyrecord_t* record) {
+  if (!record->event.pressed) {
+    return true;
+  }
+
+  const key_event_t* event = key_event_decode(keycode, record);
+  if (event->key_class == KEY_CLASS_NONE) {
+    return true;  // Ignore keys that type nothing.
+  } else if (event->key_class == KEY_CLASS_BACKSPACE) {
+    pop();  // Remove the last key.
+  } else {  // Add a key, replacing the oldest.
+    push(event->keycode);
+  }
+  return true;
+}
+
+uint16_t key_history_get(uint8_t ago) {
+  const uint8_t i = history_end + (RING_SIZE - 1 - ago);
+  return history[(i >= RING_SIZE) ? i - RING_SIZE : i];
+}
+
+void key_history_view_reset(key_history_view_t* view) {
+  if (!view->registered) {
+    view->registered = true;
+    view->next = views;
+    views = view;
+  }
+  view->start = history_count;
+}
+
+uint16_t key_history_view_get(key_history_view_t* view, uint8_t ago) {
+  if (!view->registered) {
+    key_history_view_reset(view);
+  }
+  return (ago < view_length(view)) ? key_history_get(ago) : KC_NO;
+}
+
+void key_history_clear(void) {
+  memset(history, 0, sizeof(history));
+  history_end = 0;
+  history_count = 0;
+  for (key_history_view_t* v = views; v; v = v->next) {
+    v->start = 0;
+  }
+}
@@ -0,0 +1,114 @@
+// Copyright 2025 Google LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     https://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+/**
+ * @file key_history.h
+ * @brief Key history: shared history of recently typed keys.
+ *
+ * Overview
+ * --------
+ *
+ * Features that act on typing, like Sentence Case, keep a buffer of the last
+ * few keys typed.
+ *
+ * This library records the last `KEY_HISTORY_SIZE` typed keycodes in one ring
+ * buffer, shared by the features that read it. Keys are decoded with Key Event
+ * (key_event.h), so that tapped tap-hold keys are recorded as their tap
+ * keycode, and keys that type nothing, like mods and layer switches, are not
+ * recorded. Backspace removes the last key from the history.
+ *
+ * The history is stored once, in a ring of `KEY_HISTORY_SIZE + 1` keycodes.
+ * Readers get keys one at a time with `key_history_get()`. A reader that needs
+ * to forget the keys typed so far, for instance when it resets, keeps a
+ * `key_history_view_t` and resets the view, rather than clearing the history
+ * that other readers share. A view sees only the keys typed since its reset.
+ *
+ * Sentence Case reads the history through its own view in place of its own key
+ * buffer when `KEY_HISTORY_ENABLE` is defined. It is currently the only reader
+ * in this repo; autocorrection and Repeat Key keep their own state, since they
+ * track typos and remembered mods that the history doesn't record.
+ *
+ *
+ * Usage
+ * -----
+ *
+ * In your keymap.c, call the handler before the handlers that use it:
+ *
+ *     #include "features/key_history.h"
+ *
+ *     bool process_record_user(uint16_t keycode, keyrecord_t* record) {
+ *       if (!process_key_history(keycode, record)) { return false; }
+ *       if (!process_sentence_case(keycode, record)) { return false; }
+ *       // Your macros ...
+ *
+ *       return true;
+ *     }
+ *
+ * In your rules.mk, add
+ *
+ *     OPT_DEFS += -DKEY_EVENT_ENABLE -DKEY_HISTORY_ENABLE
+ *     SRC += features/key_event.c features/key_history.c
+ */
+
+#pragma once
+
+#include "quantum.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/** Number of typed keycodes to remember. */
+#ifndef KEY_HISTORY_SIZE
+#define KEY_HISTORY_SIZE 8
+#endif  // KEY_HISTORY_SIZE
+
+/** Handler function for key history. Records key presses. */
+bool process_key_history(uint16_t keycode, keyrecord_t* record);
+
+/**
+ * Gets the keycode typed `ago` key presses ago, 0 being the most recent, or
+ * KC_NO. `ago` must be less than or equal to `KEY_HISTORY_SIZE`.
+ */
+uint16_t key_history_get(uint8_t ago);
+
+/**
+ * A reader's view of the history, holding the keys typed since the view was
+ * reset. Define with all fields zero, for instance
+ *
+ *     static key_history_view_t my_view = {0};
+ */
+typedef struct key_history_view {
+  /** Key count where the view begins, for use by the library. */
+  uint8_t start;
+  /** Next registered view, for use by the library. */
+  struct key_history_view* next;
+  bool registered;
+} key_history_view_t;
+
+/** Resets `view` to empty. Keys typed afterward are added to it. */
+void key_history_view_reset(key_history_view_t* view);
+
+/**
+ * Like `key_history_get()`, but returns KC_NO for keys typed before `view` was
+ * reset. A view that hasn't been reset begins empty on first use.
+ */
+uint16_t key_history_view_get(key_history_view_t* view, uint8_t ago);
+
+/** Clears the history, for all readers. */
+void key_history_clear(void);
+
+#ifdef __cplusplus
+}
+#endif
@@ -0,0 +1,240 @@
+// Copyright 2025 Google LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     https://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+/**
+ * @file key_stats.c
+ * @brief Key stats implementation
+ */
+
+#include "key_stats.h"
+
+#include <string.h>
+
+#ifdef ACHORDION_ENABLE
+#include "achordion.h"
+#endif  // ACHORDION_ENABLE
+
+#ifdef RAW_ENABLE
+#include "raw_hid.h"
+#endif  // RAW_ENABLE
+
+#if MATRIX_ROWS * MATRIX_COLS > 256
+#error "key_stats: The matrix must have at most 256 keys."
+#endif
+
+#if defined(EECONFIG_USER_DATA_SIZE) && EECONFIG_USER_DATA_SIZE > 0
+#define PERSIST
+_Static_assert(
+    KEY_STATS_EEPROM_OFFSET + sizeof(key_stats_t) <= EECONFIG_USER_DATA_SIZE,
+    "key_stats: EECONFIG_USER_DATA_SIZE is too small to store the stats.");
+#endif  // defined(EECONFIG_USER_DATA_SIZE) && EECONFIG_USER_DATA_SIZE > 0
+
+// Identifies stored stats. It depends on the sizes, so that stats stored with
+// a different layout are not loaded.
+#define KEY_STATS_MAGIC \
+  (0x4B53 ^ (MATRIX_ROWS * MATRIX_COLS) ^ (KEY_STATS_NUM_BIGRAMS << 8))
+
+static key_stats_t stats = {.magic = KEY_STATS_MAGIC};
+// The previous press, for counting bigrams.
+static keypos_t prev_pos = {.row = 255, .col = 255};
+static uint16_t prev_time = 0;
+
+#ifdef PERSIST
+static bool dirty = false;
+// While saving, the offset of the next byte to write, otherwise 0.
+static uint16_t save_offset = 0;
+static uint32_t last_save_time = 0;
+static uint32_t last_press_time = 0;
+#endif  // PERSIST
+
+__attribute__((weak)) bool key_stats_same_hand(keypos_t a, keypos_t b) {
+#ifdef ACHORDION_ENABLE
+  const char hand = achordion_hand(a);
+  return hand != '*' && hand == achordion_hand(b);
+#elif defined(SPLIT_KEYBOARD)
+  return (a.row < MATRIX_ROWS / 2) == (b.row < MATRIX_ROWS / 2);
+#else
+  return (MATRIX_COLS > MATRIX_ROWS)
+             ? (a.col < MATRIX_COLS / 2) == (b.col < MATRIX_COLS / 2)
+             : (a.row < MATRIX_ROWS / 2) == (b.row < MATRIX_ROWS / 2);
+#endif  // ACHORDION_ENABLE
+}
+
+// Halves all counters, keeping their relative frequencies.
+static void halve_all(void) {
+  for (uint16_t i = 0; i < MATRIX_ROWS * MATRIX_COLS; ++i) {
+    stats.key_counts[i] >>= 1;
+  }
+  for (uint8_t i = 0; i < KEY_STATS_NUM_BIGRAMS; ++i) {
+    stats.bigrams[i].count >>= 1;
+  }
+}
+
+static void increment(uint16_t* count) {
+  if (*count == UINT16_MAX) {
+    halve_all();
+  }
+  ++*count;
+}
+
+static void count_bigram(uint8_t first, uint8_t second) {
+  key_stats_bigram_t* least = &stats.bigrams[0];
+  for (uint8_t i = 0; i < KEY_STATS_NUM_BIGRAMS; ++i) {
+    key_stats_bigram_t* bigram = &stats.bigrams[i];
+    if (bigram->count && bigram->first == first && bigram->second == second) {
+      increment(&bigram->count);
+      return;
+    }
+    if (bigram->count < least->count) {
+      least = bigram;
+    }
+  }
+  // Take an unused entry if any, otherwise replace the least frequent bigram,
+  // continuing from its count.
+  least->first = first;
+  least->second = second;
+  increment(&least->count);
+}
+
+void key_stats_record(const keyrecord_t* record) {
+  const keypos_t pos = record->event.key;
+  if (!record->event.pressed || IS_COMBOEVENT(record->event) ||
+      pos.row >= MATRIX_ROWS || pos.col >= MATRIX_COLS) {
+    return;
+  }
+
+  const uint8_t index = pos.row * MATRIX_COLS + pos.col;
+  increment(&stats.key_counts[index]);
+  if (prev_pos.row < MATRIX_ROWS &&
+      (uint16_t)(record->event.time - prev_time) <
+          KEY_STATS_BIGRAM_TIMEOUT_MS &&
+      key_stats_same_hand(prev_pos, pos)) {
+    count_bigram(prev_pos.row * MATRIX_COLS + prev_pos.col, index);
+  }
+  prev_pos = pos;
+  prev_time = record->event.time;
+
+#ifdef PERSIST
+  dirty = true;
+  last_press_time = timer_read32();
+#endif  // PERSIST
+}
+
+const key_stats_t* key_stats_get(void) { return &stats; }
+
+void key_stats_reset(void) {
+  memset(&stats, 0, sizeof(stats));
+  stats.magic = KEY_STATS_MAGIC;
+  prev_pos.row = 255;
+#ifdef PERSIST
+  // Save once idle, regardless of when the stats were last saved.
+  dirty = true;
+  last_save_time = timer_read32() - KEY_STATS_SAVE_INTERVAL_MS;
+#endif  // PERSIST
+}
+
+#ifdef PERSIST
+void key_stats_init(void) {
+  uint16_t magic = 0;
+  eeconfig_read_user_datablock(&magic, KEY_STATS_EEPROM_OFFSET, sizeof(magic));
+  if (magic == KEY_STATS_MAGIC) {
+    eeconfig_read_user_datablock(&stats, KEY_STATS_EEPROM_OFFSET,
+                                 sizeof(stats));
+  }
+  last_save_time = timer_read32();
+}
+
+void key_stats_task(void) {
+  if (save_offset) {  // Write the next chunk.
+    uint16_t size = sizeof(stats) - save_offset;
+    if (size > KEY_STATS_SAVE_CHUNK_SIZE) {
+      size = KEY_STATS_SAVE_CHUNK_SIZE;
+    }
+    eeconfig_update_user_datablock((const uint8_t*)&stats + save_offset,
+                                   KEY_STATS_EEPROM_OFFSET + save_offset,
+                                   size);
+    save_offset += size;
+    if (save_offset >= sizeof(stats)) {
+      // Write the magic last, so that it is valid only once data is written.
+      eeconfig_update_user_datablock(&stats.magic, KEY_STATS_EEPROM_OFFSET,
+                                     sizeof(stats.magic));
+      save_offset = 0;
+    }
+  } else if (dirty &&
+             timer_elapsed32(last_save_time) >= KEY_STATS_SAVE_INTERVAL_MS &&
+             timer_elapsed32(last_press_time) >= KEY_STATS_SAVE_IDLE_MS) {
+    // Start saving. Presses during the save are saved the next time.
+    dirty = false;
+    last_save_time = timer_read32();
+    save_offset = sizeof(stats.magic);
+  }
+}
+#else
+void key_stats_init(void) {}
+void key_stats_task(void) {}
+#endif  // PERSIST
+
+#ifdef RAW_ENABLE
+bool key_stats_raw_hid_receive(uint8_t* data, uint8_t length) {
+  if (length < 8 || data[0] != KEY_STATS_RAW_HID_ID) {
+    return false;
+  }
+
+  const uint16_t arg = data[2] | (uint16_t)data[3] << 8;
+  uint8_t* payload = data + 4;
+  const uint8_t payload_size = length - 4;
+  memset(payload, 0, payload_size);
+
+  switch (data[1]) {
+    case 'i':  // Info.
+      payload[0] = MATRIX_ROWS;
+      payload[1] = MATRIX_COLS;
+      payload[2] = KEY_STATS_NUM_BIGRAMS;
+      payload[3] = (uint8_t)sizeof(stats);
+      payload[4] = (uint8_t)(sizeof(stats) >> 8);
+      break;
+
+    case 'r':  // Read stats.
+      if (arg < sizeof(stats)) {
+        uint16_t size = sizeof(stats) - arg;
+        if (size > payload_size) {
+          size = payload_size;
+        }
+        memcpy(payload, (const uint8_t*)&stats + arg, size);
+      }
+      break;
+
+    case 'k':  // Base layer keycodes.
+      for (uint8_t i = 0; i < payload_size / 2; ++i) {
+        const uint16_t index = arg + i;
+        if (index >= MATRIX_ROWS * MATRIX_COLS) {
+          break;
+        }
+        const keypos_t pos = {.row = index / MATRIX_COLS,
+                              .col = index % MATRIX_COLS};
+        const uint16_t keycode = keymap_key_to_keycode(0, pos);
+        payload[2 * i] = (uint8_t)keycode;
+        payload[2 * i + 1] = (uint8_t)(keycode >> 8);
+      }
+      break;
+
+    case 'z':  // Reset.
+      key_stats_reset();
+      break;
+  }
+
+  raw_hid_send(data, length);
+  return true;
+}
+#endif  // RAW_ENABLE
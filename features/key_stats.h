@@ -0,0 +1,209 @@
+// Copyright 2025 Google LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     https://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+/**
+ * @file key_stats.h
+ * @brief Key stats: count key presses and same-hand bigrams on the keyboard.
+ *
+ * Overview
+ * --------
+ *
+ * Tools like tools/count_chars.py count characters in text files offline, but
+ * can't see how keys are actually pressed. This library counts on the keyboard
+ * itself how often each key is pressed, by matrix position, and how often each
+ * same-hand bigram is typed, two keys on the same hand pressed in succession
+ * within `KEY_STATS_BIGRAM_TIMEOUT_MS`. Such data helps to tune for instance
+ * `achordion_chord()` exemptions, combos, and timeouts.
+ *
+ * Counters are 16-bit. When one would overflow, all counters are halved, so
+ * that the relative frequencies are kept. Bigrams are counted in a table of
+ * `KEY_STATS_NUM_BIGRAMS` entries. Once the table is full, a new bigram
+ * replaces the least frequent one and starts from its count (the "space
+ * saving" algorithm), so that the most frequent bigrams are found with
+ * approximate counts.
+ *
+ * If `EECONFIG_USER_DATA_SIZE` is defined, the stats are loaded from the
+ * EEPROM user datablock when the keyboard starts and saved back periodically,
+ * at most every `KEY_STATS_SAVE_INTERVAL_MS` and only after no key has been
+ * pressed for `KEY_STATS_SAVE_IDLE_MS`. The data is written in chunks of
+ * `KEY_STATS_SAVE_CHUNK_SIZE` bytes per call to `key_stats_task()`, so as not
+ * to block the keyboard. Only changed bytes are written, and on boards where
+ * EEPROM is emulated in flash, QMK's wear leveling spreads the writes.
+ *
+ * If raw HID is enabled, the stats may be read by a host with
+ * tools/key_stats.py, which prints frequency reports in the same format as
+ * tools/count_chars.py.
+ *
+ *
+ * Usage
+ * -----
+ *
+ * In your keymap.c, call the handlers as follows:
+ *
+ *     #include "features/key_stats.h"
+ *
+ *     void keyboard_post_init_user(void) {
+ *       key_stats_init();
+ *     }
+ *
+ *     bool process_record_user(uint16_t keycode, keyrecord_t* record) {
+ *       key_stats_record(record);
+ *       // Your macros ...
+ *
+ *       return true;
+ *     }
+ *
+ *     void housekeeping_task_user(void) {
+ *       key_stats_task();
+ *       // Other tasks ...
+ *     }
+ *
+ *     void raw_hid_receive(uint8_t* data, uint8_t length) {
+ *       key_stats_raw_hid_receive(data, length);
+ *     }
+ *
+ * If your keymap already has a `raw_hid_receive()`, call
+ * `key_stats_raw_hid_receive()` from it first, and handle the report yourself
+ * if it returns false. VIA defines `raw_hid_receive()` for its own protocol,
+ * so the two can't share raw HID as is; with VIA, leave out the handler.
+ *
+ * In your config.h, define the size of the EEPROM user datablock, at least
+ * `sizeof(key_stats_t)`, for the stats to persist:
+ *
+ *     #define EECONFIG_USER_DATA_SIZE 512
+ *
+ * In your rules.mk, add
+ *
+ *     RAW_ENABLE = yes
+ *     OPT_DEFS += -DKEY_STATS_ENABLE
+ *     SRC += features/key_stats.c
+ *
+ *
+ * Raw HID protocol
+ * ----------------
+ *
+ * Requests and replies are raw HID reports, where the first byte is
+ * `KEY_STATS_RAW_HID_ID`. The second byte is the command, the next two bytes
+ * are an argument (little endian), and the reply repeats these four bytes
+ * followed by the payload:
+ *
+ *  * 'i' info: payload is MATRIX_ROWS, MATRIX_COLS, KEY_STATS_NUM_BIGRAMS, and
+ *    `sizeof(key_stats_t)` as 2 bytes.
+ *  * 'r' read: payload is `sizeof(key_stats_t)` bytes starting at the offset
+ *    given by the argument, as many as fit.
+ *  * 'k' keycodes: payload is the base layer keycodes (2 bytes each) of keys
+ *    starting at the matrix index given by the argument, as many as fit.
+ *  * 'z' reset: clears the stats. The payload is empty.
+ *
+ * Multibyte values are little endian, as they are stored on the keyboard.
+ */
+
+#pragma once
+
+#include "quantum.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/** Number of entries in the bigram table. */
+#ifndef KEY_STATS_NUM_BIGRAMS
+#define KEY_STATS_NUM_BIGRAMS 64
+#endif  // KEY_STATS_NUM_BIGRAMS
+
+/** Two presses within this time count as a bigram. */
+#ifndef KEY_STATS_BIGRAM_TIMEOUT_MS
+#define KEY_STATS_BIGRAM_TIMEOUT_MS 500
+#endif  // KEY_STATS_BIGRAM_TIMEOUT_MS
+
+/** Minimum time between saves to EEPROM, 30 minutes by default. */
+#ifndef KEY_STATS_SAVE_INTERVAL_MS
+#define KEY_STATS_SAVE_INTERVAL_MS 1800000
+#endif  // KEY_STATS_SAVE_INTERVAL_MS
+
+/** Saving starts only after no key has been pressed for this long. */
+#ifndef KEY_STATS_SAVE_IDLE_MS
+#define KEY_STATS_SAVE_IDLE_MS 5000
+#endif  // KEY_STATS_SAVE_IDLE_MS
+
+/** Number of bytes written to EEPROM per call to `key_stats_task()`. */
+#ifndef KEY_STATS_SAVE_CHUNK_SIZE
+#define KEY_STATS_SAVE_CHUNK_SIZE 16
+#endif  // KEY_STATS_SAVE_CHUNK_SIZE
+
+/** Offset of the stats in the EEPROM user datablock. */
+#ifndef KEY_STATS_EEPROM_OFFSET
+#define KEY_STATS_EEPROM_OFFSET 0
+#endif  // KEY_STATS_EEPROM_OFFSET
+
+/** First byte of raw HID reports for this library. */
+#ifndef KEY_STATS_RAW_HID_ID
+#define KEY_STATS_RAW_HID_ID 0x4B  // 'K'
+#endif  // KEY_STATS_RAW_HID_ID
+
+/** A counted bigram. Keys are matrix indices, row * MATRIX_COLS + col. */
+typedef struct {
+  uint8_t first;
+  uint8_t second;
+  uint16_t count;
+} key_stats_bigram_t;
+
+/** The stats, as stored in EEPROM and read over raw HID. */
+typedef struct {
+  /** Identifies valid stored data and its layout. */
+  uint16_t magic;
+  /** Press counts by matrix index, row * MATRIX_COLS + col. */
+  uint16_t key_counts[MATRIX_ROWS * MATRIX_COLS];
+  /** Same-hand bigrams, unused entries with count 0. */
+  key_stats_bigram_t bigrams[KEY_STATS_NUM_BIGRAMS];
+} key_stats_t;
+
+/** Loads the stats from EEPROM. Call this from `keyboard_post_init_user()`. */
+void key_stats_init(void);
+
+/** Counts a key event. Call this from `process_record_user()`. */
+void key_stats_record(const keyrecord_t* record);
+
+/** Saves the stats periodically. Call this from `housekeeping_task_user()`. */
+void key_stats_task(void);
+
+/** Gets the stats. */
+const key_stats_t* key_stats_get(void);
+
+/** Clears the stats, also in EEPROM on the next save. */
+void key_stats_reset(void);
+
+/**
+ * Handles a raw HID report for key stats, replying with `raw_hid_send()`.
+ * Call this from `raw_hid_receive()`.
+ *
+ * @return True if the report was handled, false if it is for another feature.
+ */
+#ifdef RAW_ENABLE
+bool key_stats_raw_hid_receive(uint8_t* data, uint8_t length);
+#endif  // RAW_ENABLE
+
+/**
+ * Optional callback for whether two keys are on the same hand, so that
+ * pressing them in succession counts as a bigram. By default, this is the
+ * hand from `achordion_hand()` if Achordion is enabled, which uses the
+ * `achordion_hand_layout` table if defined, with exempt keys on neither hand.
+ * Otherwise, the left hand is the first half of the rows on split keyboards or
+ * of the columns.
+ */
+bool key_stats_same_hand(keypos_t a, keypos_t b);
+
+#ifdef __cplusplus
+}
+#endif
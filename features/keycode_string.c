@@ -84,10 +84,25 @@ const keycode_string_name_t custom_keycode_names[] = {KEYCODE_STRING_NAMES_END};
 /** Names of the 4 mods on each hand. */
 static const char* mod_names[4] = {PSTR("CTL"), PSTR("SFT"), PSTR("ALT"),
                                    PSTR("GUI")};
-/** Internal buffer for holding a stringified keycode. */
+/** Internal buffer for `keycode_string()`. */
 static char buffer[32];
-#define BUFFER_MAX_LEN (sizeof(buffer) - 1)
-static index_t buffer_len;
+
+/**
+ * Destination of the keycode being formatted: either a buffer, or if
+ * `put_char` is set, a function that is called with each char.
+ */
+typedef struct {
+  char* dest;
+  size_t len;      /**< Number of chars written to `dest`. */
+  size_t max_len;  /**< Capacity of `dest`, excluding the null terminator. */
+  void (*put_char)(char);
+} writer_t;
+
+/**
+ * Writer of the call in progress. Public functions save and restore it, so
+ * that a call interrupting another, e.g. from a callback, is safe.
+ */
+static writer_t* writer = NULL;
 
 /**
  * @brief Finds the name of a keycode in `table` or returns NULL.
@@ -107,65 +122,152 @@ static const char* find_keycode_name(const keycode_string_name_t* table,
   return NULL;
 }
 
-/** Formats `number` in `base`, either 10 or 16. */
-static char* number_string(uint16_t number, int8_t base) {
-  static char result[7];
-  result[sizeof(result) - 1] = '\0';
-  index_t i = sizeof(result) - 1;
-  do {
-    const uint8_t digit = number % base;
-    number /= base;
-    result[--i] = (digit < 10) ? (char)(digit + UINT8_C('0'))
-                               : (char)(digit + (UINT8_C('A') - 10));
-  } while (number > 0 && i > 0);
+#ifdef KEYCODE_STRING_INDEX
+#if (KEYCODE_STRING_INDEX_SIZE & (KEYCODE_STRING_INDEX_SIZE - 1)) != 0 || \
+    KEYCODE_STRING_INDEX_SIZE > 256
+#error "KEYCODE_STRING_INDEX_SIZE must be a power of 2, at most 256."
+#endif
 
-  if (base == 16 && i >= 2) {
-    result[--i] = 'x';
-    result[--i] = '0';
+/**
+ * Hash index over the `custom_keycode_names` and `keycode_names` tables. Each
+ * slot holds 0 if empty, or 1 + the position of an entry in the two tables
+ * concatenated. Collisions are resolved by probing the following slots. The
+ * index is built on first use, since the tables may be in separate files.
+ */
+static uint8_t name_index[KEYCODE_STRING_INDEX_SIZE] = {0};
+static uint8_t num_custom_names = 0;
+// 0 if the index is not yet built, 1 if built, or -1 if the tables are too
+// large for the index, in which case the tables are searched linearly.
+static int8_t name_index_state = 0;
+
+static uint8_t name_index_hash(uint16_t keycode) {
+  // Fibonacci hashing: the high bits of the product are well mixed.
+  // Multiply in 32 bits; a uint16_t operand promotes to int and overflows.
+  return (uint16_t)((uint32_t)keycode * UINT32_C(40503)) >>
+         (16 - __builtin_ctz(KEYCODE_STRING_INDEX_SIZE));
+}
+
+static const keycode_string_name_t* name_index_entry(uint8_t value) {
+  return (value <= num_custom_names)
+             ? &custom_keycode_names[value - 1]
+             : &keycode_names[value - 1 - num_custom_names];
+}
+
+static void build_name_index(void) {
+  uint16_t num_custom = 0;
+  uint16_t num_builtin = 0;
+  while (custom_keycode_names[num_custom].keycode) {
+    ++num_custom;
+  }
+  while (keycode_names[num_builtin].keycode) {
+    ++num_builtin;
+  }
+  // Leave at least one slot empty so that probing terminates.
+  if (num_custom + num_builtin >= KEYCODE_STRING_INDEX_SIZE) {
+    dprintf("keycode_string: %u names don't fit KEYCODE_STRING_INDEX_SIZE %u, "
+            "searching linearly.\n",
+            num_custom + num_builtin, KEYCODE_STRING_INDEX_SIZE);
+    name_index_state = -1;
+    return;
+  }
+
+  num_custom_names = num_custom;
+  // Insert custom names first, so that they take precedence.
+  for (uint8_t value = 1; value <= num_custom + num_builtin; ++value) {
+    const uint16_t keycode = name_index_entry(value)->keycode;
+    uint8_t i = name_index_hash(keycode);
+    for (; name_index[i]; i = (i + 1) & (KEYCODE_STRING_INDEX_SIZE - 1)) {
+      if (name_index_entry(name_index[i])->keycode == keycode) {
+        break;  // Already has a name.
+      }
+    }
+    if (!name_index[i]) {
+      name_index[i] = value;
+    }
+  }
+  name_index_state = 1;
+}
+
+/** Finds the name of a keycode in either table with the index. */
+static const char* find_keycode_name_indexed(uint16_t keycode) {
+  for (uint8_t i = name_index_hash(keycode); name_index[i];
+       i = (i + 1) & (KEYCODE_STRING_INDEX_SIZE - 1)) {
+    const keycode_string_name_t* entry = name_index_entry(name_index[i]);
+    if (entry->keycode == keycode) {
+      return entry->name;
+    }
+  }
+  return NULL;
+}
+#endif  // KEYCODE_STRING_INDEX
+
+/** Appends a single char, if there is space. */
+static void append_char(char c) {
+  if (writer->put_char) {
+    writer->put_char(c);
+  } else if (writer->len < writer->max_len) {
+    writer->dest[writer->len] = c;
+    writer->dest[++writer->len] = '\0';
   }
-  return result + i;
 }
 
-/** Appends `str` to `buffer`, truncating if the result would overflow. */
+/** Appends `str`, truncating if the result would overflow. */
 static void append(const char* str) {
-  char* dest = buffer + buffer_len;
-  index_t i;
-  for (i = 0; buffer_len + i < BUFFER_MAX_LEN && str[i]; ++i) {
-    dest[i] = str[i];
+  writer_t* const w = writer;
+  if (w->put_char) {
+    for (; *str; ++str) {
+      w->put_char(*str);
+    }
+    return;
+  }
+
+  size_t len = w->len;
+  for (; len < w->max_len && *str; ++len, ++str) {
+    w->dest[len] = *str;
   }
-  buffer_len += i;
-  buffer[buffer_len] = '\0';
+  w->dest[len] = '\0';
+  w->len = len;
 }
 
 /** Same as append(), but where `str` is a PROGMEM string. */
 static void append_P(const char* str) {
-  char* dest = buffer + buffer_len;
-  index_t i;
-  for (i = 0; buffer_len + i < BUFFER_MAX_LEN; ++i) {
-    const char c = pgm_read_byte(&str[i]);
-    if (c == '\0') {
-      break;
+  writer_t* const w = writer;
+  char c;
+  if (w->put_char) {
+    for (; (c = pgm_read_byte(str)); ++str) {
+      w->put_char(c);
     }
-    dest[i] = c;
+    return;
   }
-  buffer_len += i;
-  buffer[buffer_len] = '\0';
-}
 
-/** Appends a single char to `buffer` if there is space. */
-static void append_char(char c) {
-  if (buffer_len < BUFFER_MAX_LEN) {
-    buffer[buffer_len] = c;
-    buffer[++buffer_len] = '\0';
+  size_t len = w->len;
+  for (; len < w->max_len && (c = pgm_read_byte(str)); ++len, ++str) {
+    w->dest[len] = c;
   }
+  w->dest[len] = '\0';
+  w->len = len;
 }
 
-/** Formats `number` in `base`, either 10 or 16, and appends it to `buffer`. */
+/** Formats `number` in `base`, either 10 or 16, and appends it. */
 static void append_number(uint16_t number, int8_t base) {
-  append(number_string(number, base));
+  char result[7];  // Formatted on the stack, so that calls may nest.
+  result[sizeof(result) - 1] = '\0';
+  index_t i = sizeof(result) - 1;
+  do {
+    const uint8_t digit = number % base;
+    number /= base;
+    result[--i] = (digit < 10) ? (char)(digit + UINT8_C('0'))
+                               : (char)(digit + (UINT8_C('A') - 10));
+  } while (number > 0 && i > 0);
+
+  if (base == 16 && i >= 2) {
+    result[--i] = 'x';
+    result[--i] = '0';
+  }
+  append(result + i);
 }
 
-/** Stringifies 5-bit mods and appends it to `buffer`. */
+/** Stringifies 5-bit mods and appends it. */
 static void append_5_bit_mods(uint8_t mods) {
   const bool is_rhs = mods > 15;
   mods &= 15;
@@ -179,27 +281,42 @@ static void append_5_bit_mods(uint8_t mods) {
 }
 
 /**
- * @brief Writes a keycode of the format `name` + "(" + `param` + ")".
- * @note `name` is a PROGMEM string, `param` is not.
+ * @brief Writes a keycode of the format `name` + "(" + `param` + ")", where
+ * `param` is formatted in `base`, either 10 or 16.
+ * @note `name` is a PROGMEM string.
  */
-static void append_unary_keycode(const char* name, const char* param) {
+static void append_unary_keycode(const char* name, uint16_t param,
+                                 int8_t base) {
   append_P(name);
   append_char('(');
-  append(param);
+  append_number(param, base);
   append_char(')');
 }
 
-/** Stringifies `keycode` and appends it to `buffer`. */
-static void append_keycode(uint16_t keycode) {
+/** Finds the name of `keycode` in the name tables, or returns NULL. */
+static const char* find_name(uint16_t keycode) {
+#ifdef KEYCODE_STRING_INDEX
+  if (name_index_state == 0) {
+    build_name_index();
+  }
+  if (name_index_state > 0) {
+    return find_keycode_name_indexed(keycode);
+  }
+#endif  // KEYCODE_STRING_INDEX
+
   // Search the `custom_keycode_names` table first so that it is possible to
   // override how any keycode would be formatted otherwise.
   const char* keycode_name = find_keycode_name(custom_keycode_names, keycode);
   if (keycode_name) {
-    append_P(keycode_name);
-    return;
+    return keycode_name;
   }
   // Search the `keycode_names` table.
-  keycode_name = find_keycode_name(keycode_names, keycode);
+  return find_keycode_name(keycode_names, keycode);
+}
+
+/** Stringifies `keycode` and appends it. */
+static void append_keycode(uint16_t keycode) {
+  const char* keycode_name = find_name(keycode);
   if (keycode_name) {
     append_P(keycode_name);
     return;
@@ -296,41 +413,35 @@ static void append_keycode(uint16_t keycode) {
       return;
 
     case QK_TO ... QK_TO_MAX:  // TO(layer) key.
-      append_unary_keycode(PSTR("TO"),
-                           number_string(QK_TO_GET_LAYER(keycode), 10));
+      append_unary_keycode(PSTR("TO"), QK_TO_GET_LAYER(keycode), 10);
       return;
 
     case QK_MOMENTARY ... QK_MOMENTARY_MAX:  // MO(layer) key.
-      append_unary_keycode(PSTR("MO"),
-                           number_string(QK_MOMENTARY_GET_LAYER(keycode), 10));
+      append_unary_keycode(PSTR("MO"), QK_MOMENTARY_GET_LAYER(keycode), 10);
       return;
 
     case QK_DEF_LAYER ... QK_DEF_LAYER_MAX:  // DF(layer) key.
-      append_unary_keycode(PSTR("DF"),
-                           number_string(QK_DEF_LAYER_GET_LAYER(keycode), 10));
+      append_unary_keycode(PSTR("DF"), QK_DEF_LAYER_GET_LAYER(keycode), 10);
       return;
 
     case QK_TOGGLE_LAYER ... QK_TOGGLE_LAYER_MAX:  // TG(layer) key.
-      append_unary_keycode(
-          PSTR("TG"), number_string(QK_TOGGLE_LAYER_GET_LAYER(keycode), 10));
+      append_unary_keycode(PSTR("TG"), QK_TOGGLE_LAYER_GET_LAYER(keycode), 10);
       return;
 
     case QK_ONE_SHOT_LAYER ... QK_ONE_SHOT_LAYER_MAX:  // OSL(layer) key.
-      append_unary_keycode(
-          PSTR("OSL"), number_string(QK_ONE_SHOT_LAYER_GET_LAYER(keycode), 10));
+      append_unary_keycode(PSTR("OSL"),
+                           QK_ONE_SHOT_LAYER_GET_LAYER(keycode), 10);
       return;
 
     case QK_LAYER_TAP_TOGGLE ... QK_LAYER_TAP_TOGGLE_MAX:  // TT(layer) key.
-      append_unary_keycode(
-          PSTR("TT"),
-          number_string(QK_LAYER_TAP_TOGGLE_GET_LAYER(keycode), 10));
+      append_unary_keycode(PSTR("TT"),
+                           QK_LAYER_TAP_TOGGLE_GET_LAYER(keycode), 10);
       return;
 
     // PDF(layer) key.
     case QK_PERSISTENT_DEF_LAYER ... QK_PERSISTENT_DEF_LAYER_MAX:
-      append_unary_keycode(
-          PSTR("PDF"),
-          number_string(QK_PERSISTENT_DEF_LAYER_GET_LAYER(keycode), 10));
+      append_unary_keycode(PSTR("PDF"),
+                           QK_PERSISTENT_DEF_LAYER_GET_LAYER(keycode), 10);
       return;
 
     // Mod-tap MT(mod,kc) key. This implementation formats the MT keys where
@@ -356,20 +467,17 @@ static void append_keycode(uint16_t keycode) {
 
 #ifdef TAP_DANCE_ENABLE
     case QK_TAP_DANCE ... QK_TAP_DANCE_MAX:  // Tap dance TD(i) key.
-      append_unary_keycode(PSTR("TD"),
-                           number_string(QK_TAP_DANCE_GET_INDEX(keycode), 10));
+      append_unary_keycode(PSTR("TD"), QK_TAP_DANCE_GET_INDEX(keycode), 10);
       return;
 #endif  // TAP_DANCE_ENABLE
 
 #ifdef UNICODE_ENABLE
     case QK_UNICODE ... QK_UNICODE_MAX:  // Unicode UC(codepoint) key.
-      append_unary_keycode(
-          PSTR("UC"), number_string(QK_UNICODE_GET_CODE_POINT(keycode), 16));
+      append_unary_keycode(PSTR("UC"), QK_UNICODE_GET_CODE_POINT(keycode), 16);
       return;
 #elif defined(UNICODEMAP_ENABLE)
     case QK_UNICODEMAP ... QK_UNICODEMAP_MAX:  // Unicode Map UM(i) key.
-      append_unary_keycode(PSTR("UM"),
-                           number_string(QK_UNICODEMAP_GET_INDEX(keycode), 10));
+      append_unary_keycode(PSTR("UM"), QK_UNICODEMAP_GET_INDEX(keycode), 10);
       return;
 
     case QK_UNICODEMAP_PAIR ... QK_UNICODEMAP_PAIR_MAX: {  // UP(i,j) key.
@@ -381,7 +489,7 @@ static void append_keycode(uint16_t keycode) {
       append_number(j, 10);
       append_char(')');
     }
-      return dest;
+      return;
 #endif
 
     case KB_KEYCODE_RANGE:  // Keyboard range keycode.
@@ -398,9 +506,30 @@ static void append_keycode(uint16_t keycode) {
   append_number(keycode, 16);  // Fallback: write keycode as hex value.
 }
 
-const char* keycode_string(uint16_t keycode) {
-  buffer_len = 0;
-  buffer[0] = '\0';
+/** Formats `keycode` with writer `w`. */
+static void write_keycode(uint16_t keycode, writer_t* w) {
+  writer_t* const saved = writer;
+  writer = w;
   append_keycode(keycode);
+  writer = saved;
+}
+
+const char* keycode_string(uint16_t keycode) {
+  keycode_string_to(keycode, buffer, sizeof(buffer));
   return buffer;
 }
+
+size_t keycode_string_to(uint16_t keycode, char* dest, size_t size) {
+  if (size == 0) {
+    return 0;
+  }
+  writer_t w = {dest, 0, size - 1, NULL};
+  dest[0] = '\0';
+  write_keycode(keycode, &w);
+  return w.len;
+}
+
+void keycode_string_write(uint16_t keycode, void (*put_char)(char)) {
+  writer_t w = {NULL, 0, 0, put_char};
+  write_keycode(keycode, &w);
+}
@@ -31,18 +31,35 @@
  *       return true;
  *     }
  *
+ * Keycode names from `custom_keycode_names` and the built-in table are found
+ * by searching the tables entry by entry. Optionally, define in config.h
+ *
+ *     #define KEYCODE_STRING_INDEX
+ *
+ * to instead find them with a hash index, built on first use, so that looking
+ * up a name takes about the same time however many names are defined. The
+ * index uses `KEYCODE_STRING_INDEX_SIZE` bytes of RAM, which must be greater
+ * than the total number of names. Otherwise the names are searched linearly,
+ * with a warning on the debug console.
+ *
  * For full documentation, see
  * <https://getreuer.info/posts/keyboards/keycode-string>
  */
 
 #pragma once
 
+#include <stddef.h>
 #include <stdint.h>
 
 #ifdef __cplusplus
 extern "C" {
 #endif
 
+/** Number of slots in the name index, a power of 2. */
+#ifndef KEYCODE_STRING_INDEX_SIZE
+#define KEYCODE_STRING_INDEX_SIZE 64
+#endif  // KEYCODE_STRING_INDEX_SIZE
+
 /**
  * @brief Formats a QMK keycode as a human-readable string.
  *
@@ -52,6 +69,8 @@ extern "C" {
  *
  * @note The returned char* string should be used right away. The string memory
  * is reused and will be overwritten by the next call to `keycode_string()`.
+ * To format into your own buffer or straight to an output, use
+ * `keycode_string_to()` or `keycode_string_write()`.
  *
  * Many common QMK keycodes are understood by this function, but not all.
  * Recognized keycodes include:
@@ -89,6 +108,38 @@ extern "C" {
  */
 const char* keycode_string(uint16_t keycode);
 
+/**
+ * @brief Formats a keycode into a caller-provided buffer.
+ *
+ * Same as `keycode_string()`, but writes the string to `dest`, truncating it
+ * if needed to fit in `size` bytes including the null terminator. Unlike
+ * `keycode_string()`, this function uses no static buffer, so several keycodes
+ * may be formatted for one message:
+ *
+ *     char tap[32];
+ *     char other[32];
+ *     keycode_string_to(tap_hold_keycode, tap, sizeof(tap));
+ *     keycode_string_to(other_keycode, other, sizeof(other));
+ *     xprintf("%s + %s\n", tap, other);
+ *
+ * @param keycode  QMK keycode.
+ * @param dest     Destination buffer.
+ * @param size     Size of `dest` in bytes.
+ * @return         Length of the string written, excluding the null terminator.
+ */
+size_t keycode_string_to(uint16_t keycode, char* dest, size_t size);
+
+/**
+ * @brief Formats a keycode, passing each char to `put_char`.
+ *
+ * Same as `keycode_string()`, but streams the string without a buffer, e.g. to
+ * the console. The string is not truncated, and no null terminator is passed.
+ *
+ * @param keycode   QMK keycode.
+ * @param put_char  Function to call with each char of the string.
+ */
+void keycode_string_write(uint16_t keycode, void (*put_char)(char));
+
 #define KEYCODE_STRING_NAME(kc) {(kc), PSTR(#kc)}
 #define KEYCODE_STRING_NAMES_END {0, NULL}
 
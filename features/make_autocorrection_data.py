@@ -29,6 +29,18 @@ dictionary. Or optionally specify the output .h file as well like
 
 $ python3 make_autocorrection_data.py dict.txt somewhere/out.h
 
+By default, branching trie nodes list their children to be scanned linearly.
+With the option --format=bitmap, branching nodes are instead serialized with a
+bitmap of their children, so that looking up a child takes constant time. This
+uses a few more bytes per branching node and requires defining
+AUTOCORRECTION_BITMAP_TRIE in config.h. Example:
+
+$ python3 make_autocorrection_data.py --format=bitmap autocorrection_dict.txt
+
+For large dictionaries, the option --compress shrinks the correction strings by
+replacing common substrings with tokens, which are expanded when a correction
+is sent. This is handled automatically by the C code.
+
 Each line of the dict file defines one typo and its correction with the syntax
 "typo -> correction". Blank lines or lines starting with '#' are ignored.
 Example:
@@ -46,10 +58,12 @@ For full documentation, see
 https://getreuer.info/posts/keyboards/autocorrection
 """
 
+import argparse
 import os.path
 import sys
 import textwrap
-from typing import Any, Dict, Iterator, List, Tuple
+from collections import Counter
+from typing import Any, Dict, Iterator, List, Optional, Tuple
 
 try:
   from english_words import english_words_lower_alpha_set as CORRECT_WORDS
@@ -67,6 +81,8 @@ except ImportError:
 KC_A = 4
 KC_SPC = 0x2c
 KC_QUOT = 0x34
+MAX_TOKENS = 128  # Tokens are encoded as bytes 128-255.
+MAX_TOKEN_LENGTH = 8
 
 TYPO_CHARS = dict(
   [
@@ -77,6 +93,15 @@ TYPO_CHARS = dict(
   [(chr(c), c + KC_A - ord('a')) for c in range(ord('a'), ord('z') + 1)]
 )
 
+# Bit index of each typo character in the child bitmaps of the bitmap format.
+BITMAP_INDEX = dict(
+  [(chr(c), c - ord('a')) for c in range(ord('a'), ord('z') + 1)] +
+  [
+    ("'", 26),
+    (':', 27),
+  ]
+)
+
 
 def parse_file(file_name: str) -> List[Tuple[str, str]]:
   """Parses autocorrections dictionary file.
@@ -186,13 +211,96 @@ def check_typo_against_dictionary(line_number: int, typo: str) -> None:
               f'on correctly spelled word "{word}".')
 
 
+def correction_suffix(typo: str, correction: str) -> Tuple[int, str]:
+  """Gets the backspaces and text to send to correct `typo` to `correction`."""
+  word_boundary_ending = typo[-1] == ':'
+  typo = typo.strip(':')
+  i = 0
+  while i < min(len(typo), len(correction)) and typo[i] == correction[i]:
+    i += 1
+  backspaces = len(typo) - i - 1 + word_boundary_ending
+  assert 0 <= backspaces <= 63
+  return backspaces, correction[i:]
+
+
+def make_tokens(autocorrections: List[Tuple[str, str]]) -> List[str]:
+  """Chooses substrings of the corrections to encode as tokens.
+
+  Substrings are chosen greedily by how many bytes they save, accounting for
+  the cost of storing them in the token table, until no substring saves bytes
+  or there are MAX_TOKENS tokens.
+
+  Args:
+    autocorrections: List of (typo, correction) tuples.
+  Returns:
+    List of token strings.
+  """
+  # Each correction is kept as a list of segments, where strings are not yet
+  # encoded and ints are tokens.
+  corrections = [[correction_suffix(typo, correction)[1]]
+                 for typo, correction in autocorrections]
+  tokens = []
+
+  while len(tokens) < MAX_TOKENS:
+    counts = Counter()
+    for segments in corrections:
+      for segment in segments:
+        if isinstance(segment, str):
+          for n in range(2, min(len(segment), MAX_TOKEN_LENGTH) + 1):
+            counts.update(segment[i:i + n]
+                          for i in range(len(segment) - n + 1))
+
+    def savings(substring: str) -> int:
+      return counts[substring] * (len(substring) - 1) - (len(substring) + 1)
+
+    best = max(sorted(counts), key=savings, default=None)
+    if best is None or savings(best) <= 0:
+      break
+
+    for segments in corrections:  # Replace occurrences of `best`.
+      replaced = []
+      for segment in segments:
+        if isinstance(segment, str):
+          parts = segment.split(best)
+          for part in parts[:-1]:
+            replaced += [part, len(tokens)] if part else [len(tokens)]
+          if parts[-1]:
+            replaced.append(parts[-1])
+        else:
+          replaced.append(segment)
+      segments[:] = replaced
+    tokens.append(best)
+
+  return tokens
+
+
+def encode_correction(correction: str,
+                      tokens: Optional[List[str]] = None) -> List[int]:
+  """Encodes `correction` with the fewest bytes, using `tokens` if given."""
+  tokens = tokens or []
+  # best[i] is the shortest encoding of correction[i:].
+  best = [[] for _ in range(len(correction) + 1)]
+  for i in range(len(correction) - 1, -1, -1):
+    best[i] = [ord(correction[i])] + best[i + 1]
+    for k, token in enumerate(tokens):
+      if (correction.startswith(token, i) and
+          1 + len(best[i + len(token)]) < len(best[i])):
+        best[i] = [128 + k] + best[i + len(token)]
+  assert all(b < 128 for b in bytes(correction, 'ascii'))
+  return best[0]
+
+
 def serialize_trie(autocorrections: List[Tuple[str, str]],
-                   trie: Dict[str, Any]) -> List[int]:
+                   trie: Dict[str, Any],
+                   bitmap: bool = False,
+                   tokens: Optional[List[str]] = None) -> List[int]:
   """Serializes trie and correction data in a form readable by the C code.
 
   Args:
     autocorrections: List of (typo, correction) tuples.
     trie: Dict of dicts.
+    bitmap: Bool, whether to serialize branch nodes in the bitmap format.
+    tokens: Optional list of token strings to compress corrections.
   Returns:
     List of ints in the range 0-255.
   """
@@ -201,16 +309,10 @@ def serialize_trie(autocorrections: List[Tuple[str, str]],
   # Traverse trie in depth first order.
   def traverse(trie_node: Dict[str, Any]) -> Dict[str, Any]:
     if 'LEAF' in trie_node:  # Handle a leaf trie node.
-      typo, correction = trie_node['LEAF']
-      word_boundary_ending = typo[-1] == ':'
-      typo = typo.strip(':')
-      i = 0  # Make the autocorrection data for this entry and serialize it.
-      while i < min(len(typo), len(correction)) and typo[i] == correction[i]:
-        i += 1
-      backspaces = len(typo) - i - 1 + word_boundary_ending
-      assert 0 <= backspaces <= 63
-      correction = correction[i:]
-      data = [backspaces + 128] + list(bytes(correction, 'ascii')) + [0]
+      # Make the autocorrection data for this entry and serialize it.
+      backspaces, correction = correction_suffix(*trie_node['LEAF'])
+      data = ([backspaces + 128] + encode_correction(correction, tokens) +
+              [0])
 
       entry = {'data': data, 'links': [], 'byte_offset': 0}
       table.append(entry)
@@ -227,7 +329,9 @@ def serialize_trie(autocorrections: List[Tuple[str, str]],
       table.append(entry)
       entry['links'] = [traverse(trie_node)]
     else:  # Handle trie node with multiple children.
-      entry = {'chars': ''.join(sorted(trie_node.keys())), 'byte_offset': 0}
+      chars = sorted(trie_node.keys(),
+                     key=(lambda c: BITMAP_INDEX[c]) if bitmap else None)
+      entry = {'chars': ''.join(chars), 'byte_offset': 0}
       table.append(entry)
       entry['links'] = [traverse(trie_node[c]) for c in entry['chars']]
     return entry
@@ -239,6 +343,14 @@ def serialize_trie(autocorrections: List[Tuple[str, str]],
       return e['data']
     elif len(e['links']) == 1:  # Handle a chain table entry.
       return [TYPO_CHARS[c] for c in e['chars']] + [0]
+    elif bitmap:  # Handle a branch table entry in the bitmap format.
+      # A 64 marker byte, a 32-bit little endian bitmap of which children are
+      # present, followed by the links to the children in bit order.
+      children = sum(1 << BITMAP_INDEX[c] for c in e['chars'])
+      data = [64] + [(children >> s) & 255 for s in (0, 8, 16, 24)]
+      for link in e['links']:
+        data += encode_link(link)
+      return data
     else:  # Handle a branch table entry.
       data = []
       for c, link in zip(e['chars'], e['links']):
@@ -265,15 +377,21 @@ def encode_link(link: Dict[str, Any]) -> List[int]:
 
 def write_generated_code(autocorrections: List[Tuple[str, str]],
                          data: List[int],
-                         file_name: str) -> None:
+                         file_name: str,
+                         bitmap: bool = False,
+                         tokens: Optional[List[str]] = None) -> None:
   """Writes autocorrection data as generated C code to `file_name`.
 
   Args:
     autocorrections: List of (typo, correction) tuples.
     data: List of ints in 0-255, the serialized trie.
     file_name: String, path of the output C file.
+    bitmap: Bool, whether `data` was serialized in the bitmap format.
+    tokens: Optional list of token strings that `data` was compressed with.
   """
   assert all(0 <= b <= 255 for b in data)
+  token_data = [b for token in tokens or []
+                for b in bytes(token, 'ascii') + b'\0']
 
   def typo_len(e: Tuple[str, str]) -> int:
     return len(e[0])
@@ -286,10 +404,24 @@ def write_generated_code(autocorrections: List[Tuple[str, str]],
     ''.join(sorted(f'//   {typo:<{len(max_typo)}} -> {correction}\n'
                    for typo, correction in autocorrections)),
     f'\n#define AUTOCORRECTION_MIN_LENGTH {len(min_typo)}  // "{min_typo}"\n',
-    f'#define AUTOCORRECTION_MAX_LENGTH {len(max_typo)}  // "{max_typo}"\n\n',
+    f'#define AUTOCORRECTION_MAX_LENGTH {len(max_typo)}  // "{max_typo}"\n',
+    '#define AUTOCORRECTION_DATA_BITMAP\n' if bitmap else '',
+    '#define AUTOCORRECTION_DATA_TOKENS\n' if token_data else '',
+    '\n',
     textwrap.fill('static const uint8_t autocorrection_data[%d] PROGMEM = {%s};' % (
       len(data), ', '.join(map(str, data))), width=80, subsequent_indent='  '),
     '\n\n'])
+  if token_data:
+    generated_code += ''.join([
+      f'// Tokens ({len(tokens)}), expanded when sending corrections:\n',
+      textwrap.fill('//   ' + ', '.join(f'"{t}"' for t in tokens), width=80,
+                    subsequent_indent='//   '),
+      '\n',
+      textwrap.fill(
+        'static const uint8_t autocorrection_tokens[%d] PROGMEM = {%s};' % (
+        len(token_data), ', '.join(map(str, token_data))),
+        width=80, subsequent_indent='  '),
+      '\n\n'])
 
   with open(file_name, 'wt') as f:
     f.write(generated_code)
@@ -300,15 +432,31 @@ def get_default_h_file(dict_file: str) -> str:
 
 
 def main(argv):
-  dict_file = argv[1] if len(argv) > 1 else 'autocorrection_dict.txt'
-  h_file = argv[2] if len(argv) > 2 else get_default_h_file(dict_file)
-
-  autocorrections = parse_file(dict_file)
+  parser = argparse.ArgumentParser(description=__doc__.split('\n')[0])
+  parser.add_argument('dict_file', nargs='?', default='autocorrection_dict.txt',
+                      help='Autocorrection dictionary file.')
+  parser.add_argument('h_file', nargs='?', help='Output .h file.')
+  parser.add_argument('--format', choices=('linear', 'bitmap'),
+                      default='linear', help='Branch node serialization.')
+  parser.add_argument('--compress', action='store_true',
+                      help='Compress corrections with a token table.')
+  args = parser.parse_args(argv[1:])
+  h_file = args.h_file or get_default_h_file(args.dict_file)
+  bitmap = args.format == 'bitmap'
+
+  autocorrections = parse_file(args.dict_file)
   trie = make_trie(autocorrections)
-  data = serialize_trie(autocorrections, trie)
-  print(f'Processed %d autocorrection entries to table with %d bytes.'
-        % (len(autocorrections), len(data)))
-  write_generated_code(autocorrections, data, h_file)
+  tokens = make_tokens(autocorrections) if args.compress else None
+  data = serialize_trie(autocorrections, trie, bitmap, tokens)
+  if tokens:
+    token_bytes = sum(len(token) + 1 for token in tokens)
+    print(f'Processed %d autocorrection entries to table with %d bytes and '
+          f'%d tokens with %d bytes.'
+          % (len(autocorrections), len(data), len(tokens), token_bytes))
+  else:
+    print(f'Processed %d autocorrection entries to table with %d bytes.'
+          % (len(autocorrections), len(data)))
+  write_generated_code(autocorrections, data, h_file, bitmap, tokens)
 
 
 if __name__ == '__main__':
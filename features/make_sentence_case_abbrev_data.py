@@ -0,0 +1,219 @@
+# Copyright 2025 Google LLC
+#
+# Licensed under the Apache License, Version 2.0 (the "License");
+# you may not use this file except in compliance with the License.
+# You may obtain a copy of the License at
+#
+#     https://www.apache.org/licenses/LICENSE-2.0
+#
+# Unless required by applicable law or agreed to in writing, software
+# distributed under the License is distributed on an "AS IS" BASIS,
+# WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+# See the License for the specific language governing permissions and
+# limitations under the License.
+
+"""Python program to make sentence_case_abbrev_data.h.
+
+This program reads "sentence_case_abbrev_dict.txt" from the current directory
+and generates a C source file "sentence_case_abbrev_data.h" with a serialized
+trie of abbreviations embedded as an array. Sentence Case walks the trie one
+key at a time to recognize abbreviations such as "Dr." that end with a period
+but don't end the sentence. Run this program without arguments like
+
+$ python3 make_sentence_case_abbrev_data.py
+
+Or specify a dict file as the first argument like
+
+$ python3 make_sentence_case_abbrev_data.py mykeymap/abbrev_dict.txt
+
+The output is written to "sentence_case_abbrev_data.h" in the same directory as
+the dictionary. Or optionally specify the output .h file as well like
+
+$ python3 make_sentence_case_abbrev_data.py abbrev_dict.txt somewhere/out.h
+
+Each line of the dict file defines one abbreviation, including the ending
+period. Abbreviations are matched case insensitively from the start of a word.
+They may contain letters, apostrophes, and periods. Blank lines or lines
+starting with '#' are ignored. Example:
+
+    dr.
+    e.g.
+    etc.
+    vs.
+
+To use the generated table, define SENTENCE_CASE_ABBREVIATIONS in config.h.
+
+For full documentation, see
+https://getreuer.info/posts/keyboards/sentence-case
+"""
+
+import argparse
+import os.path
+import sys
+import textwrap
+from typing import Any, Dict, Iterator, List, Tuple
+
+# Characters allowed in abbreviations, mapped to their QMK keycodes.
+ABBREV_CHARS = dict(
+  [(chr(ord('a') + i), 4 + i) for i in range(26)] +
+  [
+    ("'", 0x34),  # KC_QUOT
+    ('.', 0x37),  # KC_DOT
+  ]
+)
+
+
+def parse_file_lines(file_name: str) -> Iterator[Tuple[int, str]]:
+  """Parses lines read from `file_name` into abbreviations."""
+
+  line_number = 0
+  for line in open(file_name, 'rt'):
+    line_number += 1
+    line = line.strip()
+    if line and line[0] != '#':
+      yield line_number, line.lower()  # Force abbreviations to lowercase.
+
+
+def parse_file(file_name: str) -> List[str]:
+  """Parses abbreviations dictionary file.
+
+  The function validates that abbreviations only have characters in
+  ABBREV_CHARS and that they end with a period.
+
+  Args:
+    file_name: String, path of the abbreviations dictionary.
+  Returns:
+    List of abbreviation strings.
+  """
+
+  abbrevs = []
+  for line_number, abbrev in parse_file_lines(file_name):
+    if abbrev in abbrevs:
+      print(f'Warning:{line_number}: Ignoring duplicate abbreviation: '
+            f'"{abbrev}"')
+      continue
+    if not all(c in ABBREV_CHARS for c in abbrev):
+      print(f'Error:{line_number}: Abbreviation "{abbrev}" has '
+            'characters other than ' + ''.join(ABBREV_CHARS.keys()))
+      sys.exit(1)
+    if not abbrev.endswith('.') or abbrev == '.':
+      print(f'Error:{line_number}: Abbreviation "{abbrev}" must end with a '
+            'period.')
+      sys.exit(1)
+
+    abbrevs.append(abbrev)
+
+  return abbrevs
+
+
+def make_trie(abbrevs: List[str]) -> Dict[str, Any]:
+  """Makes a trie from the abbreviations, written forward.
+
+  Args:
+    abbrevs: List of abbreviation strings.
+  Returns:
+    Dict of dict, representing the trie.
+  """
+  trie = {}
+  for abbrev in abbrevs:
+    node = trie
+    for c in abbrev:
+      node = node.setdefault(c, {})
+    node['LEAF'] = True
+
+  return trie
+
+
+def serialize_trie(trie: Dict[str, Any]) -> List[int]:
+  """Serializes trie in a form readable by the C code.
+
+  Each node is serialized as a header byte, whose low 7 bits are the number of
+  children and whose high bit is set if an abbreviation ends at the node,
+  followed by 3 bytes for each child: the keycode and the 16-bit little endian
+  byte offset of the child node. The root node is at offset 0.
+
+  Args:
+    trie: Dict of dicts, the trie.
+  Returns:
+    List of ints in the range 0-255.
+  """
+  nodes = []
+
+  def traverse(trie_node: Dict[str, Any]) -> Dict[str, Any]:
+    children = sorted((c, child) for c, child in trie_node.items()
+                      if c != 'LEAF')
+    e = {'leaf': 'LEAF' in trie_node, 'links': []}
+    nodes.append(e)
+    e['links'] = [(c, traverse(child)) for c, child in children]
+    return e
+
+  traverse(trie)
+
+  byte_offset = 0
+  for e in nodes:
+    e['byte_offset'] = byte_offset
+    byte_offset += 1 + 3 * len(e['links'])
+  if byte_offset > 0xffff:
+    print('Error: The abbreviations table is too large, a node link exceeds '
+          '64KB limit. Try reducing the dict to fewer entries.')
+    sys.exit(1)
+
+  data = []
+  for e in nodes:
+    data.append(len(e['links']) | (128 if e['leaf'] else 0))
+    for c, child in e['links']:
+      offset = child['byte_offset']
+      data += [ABBREV_CHARS[c], offset & 255, offset >> 8]
+
+  return data
+
+
+def write_generated_code(abbrevs: List[str],
+                         data: List[int],
+                         file_name: str) -> None:
+  """Writes abbreviations data as generated C code to `file_name`.
+
+  Args:
+    abbrevs: List of abbreviation strings.
+    data: List of ints in 0-255, the serialized trie.
+    file_name: String, path of the output C file.
+  """
+  assert all(0 <= b <= 255 for b in data)
+  generated_code = ''.join([
+    '// Generated code.\n\n',
+    f'// Sentence Case abbreviations ({len(abbrevs)} entries):\n',
+    textwrap.fill('//   ' + ' '.join(sorted(abbrevs)), width=80,
+                  subsequent_indent='//   '),
+    '\n\n',
+    textwrap.fill(
+      'static const uint8_t sentence_case_abbrev_data[%d] PROGMEM = {%s};' % (
+      len(data), ', '.join(map(str, data))), width=80, subsequent_indent='  '),
+    '\n\n'])
+
+  with open(file_name, 'wt') as f:
+    f.write(generated_code)
+
+
+def get_default_h_file(dict_file: str) -> str:
+  return os.path.join(os.path.dirname(dict_file),
+                      'sentence_case_abbrev_data.h')
+
+
+def main(argv):
+  parser = argparse.ArgumentParser(description=__doc__.split('\n')[0])
+  parser.add_argument('dict_file', nargs='?',
+                      default='sentence_case_abbrev_dict.txt',
+                      help='Abbreviations dictionary file.')
+  parser.add_argument('h_file', nargs='?', help='Output .h file.')
+  args = parser.parse_args(argv[1:])
+  h_file = args.h_file or get_default_h_file(args.dict_file)
+
+  abbrevs = parse_file(args.dict_file)
+  data = serialize_trie(make_trie(abbrevs))
+  print(f'Processed %d abbreviations to table with %d bytes.'
+        % (len(abbrevs), len(data)))
+  write_generated_code(abbrevs, data, h_file)
+
+
+if __name__ == '__main__':
+  main(sys.argv)
@@ -48,6 +48,17 @@
 #define MOUSE_TURBO_CLICK_PERIOD 80
 #endif  // MOUSE_TURBO_CLICK_PERIOD
 
+#ifdef AUTOFIRE_ENABLE
+// With Autofire, clicks are sent by its shared pulse callback, which may also
+// be pulsing other keys.
+#include "autofire.h"
+
+static void turbo_click_start(void) {
+  autofire_start(MOUSE_TURBO_CLICK_KEY, MOUSE_TURBO_CLICK_PERIOD, 50);
+}
+
+static void turbo_click_stop(void) { autofire_stop(MOUSE_TURBO_CLICK_KEY); }
+#else
 static deferred_token click_token = INVALID_DEFERRED_TOKEN;
 static bool click_registered = false;
 
@@ -69,6 +80,11 @@ static void turbo_click_start(void) {
   if (click_token == INVALID_DEFERRED_TOKEN) {
     uint32_t next_delay_ms = turbo_click_callback(0, NULL);
     click_token = defer_exec(next_delay_ms, turbo_click_callback, NULL);
+    if (click_token == INVALID_DEFERRED_TOKEN && click_registered) {
+      // No deferred execution slot is free, so nothing would release it.
+      unregister_code16(MOUSE_TURBO_CLICK_KEY);
+      click_registered = false;
+    }
   }
 }
 
@@ -84,6 +100,7 @@ static void turbo_click_stop(void) {
     }
   }
 }
+#endif  // AUTOFIRE_ENABLE
 
 bool process_mouse_turbo_click(uint16_t keycode, keyrecord_t* record,
                                uint16_t turbo_click_keycode) {
@@ -31,6 +31,11 @@
  * @note Mouse keys and deferred execution must be enabled; in rules.mk set
  * `MOUSEKEY_ENABLE = yes` and `DEFERRED_EXEC_ENABLE = yes`.
  *
+ * If Autofire (features/autofire.h) is also in use, Turbo Click sends its
+ * clicks through Autofire's shared callback rather than its own. Enable this by
+ * adding `OPT_DEFS += -DAUTOFIRE_ENABLE` and `SRC += features/autofire.c` in
+ * rules.mk.
+ *
  * For full documentation, see
  * <https://getreuer.info/posts/keyboards/mouse-turbo-click>
  */
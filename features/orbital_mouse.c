@@ -46,10 +46,27 @@
 #ifndef ORBITAL_MOUSE_INTERVAL_MS
 #define ORBITAL_MOUSE_INTERVAL_MS 16
 #endif  // ORBITAL_MOUSE_INTERVAL_MS
+// Number of distinct heading directions: 64, 256, or 1024. With more angles,
+// slow turning reaches the directions in between the 64 angles of
+// `get_orbital_mouse_angle()`, for smoother motion at large radius or DPI.
+#ifndef ORBITAL_MOUSE_NUM_ANGLES
+#define ORBITAL_MOUSE_NUM_ANGLES 64
+#endif  // ORBITAL_MOUSE_NUM_ANGLES
+// Define ORBITAL_MOUSE_VARIABLE_RATE to send reports as often as every
+// ORBITAL_MOUSE_MIN_INTERVAL_MS, with motion computed from the elapsed time,
+// rather than once every ORBITAL_MOUSE_INTERVAL_MS. Speeds are the same in
+// both modes, as they are defined per ORBITAL_MOUSE_INTERVAL_MS.
+#ifndef ORBITAL_MOUSE_MIN_INTERVAL_MS
+#define ORBITAL_MOUSE_MIN_INTERVAL_MS 1
+#endif  // ORBITAL_MOUSE_MIN_INTERVAL_MS
 
 #if !(0 <= ORBITAL_MOUSE_RADIUS && ORBITAL_MOUSE_RADIUS <= 63)
 #error "Invalid ORBITAL_MOUSE_RADIUS. Value must be in [0, 63]."
 #endif
+#if !(ORBITAL_MOUSE_NUM_ANGLES == 64 || ORBITAL_MOUSE_NUM_ANGLES == 256 || \
+      ORBITAL_MOUSE_NUM_ANGLES == 1024)
+#error "Invalid ORBITAL_MOUSE_NUM_ANGLES. Value must be 64, 256, or 1024."
+#endif
 
 #if !defined(IS_MOUSE_KEYCODE)
 // Attempt to detect out-of-date QMK installation, which would fail with
@@ -60,6 +77,11 @@
 // is enabled. Enable the mouse in your rules.mk by setting:
 //   MOUSE_ENABLE = yes
 #error "orbital_mouse: Please set `MOUSE_ENABLE = yes` in rules.mk."
+#elif defined(ORBITAL_MOUSE_POINTING_DEVICE) && !defined(POINTING_DEVICE_ENABLE)
+// ORBITAL_MOUSE_POINTING_DEVICE merges into the pointing device report. Enable
+// the pointing device in your rules.mk by setting:
+//   POINTING_DEVICE_ENABLE = yes
+#error "orbital_mouse: Please set `POINTING_DEVICE_ENABLE = yes` in rules.mk."
 #else
 
 enum {
@@ -95,26 +117,51 @@ enum {
   HELD_W_R = 128,
 };
 
+#ifdef ORBITAL_MOUSE_VARIABLE_RATE
+// Movement accumulators count in units of 1 / ORBITAL_MOUSE_INTERVAL_MS of
+// the fixed rate units, so that motion over any whole number of milliseconds
+// adds up exactly.
+typedef int32_t accum_t;
+#define ACCUM_SCALE (ORBITAL_MOUSE_INTERVAL_MS)
+#else
+typedef int16_t accum_t;
+#define ACCUM_SCALE 1
+#endif  // ORBITAL_MOUSE_VARIABLE_RATE
+
 static const uint8_t init_speed_curve[NUM_SPEED_CURVE_INTERVALS] =
   ORBITAL_MOUSE_SPEED_CURVE;
 static struct {
   report_mouse_t report;
   // Current speed curve, should point to a table of 16 values.
   const uint8_t* speed_curve;
-  // Time when the Orbital Mouse task function should next run.
+  // Time when the Orbital Mouse task function should next run, or with
+  // ORBITAL_MOUSE_VARIABLE_RATE, when it last ran. Zero while asleep.
   uint16_t timer;
-  // Fractional displacement of the cursor as Q7.8 values.
-  int16_t x;
-  int16_t y;
-  // Fractional displacement of the mouse wheel as Q9.6 values.
-  int16_t wheel_x;
-  int16_t wheel_y;
+  // Fractional displacement of the cursor as Q7.8 values, times ACCUM_SCALE.
+  accum_t x;
+  accum_t y;
+  // Fractional displacement of the mouse wheel as Q9.6 values, times
+  // ACCUM_SCALE.
+  accum_t wheel_x;
+  accum_t wheel_y;
   // Current cursor movement speed as a Q9.6 value.
   int16_t speed;
   // Bitfield tracking which movement keys are currently held.
   uint8_t held_keys;
+#ifdef ORBITAL_MOUSE_VARIABLE_RATE
+  // Cursor movement time in milliseconds.
+  uint16_t move_t;
+  // Time toward the next double click step in milliseconds.
+  uint8_t double_click_ms;
+#else
   // Cursor movement time, counted in number of intervals.
   uint8_t move_t;
+#endif  // ORBITAL_MOUSE_VARIABLE_RATE
+#if defined(ORBITAL_MOUSE_VARIABLE_RATE) || \
+    defined(ORBITAL_MOUSE_POINTING_DEVICE)
+  // Buttons in the last sent or merged report.
+  uint8_t sent_buttons;
+#endif
   // Cursor movement direction, 1 => forward, -1 => backward.
   int8_t move_dir;
   // Steering direction, 1 => counter-clockwise, -1 => clockwise.
@@ -130,7 +177,19 @@ static struct {
   uint8_t double_click_frame;
   // When true, movement and turning are slower.
   bool slow;
-} state = {.speed_curve = init_speed_curve};
+#if ORBITAL_MOUSE_NUM_ANGLES > 64
+  // Sine and cosine of the heading as Q1.14 values, updated when it changes.
+  int16_t heading_sin;
+  int16_t heading_cos;
+#endif  // ORBITAL_MOUSE_NUM_ANGLES > 64
+} state = {
+    .speed_curve = init_speed_curve,
+#if ORBITAL_MOUSE_NUM_ANGLES > 64
+    .heading_cos = 16384,
+#endif  // ORBITAL_MOUSE_NUM_ANGLES > 64
+};
+
+#if ORBITAL_MOUSE_NUM_ANGLES == 64
 
 /**
  * Fixed-point sine with specified amplitude and phase.
@@ -156,10 +215,91 @@ static int16_t scaled_cos(uint8_t amplitude, uint8_t phase) {
   return scaled_sin(amplitude, phase + (NUM_ANGLES / 4));
 }
 
+/** Horizontal component of the heading with length `amplitude`. */
+static int16_t heading_x(uint8_t amplitude) {
+  return scaled_sin(amplitude, state.angle >> 8);
+}
+
+/** Vertical component of the heading with length `amplitude`. */
+static int16_t heading_y(uint8_t amplitude) {
+  return scaled_cos(amplitude, state.angle >> 8);
+}
+
+static void update_heading(void) {}
+#else
+// Right shift from `state.angle` to an index in [0, ORBITAL_MOUSE_NUM_ANGLES).
+#define ANGLE_SHIFT (ORBITAL_MOUSE_NUM_ANGLES == 1024 ? 4 : 6)
+// Right shift from a quarter turn of angles to an index in the sine table.
+#define SIN_LUT_SHIFT (ORBITAL_MOUSE_NUM_ANGLES == 1024 ? 2 : 0)
+
+/**
+ * Fixed-point sine.
+ *
+ * @param phase Value in [0, ORBITAL_MOUSE_NUM_ANGLES - 1].
+ * @returns Result as a Q1.14 value.
+ */
+static int16_t sin_q1_14(uint16_t phase) {
+  enum { QUARTER = ORBITAL_MOUSE_NUM_ANGLES / 4 };
+  // Look up table covers a quarter cycle of a sine wave, at 1/256 turn steps
+  // from 0 to 1/4 turn inclusive. Finer angles are linearly interpolated.
+  static const uint16_t lut[65] PROGMEM = {
+      0,     402,   804,   1205,  1606,  2006,  2404,  2801,  3196,  3590,
+      3981,  4370,  4756,  5139,  5520,  5897,  6270,  6639,  7005,  7366,
+      7723,  8076,  8423,  8765,  9102,  9434,  9760,  10080, 10394, 10702,
+      11003, 11297, 11585, 11866, 12140, 12406, 12665, 12916, 13160, 13395,
+      13623, 13842, 14053, 14256, 14449, 14635, 14811, 14978, 15137, 15286,
+      15426, 15557, 15679, 15791, 15893, 15986, 16069, 16143, 16207, 16261,
+      16305, 16340, 16364, 16379, 16384};
+  uint16_t r = phase & (QUARTER - 1);
+  if (phase & QUARTER) {  // Mirror in the second and fourth quarters.
+    r = QUARTER - r;
+  }
+  const uint8_t i = r >> SIN_LUT_SHIFT;
+  int16_t value = pgm_read_word(lut + i);
+#if SIN_LUT_SHIFT > 0
+  const uint8_t frac = r & ((1 << SIN_LUT_SHIFT) - 1);
+  if (frac) {
+    value += ((int16_t)pgm_read_word(lut + i + 1) - value) * frac
+             >> SIN_LUT_SHIFT;
+  }
+#endif  // SIN_LUT_SHIFT > 0
+  return (phase & (2 * QUARTER)) ? -value : value;
+}
+
+/** Scales Q1.14 `value` by Q6.2 `amplitude`, returning a Q6.8 value. */
+static int16_t scale_q1_14(uint8_t amplitude, int16_t value) {
+  return (int16_t)(((int32_t)amplitude * value + 128) >> 8);
+}
+
+/** Horizontal component of the heading with length `amplitude`. */
+static int16_t heading_x(uint8_t amplitude) {
+  return scale_q1_14(amplitude, state.heading_sin);
+}
+
+/** Vertical component of the heading with length `amplitude`. */
+static int16_t heading_y(uint8_t amplitude) {
+  return scale_q1_14(amplitude, state.heading_cos);
+}
+
+/** Updates the cached sine and cosine after the heading changes. */
+static void update_heading(void) {
+  const uint16_t phase =
+      (state.angle >> ANGLE_SHIFT) & (ORBITAL_MOUSE_NUM_ANGLES - 1);
+  state.heading_sin = sin_q1_14(phase);
+  state.heading_cos = sin_q1_14((phase + ORBITAL_MOUSE_NUM_ANGLES / 4) &
+                                (ORBITAL_MOUSE_NUM_ANGLES - 1));
+}
+#endif  // ORBITAL_MOUSE_NUM_ANGLES == 64
+
 /** Wakes the Orbital Mouse task.  */
 static void wake_orbital_mouse_task(void) {
   if (!state.timer) {
+#ifdef ORBITAL_MOUSE_VARIABLE_RATE
+    const uint16_t now = timer_read();
+    state.timer = now ? now : 1;
+#else
     state.timer = timer_read() | 1;
+#endif  // ORBITAL_MOUSE_VARIABLE_RATE
   }
 }
 
@@ -215,11 +355,12 @@ uint8_t get_orbital_mouse_angle(void) {
 }
 
 static void set_orbital_mouse_angle_fractional(uint16_t angle) {
-  state.x += scaled_sin(RADIUS_Q6_2, state.angle >> 8);
-  state.y += scaled_cos(RADIUS_Q6_2, state.angle >> 8);
+  state.x += (accum_t)heading_x(RADIUS_Q6_2) * ACCUM_SCALE;
+  state.y += (accum_t)heading_y(RADIUS_Q6_2) * ACCUM_SCALE;
   state.angle = angle;
-  state.x -= scaled_sin(RADIUS_Q6_2, angle >> 8);
-  state.y -= scaled_cos(RADIUS_Q6_2, angle >> 8);
+  update_heading();
+  state.x -= (accum_t)heading_x(RADIUS_Q6_2) * ACCUM_SCALE;
+  state.y -= (accum_t)heading_y(RADIUS_Q6_2) * ACCUM_SCALE;
   wake_orbital_mouse_task();
 }
 
@@ -263,6 +404,9 @@ bool process_orbital_mouse(uint16_t keycode, keyrecord_t* record) {
       case OM_DBLS:
         if (record->event.pressed) {
           state.double_click_frame = 1;
+#ifdef ORBITAL_MOUSE_VARIABLE_RATE
+          state.double_click_ms = 0;
+#endif  // ORBITAL_MOUSE_VARIABLE_RATE
         }
         break;
       case OM_SLOW:
@@ -292,16 +436,74 @@ bool process_orbital_mouse(uint16_t keycode, keyrecord_t* record) {
   return false;
 }
 
+#ifdef ORBITAL_MOUSE_VARIABLE_RATE
+/**
+ * Speed after moving for `t` ms as a Q9.6 value, interpolated from the speed
+ * curve the same as when advancing one interval at a time.
+ */
+static int16_t speed_at_time(uint16_t t) {
+  enum { CURVE_INTERVAL_MS = 16 * (ORBITAL_MOUSE_INTERVAL_MS) };
+  const uint8_t i = t / CURVE_INTERVAL_MS;
+  if (i >= NUM_SPEED_CURVE_INTERVALS - 1) {
+    return (int16_t)state.speed_curve[NUM_SPEED_CURVE_INTERVALS - 1] * 16;
+  }
+  const int16_t r = t % CURVE_INTERVAL_MS;
+  return (int16_t)state.speed_curve[i] * 16 +
+         (int16_t)((int32_t)r *
+                   ((int16_t)state.speed_curve[i + 1] -
+                    (int16_t)state.speed_curve[i]) /
+                   (ORBITAL_MOUSE_INTERVAL_MS));
+}
+#endif  // ORBITAL_MOUSE_VARIABLE_RATE
+
+/** Advances the double click action by one interval. */
+static void step_double_click(void) {
+  ++state.double_click_frame;
+  const uint8_t mask = 1 << state.selected_button;
+  switch (state.double_click_frame) {
+    case 2:
+    case 3:
+    case 4 + DOUBLE_CLICK_DELAY_INTERVALS:
+      state.report.buttons ^= mask;
+      break;
+    case 5 + DOUBLE_CLICK_DELAY_INTERVALS:
+      state.report.buttons &= ~mask;
+      state.double_click_frame = 0;
+  }
+}
+
 void orbital_mouse_task(void) {
+  if (!state.timer) {
+    return;  // Asleep.
+  }
   const uint16_t now = timer_read();
-  if (!state.timer || !timer_expired(now, state.timer)) {
+#ifdef ORBITAL_MOUSE_VARIABLE_RATE
+  // Elapsed time since the last frame, capped to avoid a jump after a stall.
+  uint16_t dt = now - state.timer;
+  if (dt < ORBITAL_MOUSE_MIN_INTERVAL_MS) {
+    return;
+  } else if (dt > 2 * (ORBITAL_MOUSE_INTERVAL_MS)) {
+    dt = 2 * (ORBITAL_MOUSE_INTERVAL_MS);
+  }
+#else
+  if (!timer_expired(now, state.timer)) {
     return;
   }
+  // Each frame is one interval.
+  const uint8_t dt = 1;
+#endif  // ORBITAL_MOUSE_VARIABLE_RATE
 
   bool active = false;
 
   // Update position if moving.
   if (state.move_dir) {
+#ifdef ORBITAL_MOUSE_VARIABLE_RATE
+    state.speed = speed_at_time(state.move_t);
+    if (state.move_t < 16 * (NUM_SPEED_CURVE_INTERVALS - 1) *
+                           (ORBITAL_MOUSE_INTERVAL_MS)) {
+      state.move_t += dt;
+    }
+#else
     // Update speed, interpolated from speed_curve.
     if (state.move_t <= 16 * (NUM_SPEED_CURVE_INTERVALS - 1)) {
       if (state.move_t == 0) {
@@ -314,20 +516,24 @@ void orbital_mouse_task(void) {
 
       ++state.move_t;
     }
+#endif  // ORBITAL_MOUSE_VARIABLE_RATE
     // Round and cast from Q9.6 to Q6.2.
     uint8_t speed = (state.speed + 8) / 16;
     if (state.slow) {
       speed = ((uint16_t)speed) * (1 + (uint16_t)SLOW_MOVE_FACTOR_Q_8) >> 8;
     }
 
-    state.x -= state.move_dir * scaled_sin(speed, state.angle >> 8);
-    state.y -= state.move_dir * scaled_cos(speed, state.angle >> 8);
+    state.x -= state.move_dir * (accum_t)heading_x(speed) * dt;
+    state.y -= state.move_dir * (accum_t)heading_y(speed) * dt;
     active = true;
   }
 
   // Update heading angle if steering.
   if (state.steer_dir) {
     int16_t angle_step = state.slow ? SLOW_TURN_FACTOR_Q_8 : 256;
+#ifdef ORBITAL_MOUSE_VARIABLE_RATE
+    angle_step = angle_step * dt / (ORBITAL_MOUSE_INTERVAL_MS);
+#endif  // ORBITAL_MOUSE_VARIABLE_RATE
     if (state.steer_dir == -1) {
       angle_step = -angle_step;
     }
@@ -337,42 +543,99 @@ void orbital_mouse_task(void) {
 
   // Update mouse wheel if active.
   if (state.wheel_x_dir || state.wheel_y_dir) {
-    state.wheel_x -= state.wheel_x_dir * WHEEL_SPEED_Q2_6;
-    state.wheel_y += state.wheel_y_dir * WHEEL_SPEED_Q2_6;
+    state.wheel_x -= state.wheel_x_dir * (accum_t)WHEEL_SPEED_Q2_6 * dt;
+    state.wheel_y += state.wheel_y_dir * (accum_t)WHEEL_SPEED_Q2_6 * dt;
     active = true;
   }
 
-  // Update double click action.
+  // Update double click action, stepping once per interval.
   if (state.double_click_frame) {
-    ++state.double_click_frame;
-    const uint8_t mask = 1 << state.selected_button;
-    switch (state.double_click_frame) {
-      case 2:
-      case 3:
-      case 4 + DOUBLE_CLICK_DELAY_INTERVALS:
-        state.report.buttons ^= mask;
-        break;
-      case 5 + DOUBLE_CLICK_DELAY_INTERVALS:
-        state.report.buttons &= ~mask;
-        state.double_click_frame = 0;
+#ifdef ORBITAL_MOUSE_VARIABLE_RATE
+    state.double_click_ms += dt;
+    if (state.double_click_ms >= ORBITAL_MOUSE_INTERVAL_MS) {
+      state.double_click_ms -= ORBITAL_MOUSE_INTERVAL_MS;
+      step_double_click();
     }
+#else
+    step_double_click();
+#endif  // ORBITAL_MOUSE_VARIABLE_RATE
     active = true;
   }
 
   // Schedule when task should run again, or go to sleep if inactive.
+#ifdef ORBITAL_MOUSE_VARIABLE_RATE
+  state.timer = active ? (now ? now : 1) : 0;
+#else
   state.timer = active ? ((now + ORBITAL_MOUSE_INTERVAL_MS) | 1) : 0;
+#endif  // ORBITAL_MOUSE_VARIABLE_RATE
 
+#ifdef ORBITAL_MOUSE_POINTING_DEVICE
+  // Movement is merged into the pointing device's report instead, by
+  // orbital_mouse_pointing_device_task().
+#else
   // Set whole part of movement deltas in report and retain fractional parts.
-  state.report.x = state.x / 256;
-  state.report.y = state.y / 256;
-  state.x -= (int16_t)state.report.x * 256;
-  state.y -= (int16_t)state.report.y * 256;
-  state.report.h = state.wheel_x / 64;
-  state.report.v = state.wheel_y / 64;
-  state.wheel_x -= (int16_t)state.report.h * 64;
-  state.wheel_y -= (int16_t)state.report.v * 64;
+  state.report.x = state.x / (256 * ACCUM_SCALE);
+  state.report.y = state.y / (256 * ACCUM_SCALE);
+  state.x -= (accum_t)state.report.x * (256 * ACCUM_SCALE);
+  state.y -= (accum_t)state.report.y * (256 * ACCUM_SCALE);
+  state.report.h = state.wheel_x / (64 * ACCUM_SCALE);
+  state.report.v = state.wheel_y / (64 * ACCUM_SCALE);
+  state.wheel_x -= (accum_t)state.report.h * (64 * ACCUM_SCALE);
+  state.wheel_y -= (accum_t)state.report.v * (64 * ACCUM_SCALE);
+#ifdef ORBITAL_MOUSE_VARIABLE_RATE
+  // At high rates, most frames move less than a whole pixel. Send only
+  // reports that change something.
+  if (!state.report.x && !state.report.y && !state.report.h &&
+      !state.report.v && state.report.buttons == state.sent_buttons) {
+    return;
+  }
+  state.sent_buttons = state.report.buttons;
+#endif  // ORBITAL_MOUSE_VARIABLE_RATE
   host_mouse_send(&state.report);
+#endif  // ORBITAL_MOUSE_POINTING_DEVICE
+}
+
+#ifdef ORBITAL_MOUSE_POINTING_DEVICE
+#ifdef MOUSE_EXTENDED_REPORT
+#define REPORT_XY_MAX INT16_MAX
+#else
+#define REPORT_XY_MAX INT8_MAX
+#endif  // MOUSE_EXTENDED_REPORT
+
+/**
+ * Adds the whole part of `*accum` (in units of `unit`) to `value`, clamped to
+ * [-limit, limit], and removes what was added from `*accum`.
+ */
+static int16_t merge_delta(int16_t value, accum_t* accum, accum_t unit,
+                           int16_t limit) {
+  int32_t sum = (int32_t)value + *accum / unit;
+  if (sum > limit) {
+    sum = limit;
+  } else if (sum < -limit) {
+    sum = -limit;
+  }
+  *accum -= (accum_t)(sum - value) * unit;
+  return (int16_t)sum;
+}
+
+report_mouse_t orbital_mouse_pointing_device_task(report_mouse_t mouse_report) {
+  // What doesn't fit in the report is kept for the next one.
+  mouse_report.x =
+      merge_delta(mouse_report.x, &state.x, 256 * ACCUM_SCALE, REPORT_XY_MAX);
+  mouse_report.y =
+      merge_delta(mouse_report.y, &state.y, 256 * ACCUM_SCALE, REPORT_XY_MAX);
+  mouse_report.h =
+      merge_delta(mouse_report.h, &state.wheel_x, 64 * ACCUM_SCALE, INT8_MAX);
+  mouse_report.v =
+      merge_delta(mouse_report.v, &state.wheel_y, 64 * ACCUM_SCALE, INT8_MAX);
+  // QMK keeps the buttons from one report to the next, so replace the buttons
+  // merged last time rather than only adding to them.
+  mouse_report.buttons =
+      (mouse_report.buttons & ~state.sent_buttons) | state.report.buttons;
+  state.sent_buttons = state.report.buttons;
+  return mouse_report;
 }
+#endif  // ORBITAL_MOUSE_POINTING_DEVICE
 
 #endif
 
@@ -72,6 +72,26 @@ bool process_orbital_mouse(uint16_t keycode, keyrecord_t* record);
  */
 void orbital_mouse_task(void);
 
+#ifdef ORBITAL_MOUSE_POINTING_DEVICE
+/**
+ * Merges Orbital Mouse into the pointing device report.
+ *
+ * On a keyboard with a pointing device, such as a trackball, Orbital Mouse and
+ * the pointing device would otherwise each send their own reports. With
+ * `ORBITAL_MOUSE_POINTING_DEVICE` defined in config.h, `orbital_mouse_task()`
+ * no longer sends reports. Instead, its movement and buttons are added to the
+ * pointing device's report, so that one report is sent per frame. Call this
+ * function from `pointing_device_task_user()` in keymap.c:
+ *
+ *     report_mouse_t pointing_device_task_user(report_mouse_t mouse_report) {
+ *       return orbital_mouse_pointing_device_task(mouse_report);
+ *     }
+ *
+ * Continue to call `orbital_mouse_task()` from `housekeeping_task_user()`.
+ */
+report_mouse_t orbital_mouse_pointing_device_task(report_mouse_t mouse_report);
+#endif  // ORBITAL_MOUSE_POINTING_DEVICE
+
 /**
  * Sets the pointer movement speed curve at run time.
  *
@@ -0,0 +1,148 @@
+// Copyright 2025 Google LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     https://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+/**
+ * @file profiler.c
+ * @brief Profiler implementation
+ */
+
+#include "profiler.h"
+
+#include <string.h>
+
+#include "print.h"
+
+#if defined(__ARM_ARCH_7M__) || defined(__ARM_ARCH_7EM__) || \
+    defined(__ARM_ARCH_8M_MAIN__)
+// Data Watchpoint and Trace (DWT) registers. These are defined by CMSIS as
+// well, but are spelled out here to avoid depending on a particular CMSIS
+// header being included by the platform.
+#define PROFILER_DEMCR (*(volatile uint32_t*)0xE000EDFC)
+#define PROFILER_DWT_CTRL (*(volatile uint32_t*)0xE0001000)
+#define PROFILER_DWT_CYCCNT (*(volatile uint32_t*)0xE0001004)
+#define PROFILER_DWT_LAR (*(volatile uint32_t*)0xE0001FB0)
+#define PROFILER_UNITS "cycles"
+
+uint32_t profiler_read_cycles(void) {
+  if (!(PROFILER_DWT_CTRL & 1)) {  // Enable the cycle counter on first use.
+    PROFILER_DEMCR |= UINT32_C(1) << 24;  // TRCENA.
+    PROFILER_DWT_LAR = 0xC5ACCE55;  // Unlock, needed on some Cortex-M7.
+    PROFILER_DWT_CYCCNT = 0;
+    PROFILER_DWT_CTRL |= 1;  // CYCCNTENA.
+  }
+  return PROFILER_DWT_CYCCNT;
+}
+
+#elif defined(__AVR__)
+#include <avr/io.h>
+
+// QMK's AVR timer counts milliseconds with Timer0 in CTC mode. Within each
+// millisecond, TCNT0 counts up in steps of the prescaler.
+#ifndef PROFILER_AVR_TIMER_PRESCALER
+#define PROFILER_AVR_TIMER_PRESCALER 64
+#endif  // PROFILER_AVR_TIMER_PRESCALER
+#define PROFILER_UNITS "cycles"
+
+uint32_t profiler_read_cycles(void) {
+  uint32_t ms;
+  uint8_t count;
+  do {  // Retry if the millisecond ticked between the reads.
+    ms = timer_read32();
+    count = TCNT0;
+  } while (ms != timer_read32());
+  return ms * (F_CPU / 1000) + (uint32_t)count * PROFILER_AVR_TIMER_PRESCALER;
+}
+
+#else
+#define PROFILER_UNITS "ms"
+
+uint32_t profiler_read_cycles(void) { return timer_read32(); }
+#endif
+
+typedef struct {
+  uint32_t count;
+  uint32_t min;
+  uint32_t max;
+  uint64_t sum;
+  uint16_t histogram[PROFILER_HISTOGRAM_BINS];
+} profiler_stats_t;
+
+static profiler_stats_t stats[PROFILER_MAX_IDS];
+
+__attribute__((weak)) const char* profiler_id_name_user(uint8_t id) {
+  return NULL;
+}
+
+// Returns the histogram bin for `cycles`: the bit length, clamped to the
+// number of bins.
+static uint8_t histogram_bin(uint32_t cycles) {
+  uint8_t bin = 0;
+  while (cycles && bin < PROFILER_HISTOGRAM_BINS - 1) {
+    cycles >>= 1;
+    ++bin;
+  }
+  return bin;
+}
+
+void profiler_record(uint8_t id, uint32_t start_cycles) {
+  const uint32_t cycles = profiler_read_cycles() - start_cycles;
+  if (id >= PROFILER_MAX_IDS) { return; }
+  profiler_stats_t* s = &stats[id];
+
+  if (s->count == 0 || cycles < s->min) { s->min = cycles; }
+  if (cycles > s->max) { s->max = cycles; }
+  ++s->count;
+  s->sum += cycles;
+
+  uint16_t* bin = &s->histogram[histogram_bin(cycles)];
+  if (*bin < UINT16_MAX) { ++*bin; }
+}
+
+void profiler_reset(void) { memset(stats, 0, sizeof(stats)); }
+
+void profiler_print(void) {
+  xprintf("Profiler (" PROFILER_UNITS "):\n");
+  xprintf("%-24s %8s %8s %8s %8s\n", "id", "count", "min", "mean", "max");
+
+  for (uint8_t id = 0; id < PROFILER_MAX_IDS; ++id) {
+    const profiler_stats_t* s = &stats[id];
+    if (s->count == 0) { continue; }
+
+    const char* name = profiler_id_name_user(id);
+    if (name) {
+      xprintf("%-24s ", name);
+    } else {
+      xprintf("%-24u ", id);
+    }
+    xprintf("%8lu %8lu %8lu %8lu\n", (unsigned long)s->count,
+            (unsigned long)s->min, (unsigned long)(s->sum / s->count),
+            (unsigned long)s->max);
+
+    // Print the histogram, with a bar scaled to the largest bin.
+    uint16_t largest = 1;
+    for (uint8_t k = 0; k < PROFILER_HISTOGRAM_BINS; ++k) {
+      if (s->histogram[k] > largest) { largest = s->histogram[k]; }
+    }
+    for (uint8_t k = 0; k < PROFILER_HISTOGRAM_BINS; ++k) {
+      const uint16_t n = s->histogram[k];
+      if (n == 0) { continue; }
+      const uint32_t lo = k ? (UINT32_C(1) << (k - 1)) : 0;
+      xprintf("  >= %-10lu %5u ", (unsigned long)lo, n);
+      for (uint8_t i = (uint8_t)((UINT32_C(32) * n) / largest); i; --i) {
+        xprintf("#");
+      }
+      xprintf("\n");
+    }
+  }
+}
@@ -0,0 +1,147 @@
+// Copyright 2025 Google LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     https://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+/**
+ * @file profiler.h
+ * @brief Profiler: measure cycles spent in keymap handlers and tasks.
+ *
+ * Overview
+ * --------
+ *
+ * This library is a lightweight profiler to find out which parts of a keymap
+ * are slow. Calls are timed with a hardware cycle counter, and for each
+ * profiled call site ("id"), the profiler keeps the count, min, max, and mean
+ * of the cycles spent and a histogram on a log2 scale. The statistics are
+ * printed to the console on request.
+ *
+ * The cycle counter is:
+ *
+ *  * ARM Cortex-M3, M4, M7, M33: the DWT cycle counter (DWT CYCCNT).
+ *
+ *  * AVR: the QMK millisecond timer combined with the Timer0 count register.
+ *    Resolution is the Timer0 prescaler, 64 cycles by default.
+ *
+ *  * Otherwise: the QMK millisecond timer, which is only useful to find
+ *    grossly slow calls.
+ *
+ * Step 1: In your keymap.c, define ids for the call sites to be profiled and
+ * optionally give them names for printing:
+ *
+ *     #include "features/profiler.h"
+ *
+ *     enum { PROF_ACHORDION, PROF_ACHORDION_TASK };
+ *
+ *     const char* profiler_id_name_user(uint8_t id) {
+ *       switch (id) {
+ *         case PROF_ACHORDION: return "process_achordion";
+ *         case PROF_ACHORDION_TASK: return "achordion_task";
+ *       }
+ *       return NULL;
+ *     }
+ *
+ * Step 2: Wrap the calls to profile with `PROFILER_CALL()` or
+ * `PROFILER_TIME()`:
+ *
+ *     bool process_record_user(uint16_t keycode, keyrecord_t* record) {
+ *       if (!PROFILER_CALL(PROF_ACHORDION,
+ *                          process_achordion(keycode, record))) {
+ *         return false;
+ *       }
+ *       // Your macros ...
+ *
+ *       return true;
+ *     }
+ *
+ *     void housekeeping_task_user(void) {
+ *       PROFILER_TIME(PROF_ACHORDION_TASK, achordion_task());
+ *     }
+ *
+ * Step 3: Call `profiler_print()`, for instance from a custom keycode, to
+ * print the statistics to the console. Use `qmk console` to view it.
+ *
+ * Step 4: In your rules.mk, enable the console and add the source file:
+ *
+ *     CONSOLE_ENABLE = yes
+ *     SRC += features/profiler.c
+ *
+ * Profiling is intrusive: wrapping a call adds two counter reads, and on AVR
+ * each read takes on the order of 50 cycles. Compare relative numbers between
+ * configurations rather than taking the absolute numbers at face value.
+ */
+
+#pragma once
+
+#include "quantum.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/** Maximum number of profiled ids. Ids must be less than this. */
+#ifndef PROFILER_MAX_IDS
+#define PROFILER_MAX_IDS 8
+#endif  // PROFILER_MAX_IDS
+
+/**
+ * Number of histogram bins. Bin k counts calls that took between 2^(k - 1)
+ * and 2^k - 1 cycles, and the last bin also counts all longer calls.
+ */
+#ifndef PROFILER_HISTOGRAM_BINS
+#define PROFILER_HISTOGRAM_BINS 16
+#endif  // PROFILER_HISTOGRAM_BINS
+
+/** Returns the current cycle count. The count wraps around. */
+uint32_t profiler_read_cycles(void);
+
+/**
+ * Records a call for `id` that started at cycle count `start_cycles`, as
+ * previously returned by `profiler_read_cycles()`.
+ */
+void profiler_record(uint8_t id, uint32_t start_cycles);
+
+/** Clears the recorded statistics. */
+void profiler_reset(void);
+
+/** Prints the recorded statistics to the console. */
+void profiler_print(void);
+
+/**
+ * Optional callback to name ids for printing. Returning NULL prints the id
+ * number instead.
+ */
+const char* profiler_id_name_user(uint8_t id);
+
+/**
+ * Evaluates boolean expression `call`, profiling it as `id`, and returns its
+ * value. Intended for `process_*()` handler calls.
+ */
+#define PROFILER_CALL(id, call)                                 \
+  __extension__({                                               \
+    const uint32_t profiler_start_ = profiler_read_cycles();    \
+    const bool profiler_result_ = (call);                       \
+    profiler_record((id), profiler_start_);                     \
+    profiler_result_;                                           \
+  })
+
+/** Runs statement `call`, profiling it as `id`. Intended for task calls. */
+#define PROFILER_TIME(id, call)                                 \
+  do {                                                          \
+    const uint32_t profiler_start_ = profiler_read_cycles();    \
+    call;                                                       \
+    profiler_record((id), profiler_start_);                     \
+  } while (0)
+
+#ifdef __cplusplus
+}
+#endif
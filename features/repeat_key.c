@@ -34,6 +34,10 @@
 #error "repeat_key: Please set `COMBO_ENABLE = yes` in rules.mk."
 #else
 
+#if REPEAT_KEY_HISTORY_SIZE < 1 || REPEAT_KEY_HISTORY_SIZE > 128
+#error "REPEAT_KEY_HISTORY_SIZE must be between 1 and 128."
+#endif
+
 // Variables saving the state of the last key press.
 static keyrecord_t last_record = {0};
 static uint8_t last_mods = 0;
@@ -55,12 +59,49 @@ static void update_last_repeat_count(int8_t dir) {
   }
 }
 
+#if REPEAT_KEY_HISTORY_SIZE > 1
+// Keys remembered before the last key, with their mods. This is a ring buffer
+// where the key before the last is at `history_end`, and the one before that
+// is at `history_end - 1`, modulo the size.
+#define HISTORY_RING_SIZE (REPEAT_KEY_HISTORY_SIZE - 1)
+static uint16_t history_keycodes[HISTORY_RING_SIZE] = {0};
+static uint8_t history_mods[HISTORY_RING_SIZE] = {0};
+static uint8_t history_end = 0;
+
+static void push_history(uint16_t keycode, uint8_t mods) {
+  if (++history_end >= HISTORY_RING_SIZE) {
+    history_end = 0;
+  }
+  history_keycodes[history_end] = keycode;
+  history_mods[history_end] = mods;
+}
+
+// Gets the ring index of the key `n` >= 1 keys before the last key.
+static uint8_t history_index(uint8_t n) {
+  return (history_end + HISTORY_RING_SIZE - (n - 1)) % HISTORY_RING_SIZE;
+}
+#endif  // REPEAT_KEY_HISTORY_SIZE > 1
+
 static void set_last_record(uint16_t keycode, keyrecord_t* record) {
+#if REPEAT_KEY_HISTORY_SIZE > 1
+  if (last_record.keycode) {
+    push_history(last_record.keycode, last_mods);
+  }
+#endif  // REPEAT_KEY_HISTORY_SIZE > 1
   last_record = *record;
   last_record.keycode = keycode;
   last_repeat_count = 0;
 }
 
+/** Plumbs `event` for `record` into the event pipeline. */
+static void invoke_record(keyrecord_t* record, const keyevent_t* event,
+                          int8_t repeat_count) {
+  record->event = *event;
+  processing_repeat_count = repeat_count;
+  process_record(record);
+  processing_repeat_count = 0;
+}
+
 static void repeat_key_invoke(const keyevent_t* event) {
   // It is possible (e.g. in rolled presses) that the last key changes while the
   // Repeat Key is pressed. To prevent stuck keys, it is important to remember
@@ -84,10 +125,7 @@ static void repeat_key_invoke(const keyevent_t* event) {
   }
 
   // Generate a keyrecord and plumb it into the event pipeline.
-  registered_record.event = *event;
-  processing_repeat_count = registered_repeat_count;
-  process_record(&registered_record);
-  processing_repeat_count = 0;
+  invoke_record(&registered_record, event, registered_repeat_count);
 
   // On release, restore the mods state.
   if (!event->pressed) {
@@ -95,6 +133,84 @@ static void repeat_key_invoke(const keyevent_t* event) {
   }
 }
 
+// Built-in alternate keys, as lists of X macros that expand `PAIR(a, b)` for
+// keys a and b that are alternates of each other, and `ONE_WAY(a, b)` for a
+// key a whose alternate is b, but not the reverse.
+// clang-format off
+
+// Keys considered when the last key was pressed with a modifier other than
+// Shift. The following maps
+//   mod + F <-> mod + B
+// and a few others, supporting several core hotkeys used in Emacs, Vim, less,
+// and other programs.
+#define ALT_PAIRS_WITH_MODS(PAIR, ONE_WAY)                                  \
+  PAIR(KC_F   , KC_B   )  /* Forward / Backward. */                         \
+  PAIR(KC_D   , KC_U   )  /* Down / Up. */                                  \
+  PAIR(KC_N   , KC_P   )  /* Next / Previous. */                            \
+  PAIR(KC_A   , KC_E   )  /* Home / End. */                                 \
+  PAIR(KC_O   , KC_I   )  /* Vim jumplist Older / Newer. */
+
+// Keys considered when the last key was pressed with no mods or only Shift,
+// mapping a few more Vim hotkeys.
+#define ALT_PAIRS_WITHOUT_MODS(PAIR, ONE_WAY)                               \
+  PAIR(KC_J   , KC_K   )  /* Down / Up. */                                  \
+  PAIR(KC_H   , KC_L   )  /* Left / Right. */                               \
+  /* These two lines map W and E to B, and B to W. */                       \
+  PAIR(KC_W   , KC_B   )  /* Forward / Backward by word. */                 \
+  ONE_WAY(KC_E, KC_B   )  /* Forward / Backward by word. */
+
+#ifdef EXTRAKEY_ENABLE
+#define ALT_PAIRS_EXTRAKEY(PAIR)                                            \
+  PAIR(KC_WBAK, KC_WFWD)  /* Browser Back / Forward. */                     \
+  PAIR(KC_MNXT, KC_MPRV)  /* Next / Previous Media Track. */                \
+  PAIR(KC_MFFD, KC_MRWD)  /* Fast Forward / Rewind Media. */                \
+  PAIR(KC_VOLU, KC_VOLD)  /* Volume Up / Down. */                           \
+  PAIR(KC_BRIU, KC_BRID)  /* Brightness Up / Down. */
+#else
+#define ALT_PAIRS_EXTRAKEY(PAIR)
+#endif  // EXTRAKEY_ENABLE
+
+#ifdef MOUSEKEY_ENABLE
+#define ALT_PAIRS_MOUSEKEY(PAIR)                                            \
+  PAIR(KC_MS_L, KC_MS_R)  /* Mouse Cursor Left / Right. */                  \
+  PAIR(KC_MS_U, KC_MS_D)  /* Mouse Cursor Up / Down. */                     \
+  PAIR(KC_WH_L, KC_WH_R)  /* Mouse Wheel Left / Right. */                   \
+  PAIR(KC_WH_U, KC_WH_D)  /* Mouse Wheel Up / Down. */
+#else
+#define ALT_PAIRS_MOUSEKEY(PAIR)
+#endif  // MOUSEKEY_ENABLE
+
+// Keys considered with any mods, when there is no match above, followed by
+// REPEAT_KEY_ALT_PAIRS_USER.
+#define ALT_PAIRS_ANY_MODS(PAIR)                                            \
+  PAIR(KC_LEFT, KC_RGHT)  /* Left / Right Arrow. */                         \
+  PAIR(KC_UP  , KC_DOWN)  /* Up / Down Arrow. */                            \
+  PAIR(KC_HOME, KC_END )  /* Home / End. */                                 \
+  PAIR(KC_PGUP, KC_PGDN)  /* Page Up / Page Down. */                        \
+  PAIR(KC_BSPC, KC_DEL )  /* Backspace / Delete. */                         \
+  PAIR(KC_LBRC, KC_RBRC)  /* Brackets [ ] and { }. */                       \
+  ALT_PAIRS_EXTRAKEY(PAIR)                                                  \
+  ALT_PAIRS_MOUSEKEY(PAIR)
+// clang-format on
+
+#ifdef REPEAT_KEY_ALT_TABLE
+// Direct-mapped tables from each basic keycode to its alternate, or KC_NO, one
+// per mod class. Entries are listed in reverse order of precedence, since with
+// designated initializers the last one wins.
+#define TABLE_PAIR(a, b) [a] = (b), [b] = (a),
+#define TABLE_ONE_WAY(a, b) [a] = (b),
+
+static const uint8_t alt_table_with_mods[256] PROGMEM = {
+    REPEAT_KEY_ALT_PAIRS_USER(TABLE_PAIR)
+    ALT_PAIRS_ANY_MODS(TABLE_PAIR)
+    ALT_PAIRS_WITH_MODS(TABLE_PAIR, TABLE_ONE_WAY)
+};
+static const uint8_t alt_table_without_mods[256] PROGMEM = {
+    REPEAT_KEY_ALT_PAIRS_USER(TABLE_PAIR)
+    ALT_PAIRS_ANY_MODS(TABLE_PAIR)
+    ALT_PAIRS_WITHOUT_MODS(TABLE_PAIR, TABLE_ONE_WAY)
+};
+#else
 /**
  * @brief Find alternate keycode from a table of opposing keycode pairs.
  * @param table Array of pairs of basic keycodes, declared as PROGMEM.
@@ -119,6 +235,7 @@ static uint8_t find_alt_keycode(const uint8_t (*table)[2],
   }
   return KC_NO;
 }
+#endif  // REPEAT_KEY_ALT_TABLE
 
 static void alt_repeat_key_invoke(const keyevent_t* event) {
   static keyrecord_t registered_record = {0};
@@ -151,10 +268,7 @@ static void alt_repeat_key_invoke(const keyevent_t* event) {
   }
 
   // Generate a keyrecord and plumb it into the event pipeline.
-  registered_record.event = *event;
-  processing_repeat_count = registered_repeat_count;
-  process_record(&registered_record);
-  processing_repeat_count = 0;
+  invoke_record(&registered_record, event, registered_repeat_count);
 }
 
 __attribute__((weak)) bool get_repeat_key_eligible(uint16_t keycode,
@@ -261,6 +375,60 @@ void set_last_keycode(uint16_t keycode) {
 
 void set_last_mods(uint8_t mods) { last_mods = mods; }
 
+uint16_t get_repeat_history(uint8_t n) {
+  if (n == 0) {
+    return last_record.keycode;
+  }
+#if REPEAT_KEY_HISTORY_SIZE > 1
+  if (n < REPEAT_KEY_HISTORY_SIZE) {
+    return history_keycodes[history_index(n)];
+  }
+#endif  // REPEAT_KEY_HISTORY_SIZE > 1
+  return KC_NO;
+}
+
+uint8_t get_repeat_history_mods(uint8_t n) {
+  if (n == 0) {
+    return last_mods;
+  }
+#if REPEAT_KEY_HISTORY_SIZE > 1
+  if (n < REPEAT_KEY_HISTORY_SIZE) {
+    return history_mods[history_index(n)];
+  }
+#endif  // REPEAT_KEY_HISTORY_SIZE > 1
+  return 0;
+}
+
+bool repeat_key_history_tap(uint8_t n) {
+  const uint16_t keycode = get_repeat_history(n);
+  // Return early if called recursively from a repeated key.
+  if (processing_repeat_count || !keycode) {
+    return false;
+  }
+
+  const uint8_t mods = get_repeat_history_mods(n);
+  keyrecord_t record = {
+#ifndef NO_ACTION_TAPPING
+      .tap.interrupted = false,
+      .tap.count = 1,
+#endif
+      .keycode = keycode,
+  };
+  register_weak_mods(mods);
+  invoke_record(&record, &MAKE_KEYEVENT(0, 0, true), 1);
+  wait_ms(TAP_CODE_DELAY);
+  invoke_record(&record, &MAKE_KEYEVENT(0, 0, false), 1);
+  unregister_weak_mods(mods);
+  return true;
+}
+
+void repeat_key_sequence_tap(uint8_t count) {
+  // Tap the keys oldest first, skipping any not yet typed.
+  while (count > 0) {
+    repeat_key_history_tap(--count);
+  }
+}
+
 uint16_t get_alt_repeat_key_keycode(void) {
   uint16_t keycode = last_record.keycode;
   uint8_t mods = last_mods;
@@ -307,64 +475,33 @@ uint16_t get_alt_repeat_key_keycode(void) {
   }
 
   if (IS_QK_BASIC(keycode)) {
+#ifdef REPEAT_KEY_ALT_TABLE
+    alt_keycode = pgm_read_byte(
+        ((mods & (MOD_LCTL | MOD_LALT | MOD_LGUI)) ? alt_table_with_mods
+                                                  : alt_table_without_mods) +
+        keycode);
+#else
+#define LIST_PAIR(a, b) {(a), (b)},
     if ((mods & (MOD_LCTL | MOD_LALT | MOD_LGUI))) {
-      // The last key was pressed with a modifier other than Shift. The
-      // following maps
-      //   mod + F <-> mod + B
-      // and a few others, supporting several core hotkeys used in Emacs, Vim,
-      // less, and other programs.
-      // clang-format off
+      // The last key was pressed with a modifier other than Shift.
       static const uint8_t pairs[][2] PROGMEM = {
-          {KC_F   , KC_B   },  // Forward / Backward.
-          {KC_D   , KC_U   },  // Down / Up.
-          {KC_N   , KC_P   },  // Next / Previous.
-          {KC_A   , KC_E   },  // Home / End.
-          {KC_O   , KC_I   },  // Vim jumplist Older / Newer.
-      };
-      // clang-format on
+          ALT_PAIRS_WITH_MODS(LIST_PAIR, LIST_PAIR)};
       alt_keycode = find_alt_keycode(pairs, sizeof(pairs), keycode);
     } else {
-      // The last key was pressed with no mods or only Shift. The following map
-      // a few more Vim hotkeys.
-      // clang-format off
+      // The last key was pressed with no mods or only Shift.
       static const uint8_t pairs[][2] PROGMEM = {
-          {KC_J   , KC_K   },  // Down / Up.
-          {KC_H   , KC_L   },  // Left / Right.
-          // These two lines map W and E to B, and B to W.
-          {KC_W   , KC_B   },  // Forward / Backward by word.
-          {KC_E   , KC_B   },  // Forward / Backward by word.
-      };
-      // clang-format on
+          ALT_PAIRS_WITHOUT_MODS(LIST_PAIR, LIST_PAIR)};
       alt_keycode = find_alt_keycode(pairs, sizeof(pairs), keycode);
     }
 
     if (!alt_keycode) {
       // The following key pairs are considered with any mods.
-      // clang-format off
       static const uint8_t pairs[][2] PROGMEM = {
-          {KC_LEFT, KC_RGHT},  // Left / Right Arrow.
-          {KC_UP  , KC_DOWN},  // Up / Down Arrow.
-          {KC_HOME, KC_END },  // Home / End.
-          {KC_PGUP, KC_PGDN},  // Page Up / Page Down.
-          {KC_BSPC, KC_DEL },  // Backspace / Delete.
-          {KC_LBRC, KC_RBRC},  // Brackets [ ] and { }.
-#ifdef EXTRAKEY_ENABLE
-          {KC_WBAK, KC_WFWD},  // Browser Back / Forward.
-          {KC_MNXT, KC_MPRV},  // Next / Previous Media Track.
-          {KC_MFFD, KC_MRWD},  // Fast Forward / Rewind Media.
-          {KC_VOLU, KC_VOLD},  // Volume Up / Down.
-          {KC_BRIU, KC_BRID},  // Brightness Up / Down.
-#endif  // EXTRAKEY_ENABLE
-#ifdef MOUSEKEY_ENABLE
-          {KC_MS_L, KC_MS_R},  // Mouse Cursor Left / Right.
-          {KC_MS_U, KC_MS_D},  // Mouse Cursor Up / Down.
-          {KC_WH_L, KC_WH_R},  // Mouse Wheel Left / Right.
-          {KC_WH_U, KC_WH_D},  // Mouse Wheel Up / Down.
-#endif  // MOUSEKEY_ENABLE
-      };
-      // clang-format on
+          ALT_PAIRS_ANY_MODS(LIST_PAIR) REPEAT_KEY_ALT_PAIRS_USER(LIST_PAIR)};
       alt_keycode = find_alt_keycode(pairs, sizeof(pairs), keycode);
     }
+#undef LIST_PAIR
+#endif  // REPEAT_KEY_ALT_TABLE
 
     if (alt_keycode) {
       // Combine basic keycode with mods.
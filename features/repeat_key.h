@@ -47,6 +47,28 @@
 extern "C" {
 #endif
 
+/**
+ * @brief Additional alternate key pairs, considered with any mods.
+ *
+ * Define this in config.h as a list of `PAIR(a, b)` items, where `a` and `b`
+ * are basic keycodes that are alternates of each other:
+ *
+ *     #define REPEAT_KEY_ALT_PAIRS_USER(PAIR) \
+ *       PAIR(KC_MINS, KC_EQL)                 \
+ *       PAIR(KC_COMM, KC_DOT)
+ *
+ * These are checked after the built-in pairs. For alternates that depend on
+ * more than the basic keycode, use `get_alt_repeat_key_keycode_user()`.
+ *
+ * Optionally, define `REPEAT_KEY_ALT_TABLE` in config.h to look up alternate
+ * keys in a 256-entry table per mod class, built at compile time from the
+ * built-in and user pairs, rather than searching the pairs. Lookup is then a
+ * single read, at the cost of 512 bytes of flash.
+ */
+#ifndef REPEAT_KEY_ALT_PAIRS_USER
+#define REPEAT_KEY_ALT_PAIRS_USER(PAIR)
+#endif  // REPEAT_KEY_ALT_PAIRS_USER
+
 /**
  * Handler function for Repeat Key. Call either this function or
  * `process_repeat_key_with_rev()` (but not both) from `process_record_user()`
@@ -85,11 +107,69 @@ int8_t get_repeat_key_count(void);
 uint16_t get_last_keycode(void);
 /** @brief Mods that were active with the last key. */
 uint8_t get_last_mods(void);
-/** @brief Sets the last keycode. */
+/**
+ * @brief Sets the last keycode.
+ *
+ * Like a key press, this moves the previous last key, with its mods, into the
+ * history read by `get_repeat_history()`.
+ */
 void set_last_keycode(uint16_t keycode);
 /** @brief Sets the last mods. */
 void set_last_mods(uint8_t mods);
 
+/**
+ * @brief Number of remembered keys, including the last key.
+ *
+ * By default, only the last key is remembered. Define this in config.h to
+ * remember more, for use with `get_repeat_history()`,
+ * `repeat_key_history_tap()`, and `repeat_key_sequence_tap()`. Each key
+ * beyond the last uses 3 bytes of RAM.
+ */
+#ifndef REPEAT_KEY_HISTORY_SIZE
+#define REPEAT_KEY_HISTORY_SIZE 1
+#endif  // REPEAT_KEY_HISTORY_SIZE
+
+/**
+ * @brief Keycode of the key remembered `n` keys ago.
+ *
+ * With `n` = 0, this is the last key, the same as `get_last_keycode()`. With
+ * `n` = 1, it is the key remembered before that, and so on. Returns KC_NO if
+ * `n` >= `REPEAT_KEY_HISTORY_SIZE` or fewer keys have been remembered.
+ */
+uint16_t get_repeat_history(uint8_t n);
+
+/** @brief Mods that were active with the key remembered `n` keys ago. */
+uint8_t get_repeat_history_mods(uint8_t n);
+
+/**
+ * @brief Taps the key remembered `n` keys ago, with its mods.
+ *
+ * The key is processed as a repeated key, with `get_repeat_key_count()` = 1,
+ * and does not change what is remembered. As with `repeat_key_tap()`, the
+ * event has key position (0, 0).
+ *
+ * @return True if there was a key to tap.
+ */
+bool repeat_key_history_tap(uint8_t n);
+
+/**
+ * @brief Taps the last `count` remembered keys in the order they were typed.
+ *
+ * For instance, `repeat_key_sequence_tap(2)` replays the last two keys, useful
+ * to retype a common bigram with one key press. Call it from a macro on press:
+ *
+ *     case REPEAT_BIGRAM:
+ *       if (record->event.pressed) {
+ *         repeat_key_sequence_tap(2);
+ *       }
+ *       return false;
+ *
+ * `count` should be at most `REPEAT_KEY_HISTORY_SIZE`. Return false from
+ * `remember_last_key_user()` for the macro's keycode, so that the macro does
+ * not remember itself.
+ */
+void repeat_key_sequence_tap(uint8_t count);
+
 /**
  * @brief Callback defining which keys are remembered.
  *
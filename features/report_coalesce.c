@@ -0,0 +1,114 @@
+// Copyright 2025 Google LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     https://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+/**
+ * @file report_coalesce.c
+ * @brief Report coalescing implementation
+ */
+
+#include "report_coalesce.h"
+
+static bool dirty = false;
+static uint16_t flush_timer = 0;
+// The host driver with `send_keyboard` hooked, and the driver it wraps.
+static host_driver_t hooked_driver;
+static host_driver_t* wrapped_driver = NULL;
+
+// Clears the dirty flag whenever a keyboard report is sent, by QMK or by this
+// library, since the report includes the coalesced changes.
+static void hooked_send_keyboard(report_keyboard_t* report) {
+  dirty = false;
+  wrapped_driver->send_keyboard(report);
+}
+
+#ifdef NKRO_ENABLE
+static void hooked_send_nkro(report_nkro_t* report) {
+  dirty = false;
+  wrapped_driver->send_nkro(report);
+}
+#endif  // NKRO_ENABLE
+
+// Marks the report as dirty. On first use, or if the host driver has changed,
+// installs the hook in the host driver.
+static void mark_dirty(void) {
+  host_driver_t* driver = host_get_driver();
+  if (driver != &hooked_driver && driver != NULL) {
+    wrapped_driver = driver;
+    hooked_driver = *driver;
+    hooked_driver.send_keyboard = hooked_send_keyboard;
+#ifdef NKRO_ENABLE
+    hooked_driver.send_nkro = hooked_send_nkro;
+#endif  // NKRO_ENABLE
+    host_set_driver(&hooked_driver);
+  }
+  dirty = true;
+}
+
+// Returns true if `keycode` can be updated in the report state directly. This
+// is the case for keys KC_A to KC_F24, optionally with mods. Other keycodes may
+// need special handling by `register_code()`, like locking keys.
+static bool is_direct_keycode(uint16_t keycode) {
+  if (IS_QK_MODS(keycode)) {
+    keycode = QK_MODS_GET_BASIC_KEYCODE(keycode);
+  }
+  return KC_A <= keycode && keycode <= KC_F24;
+}
+
+// Converts the 5-bit mods of a modified keycode to an 8-bit mod bitfield.
+static uint8_t keycode_mods(uint16_t keycode) {
+  if (!IS_QK_MODS(keycode)) {
+    return 0;
+  }
+  const uint8_t mods = QK_MODS_GET_MODS(keycode);
+  return (mods & 0x10) ? ((mods & 0x0f) << 4) : mods;
+}
+
+void report_coalesce_register_code16(uint16_t keycode) {
+  if (!is_direct_keycode(keycode)) {
+    // Send pending changes first, so that they take effect before the key.
+    report_coalesce_flush();
+    register_code16(keycode);
+    return;
+  }
+  add_weak_mods(keycode_mods(keycode));
+  add_key(QK_MODS_GET_BASIC_KEYCODE(keycode));
+  mark_dirty();
+}
+
+void report_coalesce_unregister_code16(uint16_t keycode) {
+  if (!is_direct_keycode(keycode)) {
+    report_coalesce_flush();
+    unregister_code16(keycode);
+    return;
+  }
+  del_key(QK_MODS_GET_BASIC_KEYCODE(keycode));
+  del_weak_mods(keycode_mods(keycode));
+  mark_dirty();
+}
+
+void report_coalesce_mark_dirty(void) { mark_dirty(); }
+
+void report_coalesce_flush(void) {
+  if (dirty) {
+    dirty = false;
+    flush_timer = timer_read();
+    send_keyboard_report();
+  }
+}
+
+void report_coalesce_task(void) {
+  if (dirty && timer_elapsed(flush_timer) >= REPORT_COALESCE_INTERVAL_MS) {
+    report_coalesce_flush();
+  }
+}
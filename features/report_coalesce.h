@@ -0,0 +1,98 @@
+// Copyright 2025 Google LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     https://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+/**
+ * @file report_coalesce.h
+ * @brief Report coalescing: combine keyboard report changes into one report.
+ *
+ * Overview
+ * --------
+ *
+ * QMK's `register_code16()`, `unregister_mods()`, and the like each send a
+ * keyboard report. A handler that makes several changes for one event sends
+ * several reports, of which only the last is the intended state, and the
+ * intermediate reports may be seen by the host as transient key states.
+ *
+ * This library provides variants of these functions that update the report
+ * state without sending it and mark the report as dirty. The dirty report is
+ * sent by `report_coalesce_flush()`, or by `report_coalesce_task()` at most
+ * once every `REPORT_COALESCE_INTERVAL_MS` milliseconds. Any report that QMK
+ * sends in the meantime includes the changes as well. The library hooks the
+ * host driver's `send_keyboard` to see such reports, so that it clears the
+ * dirty flag rather than sending the same changes again later.
+ *
+ * Keycodes that can't be updated in the report state directly, like consumer
+ * keys, are registered as usual, after sending the dirty report. This way,
+ * changes marked before them, like releasing Shift, take effect first.
+ *
+ * Custom Shift Keys and SOCD Cleaner use this library when
+ * `REPORT_COALESCE_ENABLE` is defined.
+ *
+ *
+ * Usage
+ * -----
+ *
+ * In your keymap.c, call the task from housekeeping:
+ *
+ *     #include "features/report_coalesce.h"
+ *
+ *     void housekeeping_task_user(void) {
+ *       report_coalesce_task();
+ *       // Other tasks ...
+ *     }
+ *
+ * In your rules.mk, add
+ *
+ *     OPT_DEFS += -DREPORT_COALESCE_ENABLE
+ *     SRC += features/report_coalesce.c
+ */
+
+#pragma once
+
+#include "quantum.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/** Minimum milliseconds between reports sent by `report_coalesce_task()`. */
+#ifndef REPORT_COALESCE_INTERVAL_MS
+#define REPORT_COALESCE_INTERVAL_MS 1
+#endif  // REPORT_COALESCE_INTERVAL_MS
+
+/**
+ * Registers `keycode` without sending a report, if `keycode` is a basic or
+ * modified basic keycode. Other keycodes are registered with
+ * `register_code16()`, sending a report as usual.
+ */
+void report_coalesce_register_code16(uint16_t keycode);
+
+/** Unregisters `keycode` like `report_coalesce_register_code16()`. */
+void report_coalesce_unregister_code16(uint16_t keycode);
+
+/**
+ * Marks that the report should be sent, in place of sending it. Call this
+ * after changing the report state, for instance with `del_mods()`.
+ */
+void report_coalesce_mark_dirty(void);
+
+/** Sends the report right away if it is dirty. */
+void report_coalesce_flush(void);
+
+/** Task function. Sends the dirty report when the interval has elapsed. */
+void report_coalesce_task(void);
+
+#ifdef __cplusplus
+}
+#endif
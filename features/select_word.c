@@ -22,6 +22,10 @@
 
 #include "select_word.h"
 
+#ifdef IDLE_TIMEOUT_ENABLE
+#include "idle_timeout.h"
+#endif  // IDLE_TIMEOUT_ENABLE
+
 #if !defined(IS_QK_MOD_TAP)
 // Attempt to detect out-of-date QMK installation, which would fail with
 // implicit-function-declaration errors in the code below.
@@ -79,20 +83,107 @@ __attribute__((weak)) bool select_word_host_is_mac(void) {
 #   error "select_word: SELECT_WORD_TIMEOUT must be between 100 and 30000 ms"
 # endif
 
+#ifdef IDLE_TIMEOUT_ENABLE
+static void idle_timeout_expired(void) { selection_dir = 0; }
+static idle_timeout_t idle_timeout = {.callback = idle_timeout_expired};
+
+static void restart_idle_timer(void) {
+  idle_timeout_start(&idle_timeout, SELECT_WORD_TIMEOUT);
+}
+static void stop_idle_timer(void) { idle_timeout_cancel(&idle_timeout); }
+static bool is_idle_timer_running(void) {
+  return idle_timeout_is_active(&idle_timeout);
+}
+#else
 static uint16_t idle_timer = 0;
 
 static void restart_idle_timer(void) {
   idle_timer = (timer_read() + SELECT_WORD_TIMEOUT) | 1;
 }
+static void stop_idle_timer(void) { idle_timer = 0; }
+static bool is_idle_timer_running(void) { return idle_timer != 0; }
+#endif  // IDLE_TIMEOUT_ENABLE
 
-void select_word_task(void) {
-  if (idle_timer && timer_expired(timer_read(), idle_timer)) {
-    idle_timer = 0;
-    selection_dir = 0;
+#endif  // SELECT_WORD_TIMEOUT > 0
+
+#ifdef SELECT_WORD_NONBLOCKING
+// Taps of the current selection, sent from select_word_task() one report every
+// TAP_CODE_DELAY ms, followed optionally by a hotkey to hold. Each is stored as
+// 8-bit mods in the high byte and a basic keycode in the low byte.
+static uint16_t pending_taps[3] = {0};
+static uint8_t num_pending_taps = 0;
+static uint8_t pending_index = 0;
+static bool pending_pressed = false;
+static uint16_t pending_hold = 0;
+static uint16_t pending_timer = 0;
+
+static bool is_pending(void) { return num_pending_taps > 0 || pending_hold; }
+
+// Presses or releases `keycode` in a report with exactly `mods`. On release,
+// another report restores the mods, so that the host doesn't see the tap's mods
+// as still held. On press, they stay in the host's report until the next one.
+static void send_with_mods(uint8_t mods, uint8_t keycode, bool pressed) {
+  const uint8_t saved_mods = get_mods();
+  const uint8_t saved_weak_mods = get_weak_mods();
+  set_mods(mods);
+  clear_weak_mods();
+  if (pressed) {
+    register_code(keycode);
+  } else {
+    unregister_code(keycode);
+  }
+  set_mods(saved_mods);
+  set_weak_mods(saved_weak_mods);
+  if (!pressed) {
+    send_keyboard_report();
   }
 }
-#endif  // SELECT_WORD_TIMEOUT > 0
 
+// Sends the next report: the next tap press or release, or the held hotkey.
+static void step(void) {
+  if (pending_index < num_pending_taps) {
+    const uint16_t tap = pending_taps[pending_index];
+    pending_pressed = !pending_pressed;
+    send_with_mods(tap >> 8, (uint8_t)tap, pending_pressed);
+    if (!pending_pressed) {
+      ++pending_index;
+    }
+  } else if (pending_hold) {
+    registered_hotkey = (uint8_t)pending_hold;
+    send_with_mods(pending_hold >> 8, registered_hotkey, true);
+    pending_hold = 0;
+  }
+
+  if (pending_index >= num_pending_taps && !pending_hold) {
+    num_pending_taps = 0;
+    pending_index = 0;
+  }
+}
+
+// Sends all pending reports now, for instance before another key's event.
+static void flush_pending(void) {
+  while (is_pending()) {
+    step();
+    if (is_pending()) {
+      wait_ms(TAP_CODE_DELAY);
+    }
+  }
+}
+
+static void queue_tap(uint8_t mods, uint8_t keycode) {
+  pending_taps[num_pending_taps++] = (uint16_t)mods << 8 | keycode;
+}
+
+// Holds `keycode` with `mods`, after any queued taps.
+static void queue_hold(uint8_t mods, uint8_t keycode) {
+  if (num_pending_taps) {
+    pending_hold = (uint16_t)mods << 8 | keycode;
+  } else {
+    registered_hotkey = keycode;
+    send_with_mods(mods, keycode, true);
+  }
+}
+#else
 static void clear_all_mods(void) {
   clear_mods();
   clear_weak_mods();
@@ -100,6 +191,25 @@ static void clear_all_mods(void) {
   clear_oneshot_mods();
 #endif  // NO_ACTION_ONESHOT
 }
+#endif  // SELECT_WORD_NONBLOCKING
+
+#if (SELECT_WORD_TIMEOUT > 0 && !defined(IDLE_TIMEOUT_ENABLE)) || \
+    defined(SELECT_WORD_NONBLOCKING)
+void select_word_task(void) {
+#ifdef SELECT_WORD_NONBLOCKING
+  if (is_pending() && timer_elapsed(pending_timer) >= TAP_CODE_DELAY) {
+    step();
+    pending_timer = timer_read();
+  }
+#endif  // SELECT_WORD_NONBLOCKING
+#if SELECT_WORD_TIMEOUT > 0 && !defined(IDLE_TIMEOUT_ENABLE)
+  if (idle_timer && timer_expired(timer_read(), idle_timer)) {
+    idle_timer = 0;
+    selection_dir = 0;
+  }
+#endif  // SELECT_WORD_TIMEOUT > 0 && !defined(IDLE_TIMEOUT_ENABLE)
+}
+#endif
 
 static void select_word_in_dir(int8_t dir) {
   // With Windows and Linux (non-Mac) systems:
@@ -116,6 +226,20 @@ static void select_word_in_dir(int8_t dir) {
   // dir < 0: Backward word selection: Alt+Shift+Left.
   // dir > 0: Forward word selection: Alt+Shift+Right.
   reset_before_next_event = false;
+#ifdef SELECT_WORD_NONBLOCKING
+  const uint8_t mod = IS_MAC ? MOD_BIT_LALT : MOD_BIT_LCTRL;
+  const uint8_t hotkey = (dir < 0) ? KC_LEFT : KC_RGHT;
+  const uint8_t opposite = (dir < 0) ? KC_RGHT : KC_LEFT;
+
+  if (selection_dir && (selection_dir < 0) != (dir < 0)) {  // Reversal.
+    queue_tap(0, opposite);
+  }
+  if (selection_dir == 0) {  // Initial selection.
+    queue_tap(mod, hotkey);
+    queue_tap(mod, opposite);
+  }
+  queue_hold(mod | MOD_BIT_LSHIFT, hotkey);
+#else
   const uint8_t saved_mods = get_mods();
   clear_all_mods();
 
@@ -139,6 +263,7 @@ static void select_word_in_dir(int8_t dir) {
   register_code(registered_hotkey);
 
   set_mods(saved_mods);
+#endif  // SELECT_WORD_NONBLOCKING
   selection_dir = dir;
 }
 
@@ -153,6 +278,19 @@ static void select_line(void) {
   // Or to extend an existing selection:
   // Shift+Down.
   reset_before_next_event = false;
+#ifdef SELECT_WORD_NONBLOCKING
+  if (selection_dir != 2) {
+    if (IS_MAC) {
+      queue_tap(MOD_BIT_LGUI, KC_LEFT);
+      queue_tap(MOD_BIT_LGUI | MOD_BIT_LSHIFT, KC_RGHT);
+    } else {
+      queue_tap(0, KC_HOME);
+      queue_tap(MOD_BIT_LSHIFT, KC_END);
+    }
+  } else {
+    queue_hold(MOD_BIT_LSHIFT, KC_DOWN);
+  }
+#else
   const uint8_t saved_mods = get_mods();
   clear_all_mods();
 
@@ -169,13 +307,20 @@ static void select_line(void) {
   }
 
   set_mods(saved_mods);
+#endif  // SELECT_WORD_NONBLOCKING
   selection_dir = 2;
 }
 
 void select_word_register(char action) {
+#ifdef SELECT_WORD_NONBLOCKING
+  flush_pending();
+#endif  // SELECT_WORD_NONBLOCKING
   if (registered_hotkey) {
     select_word_unregister();
   }
+#if defined(SELECT_WORD_NONBLOCKING) && !defined(NO_ACTION_ONESHOT)
+  clear_oneshot_mods();
+#endif  // defined(SELECT_WORD_NONBLOCKING) && !defined(NO_ACTION_ONESHOT)
 
   switch (action) {
     case 'W':
@@ -189,14 +334,29 @@ void select_word_register(char action) {
       break;
   }
 
+#ifdef SELECT_WORD_NONBLOCKING
+  if (is_pending()) {  // Send the first report now, the rest from the task.
+    step();
+    pending_timer = timer_read();
+  }
+#endif  // SELECT_WORD_NONBLOCKING
 #if SELECT_WORD_TIMEOUT > 0
-  idle_timer = 0;
+  stop_idle_timer();
 #endif  // SELECT_WORD_TIMEOUT > 0
 }
 
 void select_word_unregister(void) {
   reset_before_next_event = false;
+#ifdef SELECT_WORD_NONBLOCKING
+  if (pending_hold) {  // Released before the hotkey was held: tap it instead.
+    queue_tap(pending_hold >> 8, (uint8_t)pending_hold);
+    pending_hold = 0;
+  } else if (registered_hotkey) {
+    unregister_code(registered_hotkey);
+  }
+#else
   unregister_code(registered_hotkey);
+#endif  // SELECT_WORD_NONBLOCKING
   registered_hotkey = KC_NO;
 #if SELECT_WORD_TIMEOUT > 0
   restart_idle_timer();
@@ -204,6 +364,11 @@ void select_word_unregister(void) {
 }
 
 bool process_select_word(uint16_t keycode, keyrecord_t* record) {
+#ifdef SELECT_WORD_NONBLOCKING
+  if (record->event.pressed) {  // Keep output in order with the new key.
+    flush_pending();
+  }
+#endif  // SELECT_WORD_NONBLOCKING
   if (selection_dir) {
     if (reset_before_next_event) {
       selection_dir = 0;
@@ -240,7 +405,7 @@ bool process_select_word(uint16_t keycode, keyrecord_t* record) {
   }
 
 #if SELECT_WORD_TIMEOUT > 0
-  if (idle_timer) {
+  if (is_idle_timer_running()) {
     restart_idle_timer();
   }
 #endif  // SELECT_WORD_TIMEOUT > 0
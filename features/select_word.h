@@ -62,15 +62,26 @@ bool process_select_word(uint16_t keycode, keyrecord_t* record);
  * @fn select_word_task(void)
  * Matrix task function for Select Word.
  *
- * If using `SELECT_WORD_TIMEOUT`, call this function from your
- * `housekeeping_task_user()` function in keymap.c. (If no timeout is set,
- * calling `select_word_task()` has no effect.)
+ * If using `SELECT_WORD_TIMEOUT` or `SELECT_WORD_NONBLOCKING`, call this
+ * function from your `housekeeping_task_user()` function in keymap.c. (If
+ * neither is set, calling `select_word_task()` has no effect. The timeout may
+ * instead be handled by Idle Timeout, features/idle_timeout.h, by defining
+ * `IDLE_TIMEOUT_ENABLE`.)
+ *
+ * By default, a selection's hotkey sequence, like Ctrl+Right, Ctrl+Left,
+ * Ctrl+Shift+Left, is sent with blocking waits of `TAP_CODE_DELAY` between
+ * reports. Define `SELECT_WORD_NONBLOCKING` in config.h to instead send the
+ * first report right away and the rest from `select_word_task()`, one report
+ * every `TAP_CODE_DELAY` ms, so that the keyboard keeps scanning meanwhile. If
+ * another key is pressed while reports are pending, they are sent right away
+ * to keep output in order.
  */
-#if SELECT_WORD_TIMEOUT > 0
+#if (SELECT_WORD_TIMEOUT > 0 && !defined(IDLE_TIMEOUT_ENABLE)) || \
+    defined(SELECT_WORD_NONBLOCKING)
 void select_word_task(void);
 #else
 static inline void select_word_task(void) {}
-#endif  // SELECT_WORD_TIMEOUT > 0
+#endif
 
 /**
  * @brief Registers (presses) selection `action`.
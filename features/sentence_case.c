@@ -24,6 +24,29 @@
 
 #include <string.h>
 
+#ifdef SENTENCE_CASE_ABBREVIATIONS
+#include "sentence_case_abbrev_data.h"
+#endif  // SENTENCE_CASE_ABBREVIATIONS
+
+#ifdef IDLE_TIMEOUT_ENABLE
+#include "idle_timeout.h"
+#endif  // IDLE_TIMEOUT_ENABLE
+
+#ifdef KEY_EVENT_ENABLE
+#include "key_event.h"
+#endif  // KEY_EVENT_ENABLE
+
+#ifdef KEY_HISTORY_ENABLE
+#include "key_history.h"
+
+#if SENTENCE_CASE_BUFFER_SIZE > KEY_HISTORY_SIZE
+#error "sentence_case: SENTENCE_CASE_BUFFER_SIZE must be <= KEY_HISTORY_SIZE."
+#endif
+#elif SENTENCE_CASE_BUFFER_SIZE > 1
+// Without Key History, keep a buffer of keys here.
+#define OWN_KEY_BUFFER
+#endif  // KEY_HISTORY_ENABLE
+
 #if !defined(IS_QK_MOD_TAP)
 // Attempt to detect out-of-date QMK installation, which would fail with
 // implicit-function-declaration errors in the code below.
@@ -35,8 +58,9 @@
 #error "sentence_case: Please enable oneshot."
 #else
 
-// Number of keys of state history to retain for backspacing.
-#define STATE_HISTORY_SIZE 6
+// Number of keys of state history to retain for backspacing. Must be a power
+// of 2.
+#define STATE_HISTORY_SIZE 8
 
 // clang-format off
 /** States in matching the beginning of a sentence. */
@@ -48,18 +72,165 @@ enum {
   STATE_PRIMED,   /**< "Primed" state, in the space following an ending. */
   STATE_DISABLED, /**< Sentence Case is disabled. */
 };
+
+/** Classes of keys, as returned by `sentence_case_press_user()`. */
+enum {
+  CLASS_SYMBOL,  /**< '#', or other code: symbol key. */
+  CLASS_LETTER,  /**< 'a': letter key. */
+  CLASS_ENDING,  /**< '.': sentence-ending punctuation. */
+  CLASS_SPACE,   /**< ' ': space key. */
+  CLASS_QUOTE,   /**< '\'': quote key. */
+  NUM_CLASSES,
+};
 // clang-format on
 
+// Flags in the transition table, combined with the next state in the low bits.
+// The next state is taken only if the flagged condition holds, and is
+// STATE_INIT otherwise.
+#define STATE_MASK 0x0f
+// Start of a sentence: capitalize the key, unless it is `suppress_key`.
+#define FLAG_CAPITALIZE 0x10
+// Only if `sentence_case_check_ending()` accepts the key buffer.
+#define FLAG_CHECK_ENDING 0x20
+// Clear `suppress_key`, when the next state is taken.
+#define FLAG_UNSUPPRESS 0x40
+
+// We search for sentence beginnings using a simple finite state machine. It
+// matches things like "a. a" and "a.  a" but not "a.. a" or "a.a. a". The
+// transition table is indexed by the current state and the class of the key:
+//
+//             'a'       '.'      ' '      '\''     '#'
+//           +----------------------------------------------
+//   INIT    | WORD      ABBREV   INIT     INIT     INIT
+//   WORD    | WORD      ENDING   INIT     WORD     INIT
+//   ABBREV  | ABBREV    ABBREV   INIT     ABBREV   INIT
+//   ENDING  | ABBREV    ABBREV   PRIMED*  ENDING   INIT
+//   PRIMED  | match!    ABBREV   PRIMED   PRIMED   INIT
+//
+// (*) if `sentence_case_check_ending()` accepts the ending. Unlisted classes
+// transition to STATE_INIT, which is zero.
+static const uint8_t transitions[STATE_DISABLED][NUM_CLASSES] PROGMEM = {
+    [STATE_INIT] =
+        {
+            [CLASS_LETTER] = STATE_WORD,
+            [CLASS_ENDING] = STATE_ABBREV,
+        },
+    [STATE_WORD] =
+        {
+            [CLASS_LETTER] = STATE_WORD,
+            [CLASS_ENDING] = STATE_ENDING,
+            [CLASS_QUOTE] = STATE_WORD,
+        },
+    [STATE_ABBREV] =
+        {
+            [CLASS_LETTER] = STATE_ABBREV,
+            [CLASS_ENDING] = STATE_ABBREV,
+            [CLASS_QUOTE] = STATE_ABBREV,
+        },
+    [STATE_ENDING] =
+        {
+            [CLASS_LETTER] = STATE_ABBREV,
+            [CLASS_ENDING] = STATE_ABBREV,
+            [CLASS_SPACE] = STATE_PRIMED | FLAG_CHECK_ENDING | FLAG_UNSUPPRESS,
+            [CLASS_QUOTE] = STATE_ENDING,
+        },
+    [STATE_PRIMED] =
+        {
+            [CLASS_LETTER] = STATE_WORD | FLAG_CAPITALIZE,
+            [CLASS_ENDING] = STATE_ABBREV,
+            [CLASS_SPACE] = STATE_PRIMED | FLAG_UNSUPPRESS,
+            [CLASS_QUOTE] = STATE_PRIMED,
+        },
+};
+
 #if SENTENCE_CASE_TIMEOUT > 0
+#ifdef IDLE_TIMEOUT_ENABLE
+static void idle_timeout_expired(void);
+static idle_timeout_t idle_timeout = {.callback = idle_timeout_expired};
+#else
 static uint16_t idle_timer = 0;
+#endif  // IDLE_TIMEOUT_ENABLE
 #endif  // SENTENCE_CASE_TIMEOUT > 0
-#if SENTENCE_CASE_BUFFER_SIZE > 1
-static uint16_t key_buffer[SENTENCE_CASE_BUFFER_SIZE] = {0};
-#endif  // SENTENCE_CASE_BUFFER_SIZE > 1
+#ifdef OWN_KEY_BUFFER
+// The key buffer is a ring buffer stored twice over, so that the last
+// SENTENCE_CASE_BUFFER_SIZE keycodes are always contiguous at
+// `key_buffer + key_buffer_start`, oldest first.
+static uint16_t key_buffer[2 * SENTENCE_CASE_BUFFER_SIZE] = {0};
+static uint8_t key_buffer_start = 0;
+#endif  // OWN_KEY_BUFFER
+#ifdef KEY_HISTORY_ENABLE
+// Sentence Case's view of the shared key history, reset with the state.
+static key_history_view_t history_view = {0};
+#endif  // KEY_HISTORY_ENABLE
+// Ring buffer of states, where the newest is before `state_history_end`.
 static uint8_t state_history[STATE_HISTORY_SIZE];
+static uint8_t state_history_end = 0;
 static uint16_t suppress_key = KC_NO;
 static uint8_t sentence_state = STATE_INIT;
 
+#ifdef SENTENCE_CASE_ABBREVIATIONS
+// Node in `sentence_case_abbrev_data` reached by the current word, or
+// ABBREV_NONE if the word doesn't begin any abbreviation. The root is node 0.
+#define ABBREV_NONE 0xffff
+static uint16_t abbrev_node = 0;
+// Ring buffer of `abbrev_node` values, parallel to `state_history`.
+static uint16_t abbrev_history[STATE_HISTORY_SIZE];
+
+// Returns the child of trie `node` for `keycode`, or ABBREV_NONE. A node is a
+// header byte, whose low 7 bits are the number of children and whose high bit
+// is set if an abbreviation ends there, followed by 3 bytes for each child:
+// the keycode and the 16-bit little endian offset of the child node.
+static uint16_t abbrev_next(uint16_t node, uint16_t keycode) {
+  if (node == ABBREV_NONE || keycode > 0xff) {
+    return ABBREV_NONE;
+  }
+  const uint8_t num_children =
+      pgm_read_byte(sentence_case_abbrev_data + node) & 0x7f;
+  ++node;
+  for (uint8_t i = 0; i < num_children; ++i, node += 3) {
+    if (pgm_read_byte(sentence_case_abbrev_data + node) == keycode) {
+      return pgm_read_byte(sentence_case_abbrev_data + node + 1) |
+             (pgm_read_byte(sentence_case_abbrev_data + node + 2) << 8);
+    }
+  }
+  return ABBREV_NONE;
+}
+
+// Returns whether the current word is an abbreviation.
+static bool is_abbrev(void) {
+  return abbrev_node != ABBREV_NONE &&
+         (pgm_read_byte(sentence_case_abbrev_data + abbrev_node) & 0x80) != 0;
+}
+#endif  // SENTENCE_CASE_ABBREVIATIONS
+
+// Returns whether the keys typed so far make a real sentence ending, where
+// `include_current` is whether to consider the current key.
+static bool is_real_ending(bool include_current) {
+#ifdef SENTENCE_CASE_ABBREVIATIONS
+  if (is_abbrev()) {
+    return false;
+  }
+#endif  // SENTENCE_CASE_ABBREVIATIONS
+#if SENTENCE_CASE_BUFFER_SIZE > 1
+#ifdef KEY_HISTORY_ENABLE
+  // The key history already includes the current key. Copy the last keys,
+  // oldest first, from the history.
+  const uint8_t ago = include_current ? 0 : 1;
+  uint16_t buffer[SENTENCE_CASE_BUFFER_SIZE];
+  for (uint8_t i = 0; i < SENTENCE_CASE_BUFFER_SIZE; ++i) {
+    buffer[i] = key_history_view_get(
+        &history_view, ago + (SENTENCE_CASE_BUFFER_SIZE - 1) - i);
+  }
+#else
+  // The current key is added to `key_buffer` along with the state.
+  const uint16_t* buffer = key_buffer + key_buffer_start;
+#endif  // KEY_HISTORY_ENABLE
+  return sentence_case_check_ending(buffer);
+#else
+  return true;
+#endif  // SENTENCE_CASE_BUFFER_SIZE > 1
+}
+
 // Sets the current state to `new_state`.
 static void set_sentence_state(uint8_t new_state) {
 #if !defined(NO_DEBUG) && defined(SENTENCE_CASE_DEBUG)
@@ -80,9 +251,20 @@ static void set_sentence_state(uint8_t new_state) {
 
 static void clear_state_history(void) {
 #if SENTENCE_CASE_TIMEOUT > 0
+#ifdef IDLE_TIMEOUT_ENABLE
+  idle_timeout_cancel(&idle_timeout);
+#else
   idle_timer = 0;
+#endif  // IDLE_TIMEOUT_ENABLE
 #endif  // SENTENCE_CASE_TIMEOUT > 0
   memset(state_history, STATE_INIT, sizeof(state_history));
+#ifdef KEY_HISTORY_ENABLE
+  key_history_view_reset(&history_view);
+#endif  // KEY_HISTORY_ENABLE
+#ifdef SENTENCE_CASE_ABBREVIATIONS
+  abbrev_node = 0;
+  memset(abbrev_history, 0xff, sizeof(abbrev_history));  // ABBREV_NONE.
+#endif  // SENTENCE_CASE_ABBREVIATIONS
   if (sentence_state != STATE_DISABLED) {
     set_sentence_state(STATE_INIT);
   }
@@ -91,9 +273,10 @@ static void clear_state_history(void) {
 void sentence_case_clear(void) {
   clear_state_history();
   suppress_key = KC_NO;
-#if SENTENCE_CASE_BUFFER_SIZE > 1
+#ifdef OWN_KEY_BUFFER
   memset(key_buffer, 0, sizeof(key_buffer));
-#endif  // SENTENCE_CASE_BUFFER_SIZE > 1
+  key_buffer_start = 0;
+#endif  // OWN_KEY_BUFFER
 }
 
 void sentence_case_on(void) {
@@ -127,11 +310,17 @@ bool is_sentence_case_primed(void) { return sentence_state == STATE_PRIMED; }
 #error "sentence_case: SENTENCE_CASE_TIMEOUT must be between 100 and 30000 ms"
 #endif
 
+#ifdef IDLE_TIMEOUT_ENABLE
+static void idle_timeout_expired(void) {
+  clear_state_history();  // Timed out; clear all state.
+}
+#else
 void sentence_case_task(void) {
   if (idle_timer && timer_expired(timer_read(), idle_timer)) {
     clear_state_history();  // Timed out; clear all state.
   }
 }
+#endif  // IDLE_TIMEOUT_ENABLE
 #endif  // SENTENCE_CASE_TIMEOUT > 0
 
 bool process_sentence_case(uint16_t keycode, keyrecord_t* record) {
@@ -141,9 +330,20 @@ bool process_sentence_case(uint16_t keycode, keyrecord_t* record) {
   }
 
 #if SENTENCE_CASE_TIMEOUT > 0
+#ifdef IDLE_TIMEOUT_ENABLE
+  idle_timeout_start(&idle_timeout, SENTENCE_CASE_TIMEOUT);
+#else
   idle_timer = (record->event.time + SENTENCE_CASE_TIMEOUT) | 1;
+#endif  // IDLE_TIMEOUT_ENABLE
 #endif  // SENTENCE_CASE_TIMEOUT > 0
 
+#ifdef KEY_EVENT_ENABLE
+  const key_event_t* event = key_event_decode(keycode, record);
+  if (event->key_class == KEY_CLASS_NONE) {
+    return true;  // Ignore mods, layer switches, and held tap-hold keys.
+  }
+  keycode = event->keycode;
+#else
   switch (keycode) {
     case KC_LCTL ... KC_RGUI:  // Ignore mod keys.
     case QK_ONE_SHOT_MOD ... QK_ONE_SHOT_MOD_MAX:  // Ignore one-shot mod.
@@ -185,114 +385,105 @@ bool process_sentence_case(uint16_t keycode, keyrecord_t* record) {
       break;
 #endif  // SWAP_HANDS_ENABLE
   }
+#endif  // KEY_EVENT_ENABLE
 
   if (keycode == KC_BSPC) {
     // Backspace key pressed. Rewind the state and key buffers.
-    set_sentence_state(state_history[STATE_HISTORY_SIZE - 1]);
-
-    memmove(state_history + 1, state_history, STATE_HISTORY_SIZE - 1);
-    state_history[0] = STATE_INIT;
-#if SENTENCE_CASE_BUFFER_SIZE > 1
-    memmove(key_buffer + 1, key_buffer,
-            (SENTENCE_CASE_BUFFER_SIZE - 1) * sizeof(uint16_t));
-    key_buffer[0] = KC_NO;
-#endif  // SENTENCE_CASE_BUFFER_SIZE > 1
+    // The popped slot becomes the oldest entry.
+    state_history_end = (state_history_end - 1) & (STATE_HISTORY_SIZE - 1);
+    set_sentence_state(state_history[state_history_end]);
+    state_history[state_history_end] = STATE_INIT;
+#ifdef SENTENCE_CASE_ABBREVIATIONS
+    abbrev_node = abbrev_history[state_history_end];
+    abbrev_history[state_history_end] = ABBREV_NONE;
+#endif  // SENTENCE_CASE_ABBREVIATIONS
+#ifdef OWN_KEY_BUFFER
+    key_buffer_start = (key_buffer_start ? key_buffer_start
+                                         : SENTENCE_CASE_BUFFER_SIZE) - 1;
+    key_buffer[key_buffer_start] = KC_NO;
+    key_buffer[key_buffer_start + SENTENCE_CASE_BUFFER_SIZE] = KC_NO;
+#endif  // OWN_KEY_BUFFER
     return true;
   }
 
+#ifdef KEY_EVENT_ENABLE
+  const uint8_t mods = event->mods;
+#else
   const uint8_t mods = get_mods() | get_weak_mods() | get_oneshot_mods();
-  uint8_t new_state = STATE_INIT;
-
-  // We search for sentence beginnings using a simple finite state machine. It
-  // matches things like "a. a" and "a.  a" but not "a.. a" or "a.a. a". The
-  // state transition matrix is:
-  //
-  //             'a'       '.'      ' '      '\''
-  //           +-------------------------------------
-  //   INIT    | WORD      INIT     INIT     INIT
-  //   WORD    | WORD      ENDING   INIT     WORD
-  //   ABBREV  | ABBREV    ABBREV   INIT     ABBREV
-  //   ENDING  | ABBREV    INIT     PRIMED   ENDING
-  //   PRIMED  | match!    INIT     PRIMED   PRIMED
-  char code = sentence_case_press_user(keycode, record, mods);
+#endif  // KEY_EVENT_ENABLE
+  const char code = sentence_case_press_user(keycode, record, mods);
 #if defined SENTENCE_CASE_DEBUG
   dprintf("Sentence Case: code = '%c' (%d)\n", code, (int)code);
 #endif  // SENTENCE_CASE_DEBUG
+  uint8_t key_class;
   switch (code) {
     case '\0':  // Current key should be ignored.
       return true;
-
-    case 'a':  // Current key is a letter.
-      switch (sentence_state) {
-        case STATE_ABBREV:
-        case STATE_ENDING:
-          new_state = STATE_ABBREV;
-          break;
-
-        case STATE_PRIMED:
-          // This is the start of a sentence.
-          if (keycode != suppress_key) {
-            suppress_key = keycode;
-            set_oneshot_mods(MOD_BIT(KC_LSFT));  // Shift mod to capitalize.
-            new_state = STATE_WORD;
-          }
-          break;
-
-        default:
-          new_state = STATE_WORD;
-      }
+    case 'a':
+      key_class = CLASS_LETTER;
       break;
-
-    case '.':  // Current key is sentence-ending punctuation.
-      switch (sentence_state) {
-        case STATE_WORD:
-          new_state = STATE_ENDING;
-          break;
-
-        default:
-          new_state = STATE_ABBREV;
-      }
+    case '.':
+      key_class = CLASS_ENDING;
       break;
-
-    case ' ':  // Current key is a space.
-      if (sentence_state == STATE_PRIMED ||
-          (sentence_state == STATE_ENDING
-#if SENTENCE_CASE_BUFFER_SIZE > 1
-           && sentence_case_check_ending(key_buffer)
-#endif  // SENTENCE_CASE_BUFFER_SIZE > 1
-               )) {
-        new_state = STATE_PRIMED;
-        suppress_key = KC_NO;
-      }
+    case ' ':
+      key_class = CLASS_SPACE;
       break;
-
-    case '\'':  // Current key is a quote.
-      new_state = sentence_state;
+    case '\'':
+      key_class = CLASS_QUOTE;
       break;
+    default:
+      key_class = CLASS_SYMBOL;
   }
 
-    // Slide key_buffer and state_history buffers one element to the left.
-    // Optimization note: Using manual loops instead of memmove() here saved
-    // ~100 bytes on AVR.
-#if SENTENCE_CASE_BUFFER_SIZE > 1
-  for (int8_t i = 0; i < SENTENCE_CASE_BUFFER_SIZE - 1; ++i) {
-    key_buffer[i] = key_buffer[i + 1];
+#ifdef SENTENCE_CASE_ABBREVIATIONS
+  const uint16_t prev_abbrev_node = abbrev_node;
+  if (key_class != CLASS_SPACE && key_class != CLASS_SYMBOL) {
+    abbrev_node = abbrev_next(abbrev_node, keycode);
   }
-#endif  // SENTENCE_CASE_BUFFER_SIZE > 1
-  for (int8_t i = 0; i < STATE_HISTORY_SIZE - 1; ++i) {
-    state_history[i] = state_history[i + 1];
+#endif  // SENTENCE_CASE_ABBREVIATIONS
+
+  const uint8_t transition =
+      pgm_read_byte(&transitions[sentence_state][key_class]);
+  uint8_t new_state = transition & STATE_MASK;
+  if ((transition & FLAG_CAPITALIZE) != 0) {
+    // This is the start of a sentence.
+    if (keycode != suppress_key) {
+      suppress_key = keycode;
+      set_oneshot_mods(MOD_BIT(KC_LSFT));  // Shift mod to capitalize.
+    } else {
+      new_state = STATE_INIT;
+    }
+  }
+  if ((transition & FLAG_CHECK_ENDING) != 0 && !is_real_ending(false)) {
+    new_state = STATE_INIT;
+  }
+  if ((transition & FLAG_UNSUPPRESS) != 0 && new_state != STATE_INIT) {
+    suppress_key = KC_NO;
   }
 
-#if SENTENCE_CASE_BUFFER_SIZE > 1
-  key_buffer[SENTENCE_CASE_BUFFER_SIZE - 1] = keycode;
-  if (new_state == STATE_ENDING && !sentence_case_check_ending(key_buffer)) {
+  // Push the key and the current state. The key overwrites the oldest key in
+  // both copies of the ring buffer.
+#ifdef OWN_KEY_BUFFER
+  key_buffer[key_buffer_start] = keycode;
+  key_buffer[key_buffer_start + SENTENCE_CASE_BUFFER_SIZE] = keycode;
+  if (++key_buffer_start >= SENTENCE_CASE_BUFFER_SIZE) {
+    key_buffer_start = 0;
+  }
+#endif  // OWN_KEY_BUFFER
+  if (new_state == STATE_ENDING && !is_real_ending(true)) {
 #if defined SENTENCE_CASE_DEBUG
     dprintf("Not a real ending.\n");
 #endif  // SENTENCE_CASE_DEBUG
     new_state = STATE_INIT;
   }
-#endif  // SENTENCE_CASE_BUFFER_SIZE > 1
-  state_history[STATE_HISTORY_SIZE - 1] = sentence_state;
+  state_history[state_history_end] = sentence_state;
+#ifdef SENTENCE_CASE_ABBREVIATIONS
+  abbrev_history[state_history_end] = prev_abbrev_node;
+  if (key_class == CLASS_SPACE || key_class == CLASS_SYMBOL) {
+    abbrev_node = 0;  // The next key begins a new word.
+  }
+#endif  // SENTENCE_CASE_ABBREVIATIONS
+  state_history_end = (state_history_end + 1) & (STATE_HISTORY_SIZE - 1);
 
   set_sentence_state(new_state);
   return true;
@@ -37,6 +37,17 @@
  * detected as not real sentence endings. You can use the callback
  * `sentence_case_check_ending()` to define other exceptions.
  *
+ * For a longer list of exceptions, list abbreviations like "dr." one per line
+ * in a file sentence_case_abbrev_dict.txt, then generate
+ * sentence_case_abbrev_data.h from it with make_sentence_case_abbrev_data.py
+ * and define in config.h
+ *
+ *     #define SENTENCE_CASE_ABBREVIATIONS
+ *
+ * The abbreviations are compiled into a trie that is walked one key at a time
+ * as the word is typed, so checking them costs the same per key however many
+ * abbreviations there are.
+ *
  * @note One-shot keys must be enabled.
  *
  * For full documentation, see
@@ -70,10 +81,11 @@ bool process_sentence_case(uint16_t keycode, keyrecord_t* record);
  * Matrix task function for Sentence Case.
  *
  * If using `SENTENCE_CASE_TIMEOUT`, call this function from your
- * `housekeeping_task_user()` function in keymap.c. (If no timeout is set,
+ * `housekeeping_task_user()` function in keymap.c. (If no timeout is set, or
+ * if the timeout is handled by Idle Timeout with `IDLE_TIMEOUT_ENABLE`,
  * calling `sentence_case_task()` has no effect.)
  */
-#if SENTENCE_CASE_TIMEOUT > 0
+#if SENTENCE_CASE_TIMEOUT > 0 && !defined(IDLE_TIMEOUT_ENABLE)
 void sentence_case_task(void);
 #else
 static inline void sentence_case_task(void) {}
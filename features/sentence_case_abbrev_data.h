@@ -0,0 +1,34 @@
+// Copyright 2025 Google LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     https://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+// Generated code.
+
+// Sentence Case abbreviations (18 entries):
+//   approx. cf. dept. dr. e.g. eq. etc. fig. i.e. jr. misc. mr. mrs. ms. prof.
+//   sr. st. vs.
+
+static const uint8_t sentence_case_abbrev_data[245] PROGMEM = {11, 4, 34, 0, 6,
+  59, 0, 7, 68, 0, 8, 93, 0, 9, 126, 0, 12, 139, 0, 13, 152, 0, 16, 161, 0, 19,
+  202, 0, 22, 219, 0, 25, 236, 0, 1, 19, 38, 0, 1, 19, 42, 0, 1, 21, 46, 0, 1,
+  18, 50, 0, 1, 27, 54, 0, 1, 55, 58, 0, 128, 1, 9, 63, 0, 1, 55, 67, 0, 128, 2,
+  8, 75, 0, 21, 88, 0, 1, 19, 79, 0, 1, 23, 83, 0, 1, 55, 87, 0, 128, 1, 55, 92,
+  0, 128, 3, 55, 103, 0, 20, 112, 0, 23, 117, 0, 1, 10, 107, 0, 1, 55, 111, 0,
+  128, 1, 55, 116, 0, 128, 1, 6, 121, 0, 1, 55, 125, 0, 128, 1, 12, 130, 0, 1,
+  10, 134, 0, 1, 55, 138, 0, 128, 1, 55, 143, 0, 1, 8, 147, 0, 1, 55, 151, 0,
+  128, 1, 21, 156, 0, 1, 55, 160, 0, 128, 3, 12, 171, 0, 21, 184, 0, 22, 197, 0,
+  1, 22, 175, 0, 1, 6, 179, 0, 1, 55, 183, 0, 128, 2, 55, 191, 0, 22, 192, 0,
+  128, 1, 55, 196, 0, 128, 1, 55, 201, 0, 128, 1, 21, 206, 0, 1, 18, 210, 0, 1,
+  9, 214, 0, 1, 55, 218, 0, 128, 2, 21, 226, 0, 23, 231, 0, 1, 55, 230, 0, 128,
+  1, 55, 235, 0, 128, 1, 22, 240, 0, 1, 55, 244, 0, 128};
+
@@ -22,10 +22,20 @@
 
 #include "socd_cleaner.h"
 
+#include <string.h>
+
+#ifdef REPORT_COALESCE_ENABLE
+#include "report_coalesce.h"
+#endif  // REPORT_COALESCE_ENABLE
+
 #ifdef __cplusplus
 extern "C" {
 #endif
 
+#if SOCD_CLEANER_GROUP_MAX_KEYS < 1 || SOCD_CLEANER_GROUP_MAX_KEYS > 8
+#error "SOCD_CLEANER_GROUP_MAX_KEYS must be between 1 and 8."
+#endif
+
 bool socd_cleaner_enabled = true;
 
 static void update_key(uint8_t keycode, bool press) {
@@ -36,6 +46,42 @@ static void update_key(uint8_t keycode, bool press) {
   }
 }
 
+#ifdef SOCD_CLEANER_STATS
+socd_cleaner_stats_t socd_cleaner_stats = {0};
+
+void socd_cleaner_stats_reset(void) {
+  memset(&socd_cleaner_stats, 0, sizeof(socd_cleaner_stats));
+}
+
+static void count_event(void) {
+  if (socd_cleaner_stats.events < UINT32_MAX) {
+    ++socd_cleaner_stats.events;
+  }
+}
+#else
+#define count_event()
+#endif  // SOCD_CLEANER_STATS
+
+// Sends the report for the changes from `record`. With the fast path, it is
+// sent now even if report coalescing is enabled.
+static void send_report(const keyrecord_t* record) {
+#if defined(REPORT_COALESCE_ENABLE) && !defined(SOCD_CLEANER_FAST_PATH)
+  report_coalesce_mark_dirty();
+#else
+  send_keyboard_report();
+#endif  // defined(REPORT_COALESCE_ENABLE) && !defined(SOCD_CLEANER_FAST_PATH)
+#ifdef SOCD_CLEANER_STATS
+  const uint16_t latency = timer_elapsed(record->event.time);
+  if (socd_cleaner_stats.reports < UINT32_MAX) {
+    ++socd_cleaner_stats.reports;
+    socd_cleaner_stats.total_latency_ms += latency;
+  }
+  if (latency > socd_cleaner_stats.max_latency_ms) {
+    socd_cleaner_stats.max_latency_ms = latency;
+  }
+#endif  // SOCD_CLEANER_STATS
+}
+
 bool process_socd_cleaner(uint16_t keycode, keyrecord_t* record,
                           socd_cleaner_t* state) {
   if (!socd_cleaner_enabled || !state->resolution ||
@@ -48,6 +94,7 @@ bool process_socd_cleaner(uint16_t keycode, keyrecord_t* record,
 
   // Track which keys are physically held (vs. keys in the report).
   state->held[i] = record->event.pressed;
+  count_event();
 
   // Perform SOCD resolution for events where the opposing key is held.
   if (state->held[opposing]) {
@@ -63,7 +110,7 @@ bool process_socd_cleaner(uint16_t keycode, keyrecord_t* record,
         // the current key has no effect while the opposing key is held.
         update_key(state->keys[opposing], !state->held[i]);
         // Send updated report (normally, default handling would do this).
-        send_keyboard_report();
+        send_report(record);
         return false;  // Skip default handling.
 
       case SOCD_CLEANER_0_WINS:  // Key 0 wins.
@@ -78,5 +125,138 @@ bool process_socd_cleaner(uint16_t keycode, keyrecord_t* record,
         break;
     }
   }
+#ifdef SOCD_CLEANER_FAST_PATH
+  // Press/release the current key and send the report now, skipping the
+  // remaining handlers and default handling.
+  update_key(keycode, record->event.pressed);
+  send_report(record);
+  return false;
+#else
   return true;  // Continue default handling to press/release current key.
+#endif  // SOCD_CLEANER_FAST_PATH
+}
+
+static socd_cleaner_group_t* groups = NULL;
+static uint8_t num_groups = 0;
+// Bitmap over basic keycodes of which keys are in some group.
+static uint8_t group_keys[256 / 8] = {0};
+
+void socd_cleaner_set_groups(socd_cleaner_group_t* new_groups,
+                             uint8_t new_num_groups) {
+  groups = new_groups;
+  num_groups = new_num_groups;
+  memset(group_keys, 0, sizeof(group_keys));
+  for (uint8_t g = 0; g < num_groups; ++g) {
+    for (uint8_t i = 0; i < SOCD_CLEANER_GROUP_MAX_KEYS; ++i) {
+      const uint8_t key = groups[g].keys[i];
+      if (key != KC_NO) {
+        group_keys[key / 8] |= 1 << (key % 8);
+      }
+    }
+  }
+}
+
+// Determines which key on `axis` to send given the held keys, as a bitmask.
+static uint8_t resolve_axis(const socd_cleaner_group_t* group, uint8_t axis) {
+  int8_t winner = -1;
+  uint8_t num_held = 0;
+  for (uint8_t i = 0; i < SOCD_CLEANER_GROUP_MAX_KEYS; ++i) {
+    if (!(group->held & (1 << i)) || group->axes[i] != axis) {
+      continue;
+    }
+    ++num_held;
+    switch (group->resolution) {
+      case SOCD_CLEANER_LAST:  // The most recent press wins.
+        if (winner < 0 || group->order[i] < group->order[winner]) {
+          winner = i;
+        }
+        break;
+      case SOCD_CLEANER_0_WINS:  // The first key listed wins.
+        if (winner < 0) {
+          winner = i;
+        }
+        break;
+      default:  // The last key listed wins. Also used by neutral resolution.
+        winner = i;
+        break;
+    }
+  }
+  if (winner < 0 ||
+      (group->resolution == SOCD_CLEANER_NEUTRAL && num_held > 1)) {
+    return 0;
+  }
+  return 1 << winner;
+}
+
+// Updates the held keys and their press order for a press or release of key
+// `i`. The held keys' orders are kept as 0, 1, ..., (number held - 1).
+static void update_order(socd_cleaner_group_t* group, uint8_t i, bool press) {
+  for (uint8_t j = 0; j < SOCD_CLEANER_GROUP_MAX_KEYS; ++j) {
+    if (j == i || !(group->held & (1 << j))) {
+      continue;
+    }
+    if (press) {
+      ++group->order[j];
+    } else if (group->order[j] > group->order[i]) {
+      --group->order[j];
+    }
+  }
+  if (press) {
+    group->held |= 1 << i;
+    group->order[i] = 0;
+  } else {
+    group->held &= ~(1 << i);
+  }
+}
+
+bool process_socd_cleaner_groups(uint16_t keycode, keyrecord_t* record) {
+  if (keycode > 0xff || !(group_keys[keycode / 8] & (1 << (keycode % 8)))) {
+    return true;  // Quick return on unrelated events.
+  }
+
+  for (uint8_t g = 0; g < num_groups; ++g) {
+    socd_cleaner_group_t* group = &groups[g];
+    for (uint8_t i = 0; i < SOCD_CLEANER_GROUP_MAX_KEYS; ++i) {
+      if (group->keys[i] != keycode) {
+        continue;
+      }
+      // The current event corresponds to index `i` in this group.
+      const uint8_t bit = 1 << i;
+      if (record->event.pressed == !!(group->held & bit)) {
+        return true;  // Ignore a repeated press or release.
+      }
+      update_order(group, i, record->event.pressed);
+
+      if (!socd_cleaner_enabled || !group->resolution) {
+        // Default handling sends the key as held. Track it so that cleaning
+        // picks up correctly if enabled later.
+        group->sent = (group->sent & ~bit) | (group->held & bit);
+        return true;
+      }
+      count_event();
+
+      // Resolve the current key's axis, and update the report with changes.
+      const uint8_t axis = group->axes[i];
+      uint8_t axis_mask = 0;
+      for (uint8_t j = 0; j < SOCD_CLEANER_GROUP_MAX_KEYS; ++j) {
+        if (group->axes[j] == axis) {
+          axis_mask |= 1 << j;
+        }
+      }
+      const uint8_t sent = (group->sent & ~axis_mask) |
+                           resolve_axis(group, axis);
+      const uint8_t changed = group->sent ^ sent;
+      if (changed) {
+        for (uint8_t j = 0; j < SOCD_CLEANER_GROUP_MAX_KEYS; ++j) {
+          if (changed & (1 << j)) {
+            update_key(group->keys[j], sent & (1 << j));
+          }
+        }
+        group->sent = sent;
+        send_report(record);
+      }
+      return false;  // Skip default handling.
+    }
+  }
+  return true;
 }
@@ -90,6 +90,64 @@
  * assigning to `.resolution`.
  *
  *
+ * Groups of more than two keys
+ * ----------------------------
+ *
+ * A `socd_cleaner_group_t` filters up to `SOCD_CLEANER_GROUP_MAX_KEYS` (8)
+ * keys in one place. Each key is assigned an axis, and keys on the same axis
+ * oppose one another. WASD is one group with two axes:
+ *
+ *     socd_cleaner_group_t socd_groups[] = {
+ *       {.keys = {KC_W, KC_S, KC_A, KC_D},
+ *        .axes = {0, 0, 1, 1},
+ *        .resolution = SOCD_CLEANER_LAST},
+ *     };
+ *
+ *     void keyboard_post_init_user(void) {
+ *       socd_cleaner_set_groups(socd_groups, ARRAY_SIZE(socd_groups));
+ *     }
+ *
+ *     bool process_record_user(uint16_t keycode, keyrecord_t* record) {
+ *       if (!process_socd_cleaner_groups(keycode, record)) { return false; }
+ *       // Your macros...
+ *       return true;
+ *     }
+ *
+ * Putting all keys on axis 0 makes a radial or lane set in which at most one
+ * key is sent at a time. With more than two keys on an axis, the resolutions
+ * generalize as: SOCD_CLEANER_LAST reactivates the most recently pressed key
+ * still held, SOCD_CLEANER_NEUTRAL sends nothing while two or more are held,
+ * SOCD_CLEANER_0_WINS favors keys listed earlier, and SOCD_CLEANER_1_WINS
+ * favors keys listed later.
+ *
+ * Unlike `process_socd_cleaner()`, grouped keys are added to and removed from
+ * the report by the group handler, so each event sends one report however many
+ * keys it changes. The handler skips other processing of keys in the groups.
+ * The groups are indexed by `socd_cleaner_set_groups()`, so that unrelated
+ * events return after a single bit test. Call it again after changing `.keys`.
+ * The resolution may be changed at any time.
+ *
+ *
+ * Fast path and stats
+ * -------------------
+ *
+ * By default, `process_socd_cleaner()` lets QMK's default handling press or
+ * release the current key, after the rest of `process_record_user()` has run,
+ * and reports are coalesced if `REPORT_COALESCE_ENABLE` is defined. For the
+ * least latency, define in config.h
+ *
+ *     #define SOCD_CLEANER_FAST_PATH
+ *
+ * Then events on SOCD keys are handled entirely by SOCD Cleaner, which sends
+ * the report immediately and skips the remaining handlers. Call the SOCD
+ * Cleaner handlers first in `process_record_user()`.
+ *
+ * Define `SOCD_CLEANER_STATS` to count events and reports in
+ * `socd_cleaner_stats`, with the time from each event's matrix scan to its
+ * report. Each report sent should correspond to exactly one event. Without
+ * the fast path, reports do not count those sent by default handling.
+ *
+ *
  * For full documentation, see
  * <https://getreuer.info/posts/keyboards/socd-cleaner>
  */
@@ -123,6 +181,23 @@ typedef struct {
   bool held[2];  // Tracks which keys are physically held.
 } socd_cleaner_t;
 
+#ifndef SOCD_CLEANER_GROUP_MAX_KEYS
+#define SOCD_CLEANER_GROUP_MAX_KEYS 8
+#endif  // SOCD_CLEANER_GROUP_MAX_KEYS
+
+typedef struct {
+  // Basic keycodes in the group. Unused entries are KC_NO.
+  uint8_t keys[SOCD_CLEANER_GROUP_MAX_KEYS];
+  // Axis of each key. Keys on the same axis oppose one another.
+  uint8_t axes[SOCD_CLEANER_GROUP_MAX_KEYS];
+  uint8_t resolution;  // Resolution strategy.
+  uint8_t held;  // Bitmask of keys that are physically held.
+  uint8_t sent;  // Bitmask of keys in the report.
+  // Press order of the held keys, 0 for the most recent, 1 for the one before,
+  // and so on.
+  uint8_t order[SOCD_CLEANER_GROUP_MAX_KEYS];
+} socd_cleaner_group_t;
+
 /**
  * Handler function for SOCD cleaner.
  *
@@ -133,9 +208,43 @@ typedef struct {
 bool process_socd_cleaner(uint16_t keycode, keyrecord_t* record,
                           socd_cleaner_t* state);
 
+/**
+ * Sets the SOCD cleaner groups handled by `process_socd_cleaner_groups()`.
+ *
+ * The groups are used in place. Call this again after changing their keys.
+ */
+void socd_cleaner_set_groups(socd_cleaner_group_t* groups, uint8_t num_groups);
+
+/**
+ * Handler function for SOCD cleaner groups.
+ *
+ * This function should be called from process_record_user(), after the groups
+ * are set with `socd_cleaner_set_groups()`.
+ */
+bool process_socd_cleaner_groups(uint16_t keycode, keyrecord_t* record);
+
 /** Determines globally whether SOCD cleaner is enabled. */
 extern bool socd_cleaner_enabled;
 
+#ifdef SOCD_CLEANER_STATS
+/** Counters of SOCD Cleaner's events and reports. */
+typedef struct {
+  /** Number of events on SOCD keys while enabled. */
+  uint32_t events;
+  /** Number of reports sent by SOCD Cleaner. */
+  uint32_t reports;
+  /** Sum over reports of ms from the event's matrix scan to the report. */
+  uint32_t total_latency_ms;
+  /** Maximum ms from an event's matrix scan to its report. */
+  uint16_t max_latency_ms;
+} socd_cleaner_stats_t;
+
+extern socd_cleaner_stats_t socd_cleaner_stats;
+
+/** Resets `socd_cleaner_stats` to zero. */
+void socd_cleaner_stats_reset(void);
+#endif  // SOCD_CLEANER_STATS
+
 #ifdef __cplusplus
 }
 #endif
@@ -0,0 +1,140 @@
+// Copyright 2025 Google LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     https://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+/**
+ * @file tap_queue.c
+ * @brief Tap queue implementation
+ */
+
+#include "tap_queue.h"
+
+#if (TAP_QUEUE_SIZE & (TAP_QUEUE_SIZE - 1)) != 0 || TAP_QUEUE_SIZE > 128
+#error "TAP_QUEUE_SIZE must be a power of 2, at most 128."
+#endif
+
+// Queued actions are keycodes to tap, or one of the following in the high byte
+// with mods in the low byte.
+#define ACTION_REGISTER_MODS 0xE000
+#define ACTION_UNREGISTER_MODS 0xE100
+
+static uint16_t queue[TAP_QUEUE_SIZE] = {0};
+static uint8_t queue_start = 0;
+static uint8_t queue_size = 0;
+// Keycode whose tap has been pressed and is to be released next, or KC_NO.
+static uint16_t held_keycode = KC_NO;
+static uint16_t action_timer = 0;
+
+// Sends the next report: releases the held tap, or performs the next action.
+static void step(void) {
+  if (held_keycode != KC_NO) {
+    unregister_code16(held_keycode);
+    held_keycode = KC_NO;
+    return;
+  }
+
+  const uint16_t action = queue[queue_start];
+  queue_start = (queue_start + 1) & (TAP_QUEUE_SIZE - 1);
+  --queue_size;
+
+  switch (action & 0xff00) {
+    case ACTION_REGISTER_MODS:
+      register_mods((uint8_t)action);
+      break;
+    case ACTION_UNREGISTER_MODS:
+      unregister_mods((uint8_t)action);
+      break;
+    default:
+      register_code16(action);
+      held_keycode = action;
+  }
+}
+
+static void enqueue(uint16_t action) {
+  while (queue_size >= TAP_QUEUE_SIZE) {  // If full, send to make room.
+    step();
+    wait_ms(TAP_QUEUE_INTERVAL_MS);
+  }
+  if (tap_queue_is_empty()) {
+    // Send the first action on the next task call.
+    action_timer = timer_read() - TAP_QUEUE_INTERVAL_MS;
+  }
+  queue[(queue_start + queue_size) & (TAP_QUEUE_SIZE - 1)] = action;
+  ++queue_size;
+}
+
+bool process_tap_queue(uint16_t keycode, keyrecord_t* record) {
+  // Flush on releases too, since releasing a mod would otherwise change the
+  // mods on the remaining queued taps.
+  if (!tap_queue_is_empty()) {
+    tap_queue_flush();
+  }
+  return true;
+}
+
+void tap_queue_task(void) {
+  if (!tap_queue_is_empty() &&
+      timer_elapsed(action_timer) >= TAP_QUEUE_INTERVAL_MS) {
+    step();
+    action_timer = timer_read();
+  }
+}
+
+void tap_queue_tap(uint16_t keycode) {
+  if (keycode != KC_NO) {
+    enqueue(keycode);
+  }
+}
+
+void tap_queue_register_mods(uint8_t mods) {
+  enqueue(ACTION_REGISTER_MODS | mods);
+}
+
+void tap_queue_unregister_mods(uint8_t mods) {
+  enqueue(ACTION_UNREGISTER_MODS | mods);
+}
+
+void tap_queue_send_char(char c) {
+  if ((uint8_t)c >= 128) {
+    return;
+  }
+  uint16_t keycode = pgm_read_byte(&ascii_to_keycode_lut[(uint8_t)c]);
+  if (PGM_LOADBIT(ascii_to_shift_lut, (uint8_t)c)) {
+    keycode = S(keycode);
+  }
+  if (PGM_LOADBIT(ascii_to_altgr_lut, (uint8_t)c)) {
+    keycode = RALT(keycode);
+  }
+  tap_queue_tap(keycode);
+}
+
+void tap_queue_send_string_P(const char* str) {
+  char c;
+  while ((c = (char)pgm_read_byte(str++))) {
+    tap_queue_send_char(c);
+  }
+}
+
+void tap_queue_flush(void) {
+  while (!tap_queue_is_empty()) {
+    step();
+    if (!tap_queue_is_empty()) {
+      wait_ms(TAP_QUEUE_INTERVAL_MS);
+    }
+  }
+  action_timer = timer_read();
+}
+
+bool tap_queue_is_empty(void) {
+  return queue_size == 0 && held_keycode == KC_NO;
+}
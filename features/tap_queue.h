@@ -0,0 +1,143 @@
+// Copyright 2025 Google LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     https://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+/**
+ * @file tap_queue.h
+ * @brief Tap queue: send key taps and strings without blocking.
+ *
+ * Overview
+ * --------
+ *
+ * QMK's `tap_code()` and `send_string()` send each key tap immediately,
+ * waiting `TAP_CODE_DELAY` or the given interval between reports. A long macro
+ * or correction blocks the keyboard for that time, during which the matrix is
+ * not scanned.
+ *
+ * This library instead queues the taps and sends them from the housekeeping
+ * task, one report every `TAP_QUEUE_INTERVAL_MS` milliseconds, while the
+ * keyboard keeps scanning. When a key is pressed or released while taps are
+ * pending, the pending taps are first sent right away so that output stays in
+ * order and the taps keep the mods they were queued with.
+ *
+ * @note This flush blocks, waiting `TAP_QUEUE_INTERVAL_MS` between reports as
+ * `send_string()` would, so a key typed during a long correction is still
+ * delayed until the correction is sent. The queue only avoids blocking while
+ * no other key is touched.
+ *
+ * Strings are mapped to keycodes with QMK's send_string lookup tables, so
+ * sendstring_*.h language headers apply. Only plain text is supported, not
+ * `SS_TAP()`-style sequences.
+ *
+ *
+ * Usage
+ * -----
+ *
+ * In your keymap.c, call the handler and the task as follows:
+ *
+ *     #include "features/tap_queue.h"
+ *
+ *     bool process_record_user(uint16_t keycode, keyrecord_t* record) {
+ *       if (!process_tap_queue(keycode, record)) { return false; }
+ *       // Your macros ...
+ *
+ *       return true;
+ *     }
+ *
+ *     void housekeeping_task_user(void) {
+ *       tap_queue_task();
+ *       // Other tasks ...
+ *     }
+ *
+ * Then, in place of `tap_code16()` and `send_string_P()`, call
+ * `tap_queue_tap()` and `tap_queue_send_string_P()`, for instance:
+ *
+ *     case MY_MACRO:
+ *       if (record->event.pressed) {
+ *         tap_queue_send_string_P(PSTR("Hello, world!"));
+ *       }
+ *       return false;
+ *
+ * In your rules.mk, add the source file:
+ *
+ *     SRC += features/tap_queue.c
+ *
+ * @note Queued output is sent after the current event has been processed. When
+ * the key being processed is itself sent to the host, output that must come
+ * before it should be followed by `tap_queue_flush()`.
+ */
+
+#pragma once
+
+#include "quantum.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/** Capacity of the queue in actions. Must be a power of 2, at most 128. */
+#ifndef TAP_QUEUE_SIZE
+#define TAP_QUEUE_SIZE 32
+#endif  // TAP_QUEUE_SIZE
+
+/**
+ * Milliseconds between reports sent by the queue, that is, between the press
+ * and release of a tap and between successive taps.
+ */
+#ifndef TAP_QUEUE_INTERVAL_MS
+#if defined(TAP_CODE_DELAY) && TAP_CODE_DELAY > 0
+#define TAP_QUEUE_INTERVAL_MS TAP_CODE_DELAY
+#else
+#define TAP_QUEUE_INTERVAL_MS 1
+#endif
+#endif  // TAP_QUEUE_INTERVAL_MS
+
+/**
+ * Handler function for the tap queue.
+ *
+ * On key press or release, sends any pending taps right away, blocking, so that
+ * they come before the event. This function always returns true.
+ */
+bool process_tap_queue(uint16_t keycode, keyrecord_t* record);
+
+/** Task function for the tap queue. Sends the next report when it is due. */
+void tap_queue_task(void);
+
+/**
+ * Queues a tap of `keycode`, which is a basic keycode or a modified basic
+ * keycode like `S(KC_1)`. If the queue is full, the oldest pending taps are
+ * sent right away to make room.
+ */
+void tap_queue_tap(uint16_t keycode);
+
+/** Queues registering `mods`, a bitfield like `MOD_BIT(KC_LSFT)`. */
+void tap_queue_register_mods(uint8_t mods);
+
+/** Queues unregistering `mods`, a bitfield like `MOD_BIT(KC_LSFT)`. */
+void tap_queue_unregister_mods(uint8_t mods);
+
+/** Queues a tap of ASCII character `c`. */
+void tap_queue_send_char(char c);
+
+/** Queues taps to type PROGMEM string `str`. */
+void tap_queue_send_string_P(const char* str);
+
+/** Sends all pending taps, blocking until done. */
+void tap_queue_flush(void);
+
+/** Returns true if no taps are pending. */
+bool tap_queue_is_empty(void);
+
+#ifdef __cplusplus
+}
+#endif
@@ -22,18 +22,25 @@
  * -----------------
  *  * features/achordion.h: customize the tap-hold decision
  *  * features/autocorrection.h: run rudimentary autocorrection on your keyboard
+ *  * features/autofire.h: pulse keys periodically on a shared timer
  *  * features/caps_word.h: modern alternative to Caps Lock
  *  * features/custom_shift_keys.h: they're surprisingly tricky to get right;
  *                                  here is my approach
+ *  * features/event_trace.h: compact binary log of key events
+ *  * features/idle_timeout.h: shared deadlines for features that time out
+ *  * features/key_stats.h: count key presses and same-hand bigrams
  *  * features/keycode_string.h: format keycodes as human-readable strings
  *  * features/layer_lock.h: macro to stay in the current layer
  *  * features/mouse_turbo_click.h: macro that clicks the mouse rapidly
  *  * features/orbital_mouse.h: a polar approach to mouse key control
  *  * features/palettefx.h: palette-based animated RGB matrix lighting effects
+ *  * features/profiler.h: measure cycles spent in keymap handlers and tasks
  *  * features/repeat_key.h: a "repeat last key" implementation
+ *  * features/report_coalesce.h: combine report changes into one report
  *  * features/sentence_case.h: capitalize first letter of sentences
  *  * features/select_word.h: macro for convenient word or line selection
  *  * features/socd_cleaner.h: enhance WASD for fast inputs for gaming
+ *  * features/tap_queue.h: send key taps and strings without blocking
  *
  * License
  * -------
@@ -50,6 +57,21 @@
 #ifdef CUSTOM_SHIFT_KEYS_ENABLE
 #include "features/custom_shift_keys.h"
 #endif  // CUSTOM_SHIFT_KEYS_ENABLE
+#ifdef EVENT_TRACE_ENABLE
+#include "features/event_trace.h"
+#endif  // EVENT_TRACE_ENABLE
+#ifdef IDLE_TIMEOUT_ENABLE
+#include "features/idle_timeout.h"
+#endif  // IDLE_TIMEOUT_ENABLE
+#ifdef KEY_EVENT_ENABLE
+#include "features/key_event.h"
+#endif  // KEY_EVENT_ENABLE
+#ifdef KEY_HISTORY_ENABLE
+#include "features/key_history.h"
+#endif  // KEY_HISTORY_ENABLE
+#ifdef KEY_STATS_ENABLE
+#include "features/key_stats.h"
+#endif  // KEY_STATS_ENABLE
 #ifdef KEYCODE_STRING_ENABLE
 #include "features/keycode_string.h"
 #endif  // KEYCODE_STRING_ENABLE
@@ -59,9 +81,18 @@
 #ifdef RGB_MATRIX_CUSTOM_USER
 #include "features/palettefx.h"
 #endif  // RGB_MATRIX_CUSTOM_USER
+#ifdef PROFILER_ENABLE
+#include "features/profiler.h"
+#endif  // PROFILER_ENABLE
+#ifdef REPORT_COALESCE_ENABLE
+#include "features/report_coalesce.h"
+#endif  // REPORT_COALESCE_ENABLE
 #ifdef SENTENCE_CASE_ENABLE
 #include "features/sentence_case.h"
 #endif  // SENTENCE_CASE_ENABLE
+#ifdef TAP_QUEUE_ENABLE
+#include "features/tap_queue.h"
+#endif  // TAP_QUEUE_ENABLE
 #if __has_include("user_song_list.h")
 #include "user_song_list.h"
 #endif
@@ -77,6 +108,7 @@ enum layers {
 enum custom_keycodes {
   ARROW = SAFE_RANGE,
   DASH,
+  PROFILE,
   RGB_DEF,
   SELLINE,
   SRCHSEL,
@@ -177,16 +209,21 @@ combo_t key_combos[] = {
 // Custom shift keys (https://getreuer.info/posts/keyboards/custom-shift-keys)
 ///////////////////////////////////////////////////////////////////////////////
 #ifdef CUSTOM_SHIFT_KEYS_ENABLE
-const custom_shift_key_t custom_shift_keys[] = {
-    {KC_DOT, KC_QUES},
-    {KC_COMM, KC_EXLM},
-    {HOME_SC, KC_AT  },
-    {KC_MPLY, KC_MNXT},
+// Sorted by keycode for CUSTOM_SHIFT_KEYS_SORTED.
+const custom_shift_key_t base_shift_keys[] PROGMEM = {
     {KC_EQL , KC_EQL },  // Don't shift =
+    {KC_COMM, KC_EXLM},
+    {KC_DOT , KC_QUES},
     {KC_SLSH, KC_SLSH},  // Don't shift /
+    {KC_MPLY, KC_MNXT},
+    {HOME_SC, KC_AT  },
 };
-uint8_t NUM_CUSTOM_SHIFT_KEYS =
-    sizeof(custom_shift_keys) / sizeof(custom_shift_key_t);
+
+const custom_shift_keys_layer_t custom_shift_keys_layers[] PROGMEM = {
+    [BASE] = CUSTOM_SHIFT_KEYS_LAYER(base_shift_keys),
+};
+uint8_t NUM_CUSTOM_SHIFT_KEYS_LAYERS =
+    sizeof(custom_shift_keys_layers) / sizeof(custom_shift_keys_layer_t);
 #endif  // CUSTOM_SHIFT_KEYS_ENABLE
 
 ///////////////////////////////////////////////////////////////////////////////
@@ -219,27 +256,22 @@ uint16_t get_quick_tap_term(uint16_t keycode, keyrecord_t* record) {
 // Achordion (https://getreuer.info/posts/keyboards/achordion)
 ///////////////////////////////////////////////////////////////////////////////
 #ifdef ACHORDION_ENABLE
+#ifdef ACHORDION_HAND_LAYOUT
+// Handedness of each key, defined in layout.h for each keyboard.
+const char achordion_hand_layout[MATRIX_ROWS][MATRIX_COLS] PROGMEM =
+    ACHORDION_HAND_LAYOUT_LR;
+#endif  // ACHORDION_HAND_LAYOUT
+
 bool achordion_chord(uint16_t tap_hold_keycode,
                      keyrecord_t* tap_hold_record,
                      uint16_t other_keycode,
                      keyrecord_t* other_record) {
-  // Also allow same-hand holds when the other key is in the rows outside the
-  // alphas. I need the `% (MATRIX_ROWS / 2)` because my keyboards are split.
-  uint8_t row = other_record->event.key.row % (MATRIX_ROWS / 2);
-  if (!(1 <= row && row <= 3)) { return true; }
-
-  switch (tap_hold_keycode) {
-    // Exceptionally allow symbol layer LTs + row 0 in same-hand chords.
-    case HOME_S:
-    case HOME_I:
-      if (row == 0) { return true; }
-      break;
-    // Exceptionally allow G + J as a same-hand chord.
-    case NUM_G:
-      if (other_keycode == KC_J) { return true; }
-      break;
-  }
+  // Exceptionally allow G + J as a same-hand chord.
+  if (tap_hold_keycode == NUM_G && other_keycode == KC_J) { return true; }
 
+  // Otherwise, allow holds with keys on the opposite hand. Keys in the rows
+  // outside the alphas are exempt ('*' in ACHORDION_HAND_LAYOUT_LR), so that
+  // same-hand holds are allowed with them.
   return achordion_opposite_hands(tap_hold_record, other_record);
 }
 
@@ -285,12 +317,41 @@ uint16_t achordion_streak_chord_timeout(
 // Autocorrect (https://docs.qmk.fm/features/autocorrect)
 ///////////////////////////////////////////////////////////////////////////////
 #ifdef AUTOCORRECT_ENABLE
+#ifdef TAP_QUEUE_ENABLE
+// Whether the key being processed is sent after an autocorrection, which is
+// the case for word breaks.
+static bool autocorrect_sends_key = false;
+
+bool process_autocorrect_user(uint16_t* keycode, keyrecord_t* record,
+                              uint8_t* typo_buffer_size, uint8_t* mods) {
+  if (!process_autocorrect_default_handler(keycode, record, typo_buffer_size,
+                                           mods)) {
+    return false;
+  }
+  // The default handler maps word breaks to KC_SPC.
+  autocorrect_sends_key = (*keycode == KC_SPC);
+  return true;
+}
+#endif  // TAP_QUEUE_ENABLE
+
 bool apply_autocorrect(uint8_t backspaces, const char* str,
                        char* typo, char* correct) {
+#ifdef TAP_QUEUE_ENABLE
+  for (uint8_t i = 0; i < backspaces; ++i) {
+    tap_queue_tap(KC_BSPC);
+  }
+  tap_queue_send_string_P(str);
+  // A word break key is sent when this returns, so the correction must be
+  // sent first. Otherwise, the key is consumed and the correction is queued.
+  if (autocorrect_sends_key) {
+    tap_queue_flush();
+  }
+#else
   for (uint8_t i = 0; i < backspaces; ++i) {
     tap_code(KC_BSPC);
   }
   send_string_with_delay_P(str, TAP_CODE_DELAY);
+#endif  // TAP_QUEUE_ENABLE
   return false;
 }
 #endif  // AUTOCORRECT_ENABLE
@@ -373,6 +434,11 @@ char sentence_case_press_user(uint16_t keycode, keyrecord_t* record,
 bool remember_last_key_user(uint16_t keycode, keyrecord_t* record,
                             uint8_t* remembered_mods) {
   // Unpack tapping keycode for tap-hold keys.
+#ifdef KEY_EVENT_ENABLE
+  // Decoding here also caches the event for the handlers in
+  // process_record_user(), which is called after this.
+  keycode = key_event_decode(keycode, record)->keycode;
+#else
   switch (keycode) {
 #ifndef NO_ACTION_TAPPING
     case QK_MOD_TAP ... QK_MOD_TAP_MAX:
@@ -385,6 +451,7 @@ bool remember_last_key_user(uint16_t keycode, keyrecord_t* record,
 #endif  // NO_ACTION_LAYER
 #endif  // NO_ACTION_TAPPING
   }
+#endif  // KEY_EVENT_ENABLE
 
   // Forget Shift on most letters when Shift or AltGr are the only mods. Some
   // letters are excluded, e.g. for "NN" and "ZZ" in Vim.
@@ -506,6 +573,18 @@ uint16_t get_alt_repeat_key_keycode_user(uint16_t keycode, uint8_t mods) {
 #define MAGIC_STRING(str, repeat_keycode) \
   magic_send_string_P(PSTR(str), (repeat_keycode))
 static void magic_send_string_P(const char* str, uint16_t repeat_keycode) {
+#ifdef TAP_QUEUE_ENABLE
+  // If Caps Word is on, hold Shift while the queued string is sent.
+  const bool shift = is_caps_word_on() && !(get_mods() & MOD_BIT(KC_LSFT));
+  if (shift) {
+    tap_queue_register_mods(MOD_BIT(KC_LSFT));
+  }
+  tap_queue_send_string_P(str);
+  if (shift) {
+    tap_queue_unregister_mods(MOD_BIT(KC_LSFT));
+  }
+  set_last_keycode(repeat_keycode);
+#else
   uint8_t saved_mods = 0;
   // If Caps Word is on, save the mods and hold Shift.
   if (is_caps_word_on()) {
@@ -520,15 +599,25 @@ static void magic_send_string_P(const char* str, uint16_t repeat_keycode) {
   if (is_caps_word_on()) {
     set_mods(saved_mods);
   }
+#endif  // TAP_QUEUE_ENABLE
 }
 
 ///////////////////////////////////////////////////////////////////////////////
 // Debug logging
 ///////////////////////////////////////////////////////////////////////////////
-#if !defined(NO_DEBUG) && defined(KEYCODE_STRING_ENABLE)
+#if !defined(NO_DEBUG) && defined(EVENT_TRACE_ENABLE)
+// Trace events in binary, to be decoded by tools/trace_decode.py.
+static void dlog_record(uint16_t keycode, keyrecord_t* record) {
+  if (debug_enable) { event_trace_record(keycode, record); }
+}
+#elif !defined(NO_DEBUG) && defined(KEYCODE_STRING_ENABLE)
 #include "print.h"
+#include "sendchar.h"
 #include "features/keycode_string.h"
 
+// Sends a char to the console.
+static void dlog_putchar(char c) { sendchar((uint8_t)c); }
+
 static void dlog_record(uint16_t keycode, keyrecord_t* record) {
   if (!debug_enable) { return; }
   uint8_t layer = read_source_layers_cache(record->event.key);
@@ -539,14 +628,50 @@ static void dlog_record(uint16_t keycode, keyrecord_t* record) {
   } else {  // Log the "(row,col)" position.
     xprintf("(%2u,%2u) ", record->event.key.row, record->event.key.col);
   }
-  xprintf("%-4s %-7s %s\n",  // "(tap|hold) (press|release) <keycode>".
+  xprintf("%-4s %-7s ",  // "(tap|hold) (press|release) <keycode>".
       is_tap_hold ? (record->tap.count ? "tap" : "hold") : "",
-      record->event.pressed ? "press" : "release",
-      keycode_string(keycode));
+      record->event.pressed ? "press" : "release");
+  keycode_string_write(keycode, dlog_putchar);
+  sendchar('\n');
 }
 #else
 #define dlog_record(keycode, record)
-#endif  // !defined(NO_DEBUG) && defined(KEYCODE_STRING_ENABLE)
+#endif  // !defined(NO_DEBUG) && defined(EVENT_TRACE_ENABLE)
+
+///////////////////////////////////////////////////////////////////////////////
+// Profiling
+///////////////////////////////////////////////////////////////////////////////
+#ifdef PROFILER_ENABLE
+enum profiler_ids {
+  PROF_ACHORDION,
+  PROF_ORBITAL_MOUSE,
+  PROF_SENTENCE_CASE,
+  PROF_CUSTOM_SHIFT_KEYS,
+  PROF_ACHORDION_TASK,
+  PROF_ORBITAL_MOUSE_TASK,
+  PROF_SENTENCE_CASE_TASK,
+  // Time between successive housekeeping_task_user() calls, which is roughly
+  // the matrix scan period.
+  PROF_SCAN_PERIOD,
+};
+
+const char* profiler_id_name_user(uint8_t id) {
+  switch (id) {
+    case PROF_ACHORDION: return "process_achordion";
+    case PROF_ORBITAL_MOUSE: return "process_orbital_mouse";
+    case PROF_SENTENCE_CASE: return "process_sentence_case";
+    case PROF_CUSTOM_SHIFT_KEYS: return "process_custom_shift_keys";
+    case PROF_ACHORDION_TASK: return "achordion_task";
+    case PROF_ORBITAL_MOUSE_TASK: return "orbital_mouse_task";
+    case PROF_SENTENCE_CASE_TASK: return "sentence_case_task";
+    case PROF_SCAN_PERIOD: return "scan period";
+  }
+  return NULL;
+}
+#else
+#define PROFILER_CALL(id, call) (call)
+#define PROFILER_TIME(id, call) call
+#endif  // PROFILER_ENABLE
 
 ///////////////////////////////////////////////////////////////////////////////
 // Status LEDs
@@ -578,6 +703,10 @@ void caps_word_set_user(bool active) {
 ///////////////////////////////////////////////////////////////////////////////
 
 void keyboard_post_init_user(void) {
+#ifdef KEY_STATS_ENABLE
+  key_stats_init();
+#endif  // KEY_STATS_ENABLE
+
 #if RGB_MATRIX_CUSTOM_USER
   uint8_t palette_index = PALETTEFX_AMBER;
   rgb_matrix_sethsv_noeeprom(RGB_MATRIX_HUE_STEP * palette_index, 255, 255);
@@ -597,18 +726,48 @@ void keyboard_post_init_user(void) {
 #endif // defined(AUDIO_ENABLE) && defined(MUSHROOM_SOUND)
 }
 
+#if defined(KEY_STATS_ENABLE) && defined(RAW_ENABLE) && !defined(VIA_ENABLE)
+// VIA defines raw_hid_receive() itself, so this is left out with VIA, and Key
+// Stats is not reachable over raw HID.
+void raw_hid_receive(uint8_t* data, uint8_t length) {
+  key_stats_raw_hid_receive(data, length);
+}
+#endif  // KEY_STATS_ENABLE && RAW_ENABLE && !VIA_ENABLE
+
 bool process_record_user(uint16_t keycode, keyrecord_t* record) {
+#ifdef TAP_QUEUE_ENABLE
+  // Flush queued taps before anything else, in particular before Achordion
+  // applies eager mods, so that the taps are sent without those mods.
+  if (!process_tap_queue(keycode, record)) { return false; }
+#endif  // TAP_QUEUE_ENABLE
 #ifdef ACHORDION_ENABLE
-  if (!process_achordion(keycode, record)) { return false; }
+  if (!PROFILER_CALL(PROF_ACHORDION, process_achordion(keycode, record))) {
+    return false;
+  }
 #endif  // ACHORDION_ENABLE
+#ifdef KEY_STATS_ENABLE
+  key_stats_record(record);
+#endif  // KEY_STATS_ENABLE
+#ifdef KEY_HISTORY_ENABLE
+  if (!process_key_history(keycode, record)) { return false; }
+#endif  // KEY_HISTORY_ENABLE
 #ifdef ORBITAL_MOUSE_ENABLE
-  if (!process_orbital_mouse(keycode, record)) { return false; }
+  if (!PROFILER_CALL(PROF_ORBITAL_MOUSE,
+                     process_orbital_mouse(keycode, record))) {
+    return false;
+  }
 #endif  // ORBITAL_MOUSE_ENABLE
 #ifdef SENTENCE_CASE_ENABLE
-  if (!process_sentence_case(keycode, record)) { return false; }
+  if (!PROFILER_CALL(PROF_SENTENCE_CASE,
+                     process_sentence_case(keycode, record))) {
+    return false;
+  }
 #endif  // SENTENCE_CASE_ENABLE
 #ifdef CUSTOM_SHIFT_KEYS_ENABLE
-  if (!process_custom_shift_keys(keycode, record)) { return false; }
+  if (!PROFILER_CALL(PROF_CUSTOM_SHIFT_KEYS,
+                     process_custom_shift_keys(keycode, record))) {
+    return false;
+  }
 #endif  // CUSTOM_SHIFT_KEYS_ENABLE
 
   dlog_record(keycode, record);
@@ -763,6 +922,16 @@ bool process_record_user(uint16_t keycode, keyrecord_t* record) {
         }
         return true;
 
+#ifdef PROFILER_ENABLE
+      case PROFILE:  // Print profiling stats. With Shift, clear them instead.
+        if (shift_mods) {
+          profiler_reset();
+        } else {
+          profiler_print();
+        }
+        return false;
+#endif  // PROFILER_ENABLE
+
 #ifdef RGB_MATRIX_ENABLE
       case RGB_DEF:  // Set RGB matrix to some nice defaults.
         rgb_matrix_enable_noeeprom();
@@ -794,14 +963,33 @@ bool process_record_user(uint16_t keycode, keyrecord_t* record) {
 }
 
 void housekeeping_task_user(void) {
+#ifdef PROFILER_ENABLE
+  static uint32_t last_cycles = 0;
+  if (last_cycles) { profiler_record(PROF_SCAN_PERIOD, last_cycles); }
+  last_cycles = profiler_read_cycles() | 1;  // Nonzero once initialized.
+#endif  // PROFILER_ENABLE
 #ifdef ACHORDION_ENABLE
-  achordion_task();
+  PROFILER_TIME(PROF_ACHORDION_TASK, achordion_task());
 #endif  // ACHORDION_ENABLE
+#ifdef IDLE_TIMEOUT_ENABLE
+  idle_timeout_task();
+#endif  // IDLE_TIMEOUT_ENABLE
+#ifdef KEY_STATS_ENABLE
+  key_stats_task();
+#endif  // KEY_STATS_ENABLE
 #ifdef ORBITAL_MOUSE_ENABLE
-  orbital_mouse_task();
+  PROFILER_TIME(PROF_ORBITAL_MOUSE_TASK, orbital_mouse_task());
 #endif  // ORBITAL_MOUSE_ENABLE
 #ifdef SENTENCE_CASE_ENABLE
-  sentence_case_task();
+  PROFILER_TIME(PROF_SENTENCE_CASE_TASK, sentence_case_task());
 #endif  // SENTENCE_CASE_ENABLE
+#ifdef TAP_QUEUE_ENABLE
+  tap_queue_task();
+#endif  // TAP_QUEUE_ENABLE
+#ifdef REPORT_COALESCE_ENABLE
+  report_coalesce_task();
+#endif  // REPORT_COALESCE_ENABLE
+#if !defined(NO_DEBUG) && defined(EVENT_TRACE_ENABLE)
+  event_trace_task();
+#endif  // !defined(NO_DEBUG) && defined(EVENT_TRACE_ENABLE)
 }
-
@@ -109,7 +109,7 @@ const uint16_t keymaps[][MATRIX_ROWS][MATRIX_COLS] PROGMEM = {
 
   [FUN] = LAYOUT_LR(  // Funky fun layer.
     _______, _______, _______, _______, _______, _______,
-    _______, XXXXXXX, XXXXXXX, XXXXXXX, XXXXXXX, XXXXXXX,
+    _______, XXXXXXX, PROFILE, XXXXXXX, XXXXXXX, XXXXXXX,
     _______, XXXXXXX, KC_LALT, KC_LSFT, KC_LCTL, XXXXXXX,
     _______, KC_LGUI, XXXXXXX, XXXXXXX, XXXXXXX, XXXXXXX,
     _______, _______, _______, _______, _______,
@@ -49,3 +49,24 @@
         { R50, R51, R52, R53, R54, KC_NO }  \
     }
 
+// Handedness of each key for Achordion: 'L' for the left hand, 'R' for the
+// right hand, and '*' for keys outside the alpha rows, which are exempt from
+// the opposite hands rule.
+#define ACHORDION_HAND_LAYOUT_LR LAYOUT_LR( \
+    '*', '*', '*', '*', '*', '*',           \
+    'L', 'L', 'L', 'L', 'L', 'L',           \
+    'L', 'L', 'L', 'L', 'L', 'L',           \
+    'L', 'L', 'L', 'L', 'L', 'L',           \
+    '*', '*', '*', '*', '*',                \
+                                  '*', '*', \
+                                       '*', \
+                             '*', '*', '*', \
+                                            \
+              '*', '*', '*', '*', '*', '*', \
+              'R', 'R', 'R', 'R', 'R', 'R', \
+              'R', 'R', 'R', 'R', 'R', 'R', \
+              'R', 'R', 'R', 'R', 'R', 'R', \
+                   '*', '*', '*', '*', '*', \
+    '*', '*',                               \
+    '*',                                    \
+    '*', '*', '*')
@@ -46,6 +46,26 @@
     { KC_NO, KC_NO, KC_NO, kb3, kb4, kb5, kb6 }            \
 }
 
+// Handedness of each key for Achordion: 'L' for the left hand, 'R' for the
+// right hand, and '*' for keys outside the alpha rows, which are exempt from
+// the opposite hands rule.
+#define ACHORDION_HAND_LAYOUT_LR LAYOUT_LR(                \
+    '*', '*', '*', '*', '*', '*', '*',                     \
+    'L', 'L', 'L', 'L', 'L', 'L', 'L',                     \
+    'L', 'L', 'L', 'L', 'L', 'L', 'L',                     \
+    'L', 'L', 'L', 'L', 'L', 'L',                          \
+    '*', '*', '*', '*', '*',                               \
+                                  '*',                     \
+                        '*', '*', '*',                     \
+                                                           \
+                        '*', '*', '*', '*', '*', '*', '*', \
+                        'R', 'R', 'R', 'R', 'R', 'R', 'R', \
+                        'R', 'R', 'R', 'R', 'R', 'R', 'R', \
+                             'R', 'R', 'R', 'R', 'R', 'R', \
+                                  '*', '*', '*', '*', '*', \
+                        '*',                               \
+                        '*', '*', '*')
+
 // Wrapper macros to use the Moonlander's LEDs.
 #define STATUS_LED_1(status)  \
   do {                        \
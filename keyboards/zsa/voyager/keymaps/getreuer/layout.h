@@ -33,3 +33,18 @@
            k30, k31, k32, k33, k34, k35,   k80, k81, k82, k83, k84, k85, \
                                k40, k41,   k90, k91)
 
+// Handedness of each key for Achordion: 'L' for the left hand, 'R' for the
+// right hand, and '*' for keys outside the alpha rows, which are exempt from
+// the opposite hands rule.
+#define ACHORDION_HAND_LAYOUT_LR LAYOUT_LR( \
+    '*', '*', '*', '*', '*', '*',           \
+    'L', 'L', 'L', 'L', 'L', 'L',           \
+    'L', 'L', 'L', 'L', 'L', 'L',           \
+    'L', 'L', 'L', 'L', 'L', 'L',           \
+                             '*', '*',      \
+                                            \
+         '*', '*', '*', '*', '*', '*',      \
+         'R', 'R', 'R', 'R', 'R', 'R',      \
+         'R', 'R', 'R', 'R', 'R', 'R',      \
+         'R', 'R', 'R', 'R', 'R', 'R',      \
+    '*', '*')
@@ -44,6 +44,38 @@ ifeq ($(strip $(CUSTOM_SHIFT_KEYS_ENABLE)), yes)
 	SRC += features/custom_shift_keys.c
 endif
 
+EVENT_TRACE_ENABLE ?= no
+ifeq ($(strip $(EVENT_TRACE_ENABLE)), yes)
+	CONSOLE_ENABLE = yes
+	OPT_DEFS += -DEVENT_TRACE_ENABLE
+	SRC += features/event_trace.c
+endif
+
+IDLE_TIMEOUT_ENABLE ?= no
+ifeq ($(strip $(IDLE_TIMEOUT_ENABLE)), yes)
+	OPT_DEFS += -DIDLE_TIMEOUT_ENABLE
+	SRC += features/idle_timeout.c
+endif
+
+KEY_EVENT_ENABLE ?= no
+ifeq ($(strip $(KEY_EVENT_ENABLE)), yes)
+	OPT_DEFS += -DKEY_EVENT_ENABLE
+	SRC += features/key_event.c
+endif
+
+KEY_HISTORY_ENABLE ?= no
+ifeq ($(strip $(KEY_HISTORY_ENABLE)), yes)
+	OPT_DEFS += -DKEY_HISTORY_ENABLE
+	SRC += features/key_history.c
+endif
+
+KEY_STATS_ENABLE ?= no
+ifeq ($(strip $(KEY_STATS_ENABLE)), yes)
+	RAW_ENABLE = yes
+	OPT_DEFS += -DKEY_STATS_ENABLE
+	SRC += features/key_stats.c
+endif
+
 KEYCODE_STRING_ENABLE ?= yes
 ifeq ($(strip $(KEYCODE_STRING_ENABLE)), yes)
 	OPT_DEFS += -DKEYCODE_STRING_ENABLE
@@ -57,9 +89,27 @@ ifeq ($(strip $(ORBITAL_MOUSE_ENABLE)), yes)
 	SRC += features/orbital_mouse.c
 endif
 
+PROFILER_ENABLE ?= no
+ifeq ($(strip $(PROFILER_ENABLE)), yes)
+	CONSOLE_ENABLE = yes
+	OPT_DEFS += -DPROFILER_ENABLE
+	SRC += features/profiler.c
+endif
+
+REPORT_COALESCE_ENABLE ?= no
+ifeq ($(strip $(REPORT_COALESCE_ENABLE)), yes)
+	OPT_DEFS += -DREPORT_COALESCE_ENABLE
+	SRC += features/report_coalesce.c
+endif
+
 SENTENCE_CASE_ENABLE ?= yes
 ifeq ($(strip $(SENTENCE_CASE_ENABLE)), yes)
 	OPT_DEFS += -DSENTENCE_CASE_ENABLE
 	SRC += features/sentence_case.c
 endif
 
+TAP_QUEUE_ENABLE ?= no
+ifeq ($(strip $(TAP_QUEUE_ENABLE)), yes)
+	OPT_DEFS += -DTAP_QUEUE_ENABLE
+	SRC += features/tap_queue.c
+endif
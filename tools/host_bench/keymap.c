@@ -0,0 +1,46 @@
+// Copyright 2025 Google LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     https://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+/**
+ * @file keymap.c
+ * @brief Host build of getreuer.c for the replay benchmark.
+ *
+ * Like the keymap.c of each keyboard, this includes getreuer.c so that the
+ * benchmark exercises the same process_record_user() and callbacks as the
+ * firmware. Keycodes come from the replayed log rather than a keymap table.
+ */
+
+#include "quantum.h"
+
+// Handedness table for the matrix positions used by make_replay_log.py, where
+// rows 0-5 are the left hand and 6-11 the right, and the alphas are in rows 1-3
+// of each hand.
+// clang-format off
+#define ACHORDION_HAND_LAYOUT_LR { \
+    {'*', '*', '*', '*', '*', '*', '*'}, \
+    {'L', 'L', 'L', 'L', 'L', 'L', 'L'}, \
+    {'L', 'L', 'L', 'L', 'L', 'L', 'L'}, \
+    {'L', 'L', 'L', 'L', 'L', 'L', 'L'}, \
+    {'*', '*', '*', '*', '*', '*', '*'}, \
+    {'*', '*', '*', '*', '*', '*', '*'}, \
+    {'*', '*', '*', '*', '*', '*', '*'}, \
+    {'R', 'R', 'R', 'R', 'R', 'R', 'R'}, \
+    {'R', 'R', 'R', 'R', 'R', 'R', 'R'}, \
+    {'R', 'R', 'R', 'R', 'R', 'R', 'R'}, \
+    {'*', '*', '*', '*', '*', '*', '*'}, \
+    {'*', '*', '*', '*', '*', '*', '*'}, \
+  }
+// clang-format on
+
+#include "getreuer.c"
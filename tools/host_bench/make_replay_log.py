@@ -0,0 +1,146 @@
+# Copyright 2025 Google LLC
+#
+# Licensed under the Apache License, Version 2.0 (the "License");
+# you may not use this file except in compliance with the License.
+# You may obtain a copy of the License at
+#
+#     https://www.apache.org/licenses/LICENSE-2.0
+#
+# Unless required by applicable law or agreed to in writing, software
+# distributed under the License is distributed on an "AS IS" BASIS,
+# WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+# See the License for the specific language governing permissions and
+# limitations under the License.
+
+"""Generates a key event log for replay_bench from plain text.
+
+The text is "typed" on the base layer of my keymap (Magic Sturdy, see
+getreuer.c) with randomized timing. Home row mods are tapped for lowercase
+letters. Capitals are typed by holding the Shift home row mod on the opposite
+hand, which QMK settles as held, so that Achordion's chord logic runs.
+Characters not on the base layer are skipped.
+
+Usage:
+
+    python3 make_replay_log.py [--wpm 80] [--seed 1] input.txt > output.log
+"""
+
+import argparse
+import random
+import sys
+
+# Keycode encoding, matching qmk/quantum.h.
+MOD_LCTL, MOD_LSFT, MOD_LALT, MOD_LGUI = 0x01, 0x02, 0x04, 0x08
+MOD_RCTL, MOD_RSFT, MOD_RALT, MOD_RGUI = 0x11, 0x12, 0x14, 0x18
+SYM = 1
+NUM = 2
+WIN = 3
+
+
+def kc(letter):
+  return 0x04 + ord(letter) - ord('a')
+
+
+def mt(mod, keycode):
+  return 0x2000 | (mod << 8) | keycode
+
+
+def lt(layer, keycode):
+  return 0x4000 | (layer << 8) | keycode
+
+
+KC_ENT, KC_SPC, KC_QUOT, KC_COMM, KC_DOT, KC_SLSH = (
+    0x28, 0x2C, 0x34, 0x36, 0x37, 0x38)
+KC_SCLN, KC_MINS = 0x33, 0x2D
+KC_UNDS = 0x0200 | KC_MINS
+
+# Base layer as (row, col, keycode). Rows 0-5 are the left hand and 6-11 the
+# right hand, like the split matrix of the Moonlander and Voyager.
+BASE_LAYER = {
+    'v': (1, 1, kc('v')), 'm': (1, 2, kc('m')), 'l': (1, 3, kc('l')),
+    'c': (1, 4, kc('c')), 'p': (1, 5, kc('p')),
+    's': (2, 1, lt(SYM, kc('s'))), 't': (2, 2, mt(MOD_LALT, kc('t'))),
+    'r': (2, 3, mt(MOD_LSFT, kc('r'))), 'd': (2, 4, mt(MOD_LCTL, kc('d'))),
+    'y': (2, 5, kc('y')),
+    'x': (3, 1, mt(MOD_LGUI, kc('x'))), 'k': (3, 2, kc('k')),
+    'j': (3, 3, kc('j')), 'g': (3, 4, lt(NUM, kc('g'))),
+    'w': (3, 5, kc('w')),
+    '_': (4, 4, KC_UNDS), ' ': (4, 5, KC_SPC),
+    'b': (7, 1, kc('b')), 'u': (7, 3, kc('u')), 'o': (7, 4, kc('o')),
+    'q': (7, 5, kc('q')), '/': (7, 6, KC_SLSH),
+    'f': (8, 1, kc('f')), 'n': (8, 2, mt(MOD_RCTL, kc('n'))),
+    'e': (8, 3, mt(MOD_RSFT, kc('e'))), 'a': (8, 4, mt(MOD_LALT, kc('a'))),
+    'i': (8, 5, lt(SYM, kc('i'))), "'": (8, 6, KC_QUOT),
+    'z': (9, 1, kc('z')), 'h': (9, 2, kc('h')), ',': (9, 3, KC_COMM),
+    '.': (9, 4, KC_DOT), ';': (9, 5, mt(MOD_RGUI, KC_SCLN)),
+    '\n': (9, 6, KC_ENT),
+}
+# Shifted characters produced with custom shift keys or Shift.
+SHIFTED = {'?': '.', '!': ',', '"': "'", '-': '_', ':': ';'}
+LEFT_SHIFT = BASE_LAYER['r']
+RIGHT_SHIFT = BASE_LAYER['e']
+
+
+def is_tap_hold(keycode):
+  return 0x2000 <= keycode <= 0x4FFF
+
+
+def generate_events(text, wpm, rng):
+  """Returns a list of (time, row, col, pressed, keycode, tap_count)."""
+  events = []
+  interval = 60000.0 / (5 * wpm)  # Mean ms between key presses.
+  t = 0.0
+
+  def tap(key, t, tap_count):
+    row, col, keycode = key
+    duration = rng.uniform(0.45, 0.85) * interval
+    tc = tap_count if is_tap_hold(keycode) else 0
+    events.append((t, row, col, True, keycode, tc))
+    events.append((t + duration, row, col, False, keycode, tc))
+
+  for char in text:
+    shifted = char.isupper() or char in SHIFTED
+    char = SHIFTED.get(char, char.lower())
+    key = BASE_LAYER.get(char)
+    if key is None:
+      continue
+    t += rng.uniform(0.6, 1.4) * interval
+    if shifted:
+      # Hold Shift on the hand opposite to the key.
+      shift = RIGHT_SHIFT if key[0] < 6 else LEFT_SHIFT
+      if shift == key:
+        continue
+      row, col, shift_keycode = shift
+      events.append((t, row, col, True, shift_keycode, 0))
+      t += rng.uniform(0.3, 0.6) * interval
+      tap(key, t, 1)
+      events.append((t + 0.9 * interval, row, col, False, shift_keycode, 0))
+    else:
+      tap(key, t, 1)
+  events.sort(key=lambda e: e[0])
+  return events
+
+
+def main(argv):
+  parser = argparse.ArgumentParser(description=__doc__.split('\n')[0])
+  parser.add_argument('input', help='Input text file.')
+  parser.add_argument('--wpm', type=float, default=80.0,
+                      help='Typing speed in words per minute.')
+  parser.add_argument('--seed', type=int, default=1, help='Random seed.')
+  args = parser.parse_args(argv[1:])
+
+  with open(args.input, 'rt', encoding='utf-8') as f:
+    text = f.read()
+
+  rng = random.Random(args.seed)
+  events = generate_events(text, args.wpm, rng)
+  print(f'# Generated by make_replay_log.py from {args.input}, '
+        f'{args.wpm:g} WPM, seed {args.seed}.')
+  print('# time_ms row col p|r keycode tap_count')
+  for time, row, col, pressed, keycode, tap_count in events:
+    print(f'{int(round(time))} {row} {col} {"p" if pressed else "r"} '
+          f'0x{keycode:04X} {tap_count}')
+
+
+if __name__ == '__main__':
+  main(sys.argv)
@@ -0,0 +1,368 @@
+// Copyright 2025 Google LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     https://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+/**
+ * @file palettefx_bench.c
+ * @brief Renders PaletteFx effects on the host, timing and checksumming them.
+ *
+ * features/palettefx.inc is compiled against the RGB Matrix stand-in in
+ * qmk/rgb_matrix.h, with the LED layout of one of the keyboards in this repo,
+ * selected at build time by defining one of BOARD_MOONLANDER, BOARD_VOYAGER,
+ * or BOARD_DACTYL_PROMICRO. The LED positions are approximated from each
+ * board's key layout. The Dactyl has no RGB matrix; it is modeled as if it had
+ * one LED per key.
+ *
+ * Each effect renders the same deterministic sequence: frames are 16 ms
+ * apart in g_rgb_timer, the palette changes every 250 frames, brightness and
+ * saturation change partway through, and a synthetic typing stream, slow and
+ * then fast, feeds the key hit tracker. A checksum of every frame's LED colors
+ * is accumulated per effect, so that the output can be checked against the
+ * golden checksums in palettefx_golden.txt after optimizing an effect.
+ *
+ * Usage: palettefx_bench [-n frames] [-v] [-g golden.txt]
+ *
+ * With -v, the checksum of each frame is also printed. With -g, the checksums
+ * are compared with those listed for this board in the golden file, and the
+ * exit status is nonzero if any differ. The golden checksums are for the
+ * default number of frames and the default PaletteFx options.
+ */
+
+#if defined(BOARD_MOONLANDER)
+#define BOARD_NAME "moonlander"
+#define RGB_MATRIX_LED_COUNT 72
+#elif defined(BOARD_VOYAGER)
+#define BOARD_NAME "voyager"
+#define RGB_MATRIX_LED_COUNT 52
+#elif defined(BOARD_DACTYL_PROMICRO)
+#define BOARD_NAME "dactyl_promicro"
+#define RGB_MATRIX_LED_COUNT 70
+#else
+#error "Define BOARD_MOONLANDER, BOARD_VOYAGER, or BOARD_DACTYL_PROMICRO."
+#endif
+
+#include <stdio.h>
+#include <time.h>
+
+#include "rgb_matrix.h"
+
+// PaletteFx effects and palettes are enabled in config_getreuer.h.
+#define RGB_MATRIX_KEYREACTIVE_ENABLED
+
+led_config_t g_led_config;
+rgb_config_t rgb_matrix_config;
+uint32_t g_rgb_timer = 0;
+last_hit_t g_last_hit_tracker;
+uint16_t rand16seed = 1337;
+
+static rgb_t frame[RGB_MATRIX_LED_COUNT];
+
+void rgb_matrix_set_color(int index, uint8_t red, uint8_t green,
+                          uint8_t blue) {
+  if (0 <= index && index < RGB_MATRIX_LED_COUNT) {
+    frame[index] = (rgb_t){red, green, blue};
+  }
+}
+
+// Same as QMK's hsv_to_rgb() in color.c, without CIE 1931 correction.
+rgb_t rgb_matrix_hsv_to_rgb(hsv_t hsv) {
+  if (hsv.s == 0) {
+    return (rgb_t){hsv.v, hsv.v, hsv.v};
+  }
+  const uint16_t h = hsv.h;
+  const uint16_t s = hsv.s;
+  const uint16_t v = hsv.v;
+  const uint8_t region = h * 6 / 255;
+  const uint8_t remainder = (h * 2 - region * 85) * 3;
+  const uint8_t p = (v * (255 - s)) >> 8;
+  const uint8_t q = (v * (255 - ((s * remainder) >> 8))) >> 8;
+  const uint8_t t = (v * (255 - ((s * (255 - remainder)) >> 8))) >> 8;
+  switch (region) {
+    case 6:
+    case 0: return (rgb_t){v, t, p};
+    case 1: return (rgb_t){q, v, p};
+    case 2: return (rgb_t){p, v, t};
+    case 3: return (rgb_t){p, q, v};
+    case 4: return (rgb_t){t, p, v};
+    default: return (rgb_t){v, p, q};
+  }
+}
+
+#define RGB_MATRIX_EFFECT(name)
+#define RGB_MATRIX_CUSTOM_EFFECT_IMPLS
+#include "features/palettefx.inc"
+
+///////////////////////////////////////////////////////////////////////////////
+// Board layouts.
+///////////////////////////////////////////////////////////////////////////////
+
+// Key centers of the left half in tenths of a key unit. The right half is the
+// mirror image, and LEDs are numbered left half first.
+typedef struct {
+  int16_t x;
+  int16_t y;
+} key_pos_t;
+
+#if defined(BOARD_MOONLANDER)
+// Rows of 7, 7, 7, 6, and 5 keys, and a thumb cluster of 4.
+static const uint8_t row_lengths[] = {7, 7, 7, 6, 5};
+static const key_pos_t thumb_keys[] = {{55, 42}, {45, 52}, {55, 52}, {65, 52}};
+#define HALF_GAP 30
+#elif defined(BOARD_VOYAGER)
+// Rows of 6 keys, and a thumb cluster of 2.
+static const uint8_t row_lengths[] = {6, 6, 6, 6};
+static const key_pos_t thumb_keys[] = {{50, 42}, {62, 44}};
+#define HALF_GAP 30
+#else
+// Rows of 6, 6, 6, 6, and 5 keys, and a thumb cluster of 6.
+static const uint8_t row_lengths[] = {6, 6, 6, 6, 5};
+static const key_pos_t thumb_keys[] = {{60, 50}, {70, 50}, {70, 60},
+                                       {50, 60}, {60, 60}, {60, 70}};
+#define HALF_GAP 40
+#endif
+
+#define ARRAY_SIZE(a) (sizeof(a) / sizeof(*(a)))
+
+static void init_led_config(void) {
+  key_pos_t keys[RGB_MATRIX_LED_COUNT];
+  uint8_t n = 0;
+  for (uint8_t row = 0; row < ARRAY_SIZE(row_lengths); ++row) {
+    for (uint8_t col = 0; col < row_lengths[row]; ++col) {
+      keys[n++] = (key_pos_t){10 * col, 10 * row};
+    }
+  }
+  for (uint8_t i = 0; i < ARRAY_SIZE(thumb_keys); ++i) {
+    keys[n++] = thumb_keys[i];
+  }
+  // Mirror the left half to make the right half.
+  const uint8_t half = n;
+  int16_t half_width = 0;
+  for (uint8_t i = 0; i < half; ++i) {
+    if (keys[i].x > half_width) {
+      half_width = keys[i].x;
+    }
+  }
+  const int16_t width = 2 * half_width + HALF_GAP;
+  for (uint8_t i = 0; i < half; ++i) {
+    keys[n++] = (key_pos_t){width - keys[i].x, keys[i].y};
+  }
+  if (n != RGB_MATRIX_LED_COUNT) {
+    fprintf(stderr, "Error: Layout has %u LEDs, expected %u.\n", n,
+            RGB_MATRIX_LED_COUNT);
+    exit(1);
+  }
+
+  // Scale to QMK's LED coordinate range of [0, 224] x [0, 64].
+  int16_t height = 0;
+  for (uint8_t i = 0; i < n; ++i) {
+    if (keys[i].y > height) {
+      height = keys[i].y;
+    }
+  }
+  for (uint8_t i = 0; i < n; ++i) {
+    g_led_config.point[i] = (led_point_t){
+        (uint8_t)((224 * keys[i].x + width / 2) / width),
+        (uint8_t)((64 * keys[i].y + height / 2) / height),
+    };
+    g_led_config.flags[i] = LED_FLAG_KEYLIGHT;
+  }
+}
+
+///////////////////////////////////////////////////////////////////////////////
+// Key hit tracker, as updated by QMK's rgb_matrix.c.
+///////////////////////////////////////////////////////////////////////////////
+
+static void add_hit(uint8_t led) {
+  last_hit_t* t = &g_last_hit_tracker;
+  if (t->count == LED_HITS_TO_REMEMBER) {  // Drop the oldest hit.
+    memmove(&t->x[0], &t->x[1], LED_HITS_TO_REMEMBER - 1);
+    memmove(&t->y[0], &t->y[1], LED_HITS_TO_REMEMBER - 1);
+    memmove(&t->index[0], &t->index[1], LED_HITS_TO_REMEMBER - 1);
+    memmove(&t->tick[0], &t->tick[1],
+            (LED_HITS_TO_REMEMBER - 1) * sizeof(*t->tick));
+    --t->count;
+  }
+  t->x[t->count] = g_led_config.point[led].x;
+  t->y[t->count] = g_led_config.point[led].y;
+  t->index[t->count] = led;
+  t->tick[t->count] = 0;
+  ++t->count;
+}
+
+static void advance_hit_ticks(uint16_t dt) {
+  last_hit_t* t = &g_last_hit_tracker;
+  for (uint8_t j = 0; j < t->count; ++j) {
+    t->tick[j] = (t->tick[j] > UINT16_MAX - dt) ? UINT16_MAX : t->tick[j] + dt;
+  }
+}
+
+///////////////////////////////////////////////////////////////////////////////
+// Benchmark.
+///////////////////////////////////////////////////////////////////////////////
+
+enum { FRAME_MS = 16, DEFAULT_FRAMES = 2000 };
+
+typedef struct {
+  const char* name;
+  bool (*effect)(effect_params_t*);
+} effect_t;
+
+static const effect_t effects[] = {
+    {"GRADIENT", PALETTEFX_GRADIENT}, {"FLOW", PALETTEFX_FLOW},
+    {"RIPPLE", PALETTEFX_RIPPLE},     {"SPARKLE", PALETTEFX_SPARKLE},
+    {"VORTEX", PALETTEFX_VORTEX},     {"REACTIVE", PALETTEFX_REACTIVE},
+};
+
+static uint64_t read_ns(void) {
+  struct timespec ts;
+  clock_gettime(CLOCK_MONOTONIC, &ts);
+  return (uint64_t)ts.tv_sec * 1000000000 + ts.tv_nsec;
+}
+
+// FNV-1a hash of the frame's LED colors.
+static uint32_t hash_frame(uint32_t hash) {
+  const uint8_t* bytes = (const uint8_t*)frame;
+  for (size_t i = 0; i < sizeof(frame); ++i) {
+    hash = (hash ^ bytes[i]) * UINT32_C(16777619);
+  }
+  return hash;
+}
+
+/** Renders `num_frames` of an effect, returning the checksum. */
+static uint32_t run_effect(const effect_t* e, int num_frames, bool verbose,
+                           uint64_t* elapsed_ns) {
+  memset(frame, 0, sizeof(frame));
+  memset(&g_last_hit_tracker, 0, sizeof(g_last_hit_tracker));
+  rgb_matrix_config = (rgb_config_t){
+      .enable = 1, .hsv = {0, 255, 255}, .speed = 128, .flags = LED_FLAG_ALL};
+  g_rgb_timer = 0;
+  rand16seed = 1337;
+  uint16_t typing_state = 1;
+
+  uint32_t checksum = UINT32_C(2166136261);
+  uint64_t ns = 0;
+  for (int f = 0; f < num_frames; ++f) {
+    // Cycle through the palettes, selected by hue.
+    if (f % 250 == 0) {
+      rgb_matrix_config.hsv.h = RGB_MATRIX_HUE_STEP * (f / 250);
+    }
+    if (f == num_frames / 3) {
+      rgb_matrix_config.hsv.v = 128;
+    } else if (f == num_frames / 2) {
+      rgb_matrix_config.hsv.s = 160;
+    }
+    // Type slowly in the first half, a key every 10 frames, then fast, a key
+    // every other frame, at pseudorandom LEDs.
+    if (f % ((f < num_frames / 2) ? 10 : 2) == 0) {
+      typing_state = typing_state * UINT16_C(36563) + 1;
+      add_hit((typing_state >> 8) % RGB_MATRIX_LED_COUNT);
+    }
+
+    const uint64_t start = read_ns();
+    for (uint8_t iter = 0;; ++iter) {
+      effect_params_t params = {
+          .iter = iter, .flags = LED_FLAG_ALL, .init = (f == 0 && iter == 0)};
+      if (!e->effect(&params)) {
+        break;
+      }
+    }
+    ns += read_ns() - start;
+
+    const uint32_t frame_checksum = hash_frame(UINT32_C(2166136261));
+    checksum = (checksum ^ frame_checksum) * UINT32_C(16777619);
+    if (verbose) {
+      printf("%s %s frame %d %08x\n", BOARD_NAME, e->name, f, frame_checksum);
+    }
+
+    g_rgb_timer += FRAME_MS;
+    advance_hit_ticks(FRAME_MS);
+  }
+
+  *elapsed_ns = ns;
+  return checksum;
+}
+
+/** Looks up the golden checksum of an effect, returning false if not found. */
+static bool find_golden(const char* path, const char* effect,
+                        uint32_t* checksum) {
+  FILE* f = fopen(path, "rt");
+  if (!f) {
+    fprintf(stderr, "Error: Could not open \"%s\".\n", path);
+    exit(1);
+  }
+  char line[256];
+  bool found = false;
+  while (!found && fgets(line, sizeof(line), f)) {
+    char board[64];
+    char name[64];
+    unsigned value;
+    if (line[0] != '#' &&
+        sscanf(line, "%63s %63s %x", board, name, &value) == 3 &&
+        !strcmp(board, BOARD_NAME) && !strcmp(name, effect)) {
+      *checksum = value;
+      found = true;
+    }
+  }
+  fclose(f);
+  return found;
+}
+
+int main(int argc, char** argv) {
+  int num_frames = DEFAULT_FRAMES;
+  bool verbose = false;
+  const char* golden_path = NULL;
+  for (int i = 1; i < argc; ++i) {
+    if (!strcmp(argv[i], "-n") && i + 1 < argc) {
+      num_frames = atoi(argv[++i]);
+    } else if (!strcmp(argv[i], "-v")) {
+      verbose = true;
+    } else if (!strcmp(argv[i], "-g") && i + 1 < argc) {
+      golden_path = argv[++i];
+    } else {
+      fprintf(stderr, "Usage: %s [-n frames] [-v] [-g golden.txt]\n",
+              argv[0]);
+      return 1;
+    }
+  }
+  if (num_frames < 1) {
+    fprintf(stderr, "Error: Nothing to render.\n");
+    return 1;
+  }
+
+  init_led_config();
+  printf("Board %s, %d LEDs, %d frames.\n\n", BOARD_NAME,
+         RGB_MATRIX_LED_COUNT, num_frames);
+  printf("%-18s %-10s %10s %10s\n", "board", "effect", "ns/frame",
+         "checksum");
+
+  int mismatches = 0;
+  for (size_t i = 0; i < ARRAY_SIZE(effects); ++i) {
+    uint64_t ns;
+    const uint32_t checksum = run_effect(&effects[i], num_frames, verbose, &ns);
+    printf("%-18s %-10s %10.1f   %08x", BOARD_NAME, effects[i].name,
+           (double)ns / num_frames, checksum);
+    if (golden_path) {
+      uint32_t golden;
+      if (!find_golden(golden_path, effects[i].name, &golden)) {
+        printf("  (no golden checksum)");
+      } else if (golden != checksum) {
+        printf("  MISMATCH, golden %08x", golden);
+        ++mismatches;
+      } else {
+        printf("  ok");
+      }
+    }
+    printf("\n");
+  }
+  return mismatches ? 1 : 0;
+}
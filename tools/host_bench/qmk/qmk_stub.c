@@ -0,0 +1,499 @@
+// Copyright 2025 Google LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     https://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+/**
+ * @file qmk_stub.c
+ * @brief Simplified host implementation of the QMK API declared in quantum.h.
+ */
+
+// System headers come first, since quantum.h defines dprintf as a macro.
+#include <stdarg.h>
+#include <stdio.h>
+#include <string.h>
+
+#include "qmk_stub.h"
+
+stub_counters_t stub_counters;
+bool debug_enable = false;
+layer_state_t layer_state = 1;
+layer_state_t default_layer_state = 1;
+
+static uint32_t now_ms = 0;
+static uint8_t mods = 0;
+static uint8_t weak_mods = 0;
+static uint8_t oneshot_mods = 0;
+static report_keyboard_t report;  // Mods are set when the report is sent.
+static report_keyboard_t last_report;
+static uint16_t position_keycodes[MATRIX_ROWS][MATRIX_COLS];
+static bool print_enabled = false;
+static bool caps_word_active = false;
+static uint16_t last_keycode = KC_NO;
+static uint8_t last_mods = 0;
+
+static struct {
+  uint32_t time;
+  deferred_exec_callback callback;
+  void* cb_arg;
+} deferred[8];
+
+void stub_set_time(uint32_t time_ms) { now_ms = time_ms; }
+uint32_t stub_get_time(void) { return now_ms; }
+
+void stub_set_keycode(keypos_t pos, uint16_t keycode) {
+  if (pos.row < MATRIX_ROWS && pos.col < MATRIX_COLS) {
+    position_keycodes[pos.row][pos.col] = keycode;
+  }
+}
+
+void stub_reset(void) {
+  mods = weak_mods = oneshot_mods = 0;
+  memset(&report, 0, sizeof(report));
+  memset(&last_report, 0, sizeof(last_report));
+  memset(&stub_counters, 0, sizeof(stub_counters));
+  memset(deferred, 0, sizeof(deferred));
+  layer_state = default_layer_state = 1;
+  caps_word_active = false;
+  last_keycode = KC_NO;
+  last_mods = 0;
+}
+
+void stub_set_print_enabled(bool enabled) { print_enabled = enabled; }
+
+int stub_printf(const char* format, ...) {
+  if (!print_enabled) {
+    return 0;
+  }
+  va_list args;
+  va_start(args, format);
+  const int result = vprintf(format, args);
+  va_end(args);
+  return result;
+}
+
+int8_t sendchar(uint8_t c) {
+  if (print_enabled) {
+    putchar(c);
+  }
+  return 0;
+}
+
+uint8_t biton(uint8_t bits) {
+  uint8_t n = 0;
+  while (bits >>= 1) {
+    ++n;
+  }
+  return n;
+}
+
+uint8_t biton32(uint32_t bits) {
+  uint8_t n = 0;
+  while (bits >>= 1) {
+    ++n;
+  }
+  return n;
+}
+
+// Timer.
+uint16_t timer_read(void) { return (uint16_t)now_ms; }
+uint32_t timer_read32(void) { return now_ms; }
+uint16_t timer_elapsed(uint16_t last) { return (uint16_t)(now_ms - last); }
+uint32_t timer_elapsed32(uint32_t last) { return now_ms - last; }
+void wait_ms(uint16_t ms) { stub_counters.wait_ms_total += ms; }
+
+// Mods.
+uint8_t get_mods(void) { return mods; }
+void add_mods(uint8_t m) { mods |= m; }
+void del_mods(uint8_t m) { mods &= ~m; }
+void set_mods(uint8_t m) { mods = m; }
+void clear_mods(void) { mods = 0; }
+uint8_t get_weak_mods(void) { return weak_mods; }
+void add_weak_mods(uint8_t m) { weak_mods |= m; }
+void del_weak_mods(uint8_t m) { weak_mods &= ~m; }
+void set_weak_mods(uint8_t m) { weak_mods = m; }
+void clear_weak_mods(void) { weak_mods = 0; }
+uint8_t get_oneshot_mods(void) { return oneshot_mods; }
+void add_oneshot_mods(uint8_t m) { oneshot_mods |= m; }
+void del_oneshot_mods(uint8_t m) { oneshot_mods &= ~m; }
+void set_oneshot_mods(uint8_t m) { oneshot_mods = m; }
+void clear_oneshot_mods(void) { oneshot_mods = 0; }
+
+void register_mods(uint8_t m) {
+  if (m) {
+    add_mods(m);
+    send_keyboard_report();
+  }
+}
+
+void unregister_mods(uint8_t m) {
+  if (m) {
+    del_mods(m);
+    send_keyboard_report();
+  }
+}
+
+void register_weak_mods(uint8_t m) {
+  if (m) {
+    add_weak_mods(m);
+    send_keyboard_report();
+  }
+}
+
+void unregister_weak_mods(uint8_t m) {
+  if (m) {
+    del_weak_mods(m);
+    send_keyboard_report();
+  }
+}
+
+// Converts a 5-bit mod code (as in MT and S()) to an 8-bit mod mask.
+static uint8_t mod5_to_mod8(uint8_t m) {
+  return (m & 0x10) ? (uint8_t)((m & 0x0F) << 4) : (m & 0x0F);
+}
+
+// Keyboard report.
+void add_key(uint8_t key) { report.bits[key / 8] |= 1 << (key % 8); }
+void del_key(uint8_t key) { report.bits[key / 8] &= ~(1 << (key % 8)); }
+void clear_keys(void) { memset(report.bits, 0, sizeof(report.bits)); }
+
+// Logs the report as "report <time> mods=<mods> keys: <keys>".
+static void stub_send_keyboard(report_keyboard_t* r) {
+  if (print_enabled) {
+    printf("report %5lu mods=%02X keys:", (unsigned long)now_ms, r->mods);
+    for (uint16_t kc = 0; kc < 8 * sizeof(r->bits); ++kc) {
+      if (r->bits[kc / 8] & (1 << (kc % 8))) { printf(" %02X", kc); }
+    }
+    printf("\n");
+  }
+}
+
+static host_driver_t stub_driver = {stub_send_keyboard};
+static host_driver_t* driver = &stub_driver;
+
+void host_set_driver(host_driver_t* d) { driver = d; }
+host_driver_t* host_get_driver(void) { return driver; }
+
+// Like QMK, only reports that changed are passed to the host driver.
+void send_keyboard_report(void) {
+  report.mods = mods | weak_mods | oneshot_mods;
+  ++stub_counters.keyboard_reports;
+  if (memcmp(&report, &last_report, sizeof(report)) != 0) {
+    ++stub_counters.keyboard_report_changes;
+    last_report = report;
+    driver->send_keyboard(&report);
+  }
+}
+
+void register_code(uint8_t kc) {
+  if (IS_MODIFIER_KEYCODE(kc)) {
+    add_mods(MOD_BIT(kc));
+  } else if (kc != KC_NO && !IS_MOUSE_KEYCODE(kc)) {
+    add_key(kc);
+  }
+  send_keyboard_report();
+}
+
+void unregister_code(uint8_t kc) {
+  if (IS_MODIFIER_KEYCODE(kc)) {
+    del_mods(MOD_BIT(kc));
+  } else {
+    del_key(kc);
+  }
+  send_keyboard_report();
+}
+
+void register_code16(uint16_t kc) {
+  if (IS_QK_MODS(kc)) {
+    register_weak_mods(mod5_to_mod8(QK_MODS_GET_MODS(kc)));
+  }
+  register_code(kc & 0xFF);
+}
+
+void unregister_code16(uint16_t kc) {
+  unregister_code(kc & 0xFF);
+  if (IS_QK_MODS(kc)) {
+    unregister_weak_mods(mod5_to_mod8(QK_MODS_GET_MODS(kc)));
+  }
+}
+
+void tap_code(uint8_t kc) {
+  register_code(kc);
+  wait_ms(TAP_CODE_DELAY);
+  unregister_code(kc);
+}
+
+void tap_code16(uint16_t kc) {
+  register_code16(kc);
+  wait_ms(TAP_CODE_DELAY);
+  unregister_code16(kc);
+}
+
+void tap_code_delay(uint8_t kc, uint16_t delay) {
+  register_code(kc);
+  wait_ms(delay);
+  unregister_code(kc);
+}
+
+// Layers.
+uint8_t get_highest_layer(layer_state_t state) { return biton32(state); }
+void layer_on(uint8_t layer) { layer_state |= (layer_state_t)1 << layer; }
+void layer_off(uint8_t layer) { layer_state &= ~((layer_state_t)1 << layer); }
+void layer_move(uint8_t layer) { layer_state = (layer_state_t)1 << layer; }
+bool layer_state_is(uint8_t layer) {
+  return (layer_state & ((layer_state_t)1 << layer)) != 0;
+}
+uint8_t read_source_layers_cache(keypos_t key) {
+  return get_highest_layer(layer_state | default_layer_state);
+}
+
+uint16_t keymap_key_to_keycode(uint8_t layer, keypos_t key) {
+  if (key.row < MATRIX_ROWS && key.col < MATRIX_COLS) {
+    return position_keycodes[key.row][key.col];
+  }
+  return KC_NO;
+}
+
+// Default handling for events that pass through process_record_user(). This
+// models basic keys, modified keys, mod-taps, layer-taps, and MO layer keys.
+static void process_default_action(uint16_t keycode, keyrecord_t* record) {
+  const bool pressed = record->event.pressed;
+  if (IS_QK_BASIC(keycode) || IS_QK_MODS(keycode)) {
+    if (pressed) {
+      register_code16(keycode);
+      if (!IS_MODIFIER_KEYCODE(keycode)) {
+        // Like QMK, one-shot mods apply to the next key pressed only.
+        clear_oneshot_mods();
+      }
+    } else {
+      unregister_code16(keycode);
+    }
+  } else if (IS_QK_MOD_TAP(keycode)) {
+    if (record->tap.count) {
+      const uint8_t kc = QK_MOD_TAP_GET_TAP_KEYCODE(keycode);
+      if (pressed) {
+        register_code(kc);
+      } else {
+        unregister_code(kc);
+      }
+    } else {
+      const uint8_t m = mod5_to_mod8(QK_MOD_TAP_GET_MODS(keycode));
+      if (pressed) {
+        register_mods(m);
+      } else {
+        unregister_mods(m);
+      }
+    }
+  } else if (IS_QK_LAYER_TAP(keycode)) {
+    if (record->tap.count) {
+      const uint8_t kc = QK_LAYER_TAP_GET_TAP_KEYCODE(keycode);
+      if (pressed) {
+        register_code(kc);
+      } else {
+        unregister_code(kc);
+      }
+    } else if (pressed) {
+      layer_on(QK_LAYER_TAP_GET_LAYER(keycode));
+    } else {
+      layer_off(QK_LAYER_TAP_GET_LAYER(keycode));
+    }
+  } else if (QK_MOMENTARY <= keycode && keycode <= QK_MOMENTARY_MAX) {
+    if (pressed) {
+      layer_on(QK_MOMENTARY_GET_LAYER(keycode));
+    } else {
+      layer_off(QK_MOMENTARY_GET_LAYER(keycode));
+    }
+  } else if (keycode == QK_CAPS_WORD_TOGGLE && pressed) {
+    caps_word_active = !caps_word_active;
+  }
+}
+
+void process_record(keyrecord_t* record) {
+  const uint16_t keycode =
+      record->keycode ? record->keycode
+                      : keymap_key_to_keycode(0, record->event.key);
+  if (process_record_user(keycode, record)) {
+    process_default_action(keycode, record);
+  }
+}
+
+void process_action(keyrecord_t* record, action_t action) {
+  const uint8_t m = mod5_to_mod8((action.code >> 8) & 0x1F);
+  if (record->event.pressed) {
+    register_mods(m);
+  } else {
+    unregister_mods(m);
+  }
+}
+
+// Mouse.
+void host_mouse_send(report_mouse_t* report) { ++stub_counters.mouse_reports; }
+
+// Deferred execution. Token i + 1 refers to slot i.
+deferred_token defer_exec(uint32_t delay_ms, deferred_exec_callback callback,
+                          void* cb_arg) {
+  for (uint8_t i = 0; i < sizeof(deferred) / sizeof(*deferred); ++i) {
+    if (!deferred[i].callback) {
+      deferred[i].time = now_ms + delay_ms;
+      deferred[i].callback = callback;
+      deferred[i].cb_arg = cb_arg;
+      return i + 1;
+    }
+  }
+  return INVALID_DEFERRED_TOKEN;
+}
+
+bool extend_deferred_exec(deferred_token token, uint32_t delay_ms) {
+  if (token == INVALID_DEFERRED_TOKEN ||
+      token > sizeof(deferred) / sizeof(*deferred) ||
+      !deferred[token - 1].callback) {
+    return false;
+  }
+  deferred[token - 1].time = now_ms + delay_ms;
+  return true;
+}
+
+bool cancel_deferred_exec(deferred_token token) {
+  if (token == INVALID_DEFERRED_TOKEN ||
+      token > sizeof(deferred) / sizeof(*deferred) ||
+      !deferred[token - 1].callback) {
+    return false;
+  }
+  deferred[token - 1].callback = NULL;
+  return true;
+}
+
+void deferred_exec_task(void) {
+  for (uint8_t i = 0; i < sizeof(deferred) / sizeof(*deferred); ++i) {
+    if (deferred[i].callback && timer_expired32(now_ms, deferred[i].time)) {
+      const uint32_t trigger_time = deferred[i].time;
+      const uint32_t delay = deferred[i].callback(trigger_time,
+                                                  deferred[i].cb_arg);
+      if (delay == 0) {
+        deferred[i].callback = NULL;
+      } else {
+        deferred[i].time = trigger_time + delay;
+      }
+    }
+  }
+}
+
+// EEPROM user datablock.
+#if defined(EECONFIG_USER_DATA_SIZE) && EECONFIG_USER_DATA_SIZE > 0
+static uint8_t user_datablock[EECONFIG_USER_DATA_SIZE];
+
+uint32_t eeconfig_read_user_datablock(void* data, uint32_t offset,
+                                      uint32_t length) {
+  if (offset + length > sizeof(user_datablock)) { return 0; }
+  memcpy(data, user_datablock + offset, length);
+  return length;
+}
+
+uint32_t eeconfig_update_user_datablock(const void* data, uint32_t offset,
+                                        uint32_t length) {
+  if (offset + length > sizeof(user_datablock)) { return 0; }
+  memcpy(user_datablock + offset, data, length);
+  return length;
+}
+#endif  // defined(EECONFIG_USER_DATA_SIZE) && EECONFIG_USER_DATA_SIZE > 0
+
+// Send string. Covers printable ASCII on a US layout.
+void send_char(char ascii_code) {
+  static const char shifted_symbols[] = "~!@#$%^&*()_+{}|:\"<>?";
+  static const char unshifted_symbols[] = "`1234567890-=[]\\;',./";
+  static const uint8_t symbol_keycodes[] = {
+      KC_GRV,  KC_1,    KC_2,    KC_3,    KC_4,    KC_5,   KC_6,
+      KC_7,    KC_8,    KC_9,    KC_0,    KC_MINS, KC_EQL, KC_LBRC,
+      KC_RBRC, KC_BSLS, KC_SCLN, KC_QUOT, KC_COMM, KC_DOT, KC_SLSH};
+  uint16_t keycode = KC_NO;
+  const char c = ascii_code;
+  if ('a' <= c && c <= 'z') {
+    keycode = KC_A + (c - 'a');
+  } else if ('A' <= c && c <= 'Z') {
+    keycode = S(KC_A + (c - 'A'));
+  } else if (c == ' ') {
+    keycode = KC_SPC;
+  } else if (c == '\n') {
+    keycode = KC_ENT;
+  } else if (c == '\t') {
+    keycode = KC_TAB;
+  } else if (c == '\b') {
+    keycode = KC_BSPC;
+  } else {
+    const char* p;
+    if ((p = strchr(unshifted_symbols, c)) != NULL) {
+      keycode = symbol_keycodes[p - unshifted_symbols];
+    } else if ((p = strchr(shifted_symbols, c)) != NULL) {
+      keycode = S(symbol_keycodes[p - shifted_symbols]);
+    }
+  }
+  if (keycode != KC_NO) {
+    ++stub_counters.chars_sent;
+    tap_code16(keycode);
+  }
+}
+
+const uint8_t ascii_to_keycode_lut[128] = {
+    KC_NO,   KC_NO,   KC_NO,   KC_NO,   KC_NO,   KC_NO,   KC_NO,   KC_NO,
+    KC_BSPC, KC_TAB,  KC_ENT,  KC_NO,   KC_NO,   KC_NO,   KC_NO,   KC_NO,
+    KC_NO,   KC_NO,   KC_NO,   KC_NO,   KC_NO,   KC_NO,   KC_NO,   KC_NO,
+    KC_NO,   KC_NO,   KC_NO,   KC_ESC,  KC_NO,   KC_NO,   KC_NO,   KC_NO,
+    KC_SPC,  KC_1,    KC_QUOT, KC_3,    KC_4,    KC_5,    KC_7,    KC_QUOT,
+    KC_9,    KC_0,    KC_8,    KC_EQL,  KC_COMM, KC_MINS, KC_DOT,  KC_SLSH,
+    KC_0,    KC_1,    KC_2,    KC_3,    KC_4,    KC_5,    KC_6,    KC_7,
+    KC_8,    KC_9,    KC_SCLN, KC_SCLN, KC_COMM, KC_EQL,  KC_DOT,  KC_SLSH,
+    KC_2,    KC_A,    KC_B,    KC_C,    KC_D,    KC_E,    KC_F,    KC_G,
+    KC_H,    KC_I,    KC_J,    KC_K,    KC_L,    KC_M,    KC_N,    KC_O,
+    KC_P,    KC_Q,    KC_R,    KC_S,    KC_T,    KC_U,    KC_V,    KC_W,
+    KC_X,    KC_Y,    KC_Z,    KC_LBRC, KC_BSLS, KC_RBRC, KC_6,    KC_MINS,
+    KC_GRV,  KC_A,    KC_B,    KC_C,    KC_D,    KC_E,    KC_F,    KC_G,
+    KC_H,    KC_I,    KC_J,    KC_K,    KC_L,    KC_M,    KC_N,    KC_O,
+    KC_P,    KC_Q,    KC_R,    KC_S,    KC_T,    KC_U,    KC_V,    KC_W,
+    KC_X,    KC_Y,    KC_Z,    KC_LBRC, KC_BSLS, KC_RBRC, KC_GRV,  KC_DEL,
+};
+// Bit (c % 8) of entry (c / 8) is set if character c is shifted.
+const uint8_t ascii_to_shift_lut[16] = {
+    0x00, 0x00, 0x00, 0x00, 0x7E, 0x0F, 0x00, 0xD4,
+    0xFF, 0xFF, 0xFF, 0xC7, 0x00, 0x00, 0x00, 0x78,
+};
+const uint8_t ascii_to_altgr_lut[16] = {0};
+
+void send_string(const char* str) { send_string_with_delay(str, 0); }
+void send_string_P(const char* str) { send_string_with_delay(str, 0); }
+
+void send_string_with_delay(const char* str, uint8_t interval) {
+  for (; *str; ++str) {
+    send_char(*str);
+    wait_ms(interval);
+  }
+}
+
+void send_string_with_delay_P(const char* str, uint8_t interval) {
+  send_string_with_delay(str, interval);
+}
+
+void send_unicode_string(const char* str) {
+  for (; *str; ++str) {
+    ++stub_counters.chars_sent;
+  }
+}
+
+// Caps Word and Repeat Key (QMK core features).
+bool is_caps_word_on(void) { return caps_word_active; }
+void caps_word_on(void) { caps_word_active = true; }
+void caps_word_off(void) { caps_word_active = false; }
+bool process_caps_word(uint16_t keycode, keyrecord_t* record) { return true; }
+uint16_t get_last_keycode(void) { return last_keycode; }
+uint8_t get_last_mods(void) { return last_mods; }
+void set_last_keycode(uint16_t keycode) { last_keycode = keycode; }
+void set_last_mods(uint8_t m) { last_mods = m; }
+int8_t get_repeat_key_count(void) { return 0; }
@@ -0,0 +1,61 @@
+// Copyright 2025 Google LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     https://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+/**
+ * @file qmk_stub.h
+ * @brief Host-side controls for the QMK stand-in.
+ *
+ * Functions here are not part of QMK. The host program uses them to drive
+ * virtual time, to tell the stub which keycode is at each matrix position, and
+ * to read counters of the output that the features produced.
+ */
+
+#pragma once
+
+#include "quantum.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/** Counters of output produced through the stubbed QMK API. */
+typedef struct {
+  /** Number of calls to send_keyboard_report(). */
+  uint32_t keyboard_reports;
+  /** Number of keyboard reports that differed from the previous one. */
+  uint32_t keyboard_report_changes;
+  /** Number of calls to host_mouse_send(). */
+  uint32_t mouse_reports;
+  /** Number of characters sent through the send_string functions. */
+  uint32_t chars_sent;
+  /** Total milliseconds requested through wait_ms(). */
+  uint32_t wait_ms_total;
+} stub_counters_t;
+
+extern stub_counters_t stub_counters;
+
+/** Sets the virtual time in milliseconds. */
+void stub_set_time(uint32_t time_ms);
+/** Returns the virtual time in milliseconds. */
+uint32_t stub_get_time(void);
+/** Sets the keycode that process_record() uses for the key at `pos`. */
+void stub_set_keycode(keypos_t pos, uint16_t keycode);
+/** Resets mods, keys, layers, counters, and deferred callbacks. */
+void stub_reset(void);
+/** Enables or disables printing of xprintf() output to stdout. */
+void stub_set_print_enabled(bool enabled);
+
+#ifdef __cplusplus
+}
+#endif
@@ -0,0 +1,708 @@
+// Copyright 2025 Google LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     https://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+/**
+ * @file quantum.h
+ * @brief Minimal host stand-in for QMK's quantum.h.
+ *
+ * This header declares just enough of QMK's API for the feature libraries in
+ * this repo and getreuer.c to compile on a desktop machine with gcc. Keycode
+ * values follow QMK's current encoding, but only the parts of QMK that the
+ * features call into are modeled, and most behavior is simplified. The
+ * implementation is in qmk_stub.c.
+ *
+ * This is for benchmarking and testing on the host only. It is not a QMK
+ * emulator, so don't rely on it for anything the real firmware does.
+ */
+
+#pragma once
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#ifndef MATRIX_ROWS
+#define MATRIX_ROWS 12
+#endif  // MATRIX_ROWS
+#ifndef MATRIX_COLS
+#define MATRIX_COLS 7
+#endif  // MATRIX_COLS
+#ifndef TAPPING_TERM
+#define TAPPING_TERM 200
+#endif  // TAPPING_TERM
+#ifndef QUICK_TAP_TERM
+#define QUICK_TAP_TERM TAPPING_TERM
+#endif  // QUICK_TAP_TERM
+#ifndef TAP_CODE_DELAY
+#define TAP_CODE_DELAY 0
+#endif  // TAP_CODE_DELAY
+
+///////////////////////////////////////////////////////////////////////////////
+// Program memory. On the host, PROGMEM data is ordinary memory.
+///////////////////////////////////////////////////////////////////////////////
+#define PROGMEM
+#define PSTR(s) (s)
+#define pgm_read_byte(p) (*(const uint8_t*)(p))
+#define pgm_read_word(p) (*(const uint16_t*)(p))
+#define pgm_read_dword(p) (*(const uint32_t*)(p))
+#define pgm_read_ptr(p) (*(void* const*)(p))
+
+///////////////////////////////////////////////////////////////////////////////
+// Keycodes.
+///////////////////////////////////////////////////////////////////////////////
+// clang-format off
+enum qk_keycode_ranges {
+  QK_BASIC                = 0x0000,
+  QK_BASIC_MAX            = 0x00FF,
+  QK_MODS                 = 0x0100,
+  QK_MODS_MAX             = 0x1FFF,
+  QK_MOD_TAP              = 0x2000,
+  QK_MOD_TAP_MAX          = 0x3FFF,
+  QK_LAYER_TAP            = 0x4000,
+  QK_LAYER_TAP_MAX        = 0x4FFF,
+  QK_LAYER_MOD            = 0x5000,
+  QK_LAYER_MOD_MAX        = 0x51FF,
+  QK_TO                   = 0x5200,
+  QK_TO_MAX               = 0x521F,
+  QK_MOMENTARY            = 0x5220,
+  QK_MOMENTARY_MAX        = 0x523F,
+  QK_DEF_LAYER            = 0x5240,
+  QK_DEF_LAYER_MAX        = 0x525F,
+  QK_TOGGLE_LAYER         = 0x5260,
+  QK_TOGGLE_LAYER_MAX     = 0x527F,
+  QK_ONE_SHOT_LAYER       = 0x5280,
+  QK_ONE_SHOT_LAYER_MAX   = 0x529F,
+  QK_ONE_SHOT_MOD         = 0x52A0,
+  QK_ONE_SHOT_MOD_MAX     = 0x52BF,
+  QK_LAYER_TAP_TOGGLE     = 0x52C0,
+  QK_LAYER_TAP_TOGGLE_MAX = 0x52DF,
+  QK_PERSISTENT_DEF_LAYER = 0x52E0,
+  QK_PERSISTENT_DEF_LAYER_MAX = 0x52FF,
+  QK_SWAP_HANDS           = 0x5600,
+  QK_SWAP_HANDS_MAX       = 0x56FF,
+  QK_TAP_DANCE            = 0x5700,
+  QK_TAP_DANCE_MAX        = 0x57FF,
+  QK_LIGHTING             = 0x7800,
+  QK_LIGHTING_MAX         = 0x78FF,
+  QK_QUANTUM              = 0x7C00,
+  QK_QUANTUM_MAX          = 0x7DFF,
+  QK_KB                   = 0x7E00,
+  QK_KB_MAX               = 0x7E3F,
+  QK_USER                 = 0x7E40,
+  QK_USER_MAX             = 0x7FFF,
+  QK_UNICODEMAP           = 0x8000,
+  QK_UNICODEMAP_MAX       = 0xBFFF,
+  QK_UNICODE              = 0x8000,
+  QK_UNICODE_MAX          = 0xFFFF,
+  QK_UNICODEMAP_PAIR      = 0xC000,
+  QK_UNICODEMAP_PAIR_MAX  = 0xFFFF,
+};
+
+enum qk_keycode_defines {
+  KC_NO = 0x00,
+  KC_TRANSPARENT = 0x01,
+  KC_A = 0x04, KC_B, KC_C, KC_D, KC_E, KC_F, KC_G, KC_H, KC_I, KC_J, KC_K,
+  KC_L, KC_M, KC_N, KC_O, KC_P, KC_Q, KC_R, KC_S, KC_T, KC_U, KC_V, KC_W,
+  KC_X, KC_Y, KC_Z,
+  KC_1 = 0x1E, KC_2, KC_3, KC_4, KC_5, KC_6, KC_7, KC_8, KC_9, KC_0,
+  KC_ENTER = 0x28,
+  KC_ESCAPE,
+  KC_BACKSPACE,
+  KC_TAB,
+  KC_SPACE,
+  KC_MINUS,
+  KC_EQUAL,
+  KC_LEFT_BRACKET,
+  KC_RIGHT_BRACKET,
+  KC_BACKSLASH,
+  KC_NONUS_HASH,
+  KC_SEMICOLON,
+  KC_QUOTE,
+  KC_GRAVE,
+  KC_COMMA,
+  KC_DOT,
+  KC_SLASH,
+  KC_CAPS_LOCK,
+  KC_F1 = 0x3A, KC_F2, KC_F3, KC_F4, KC_F5, KC_F6, KC_F7, KC_F8, KC_F9,
+  KC_F10, KC_F11, KC_F12,
+  KC_PRINT_SCREEN = 0x46,
+  KC_SCROLL_LOCK,
+  KC_PAUSE,
+  KC_INSERT,
+  KC_HOME,
+  KC_PAGE_UP,
+  KC_DELETE,
+  KC_END,
+  KC_PAGE_DOWN,
+  KC_RIGHT,
+  KC_LEFT,
+  KC_DOWN,
+  KC_UP,
+  KC_NUM_LOCK,
+  KC_KP_SLASH,
+  KC_KP_ASTERISK,
+  KC_KP_MINUS,
+  KC_KP_PLUS,
+  KC_KP_ENTER,
+  KC_KP_1 = 0x59, KC_KP_2, KC_KP_3, KC_KP_4, KC_KP_5, KC_KP_6, KC_KP_7,
+  KC_KP_8, KC_KP_9, KC_KP_0,
+  KC_KP_DOT = 0x63,
+  KC_NONUS_BACKSLASH,
+  KC_APPLICATION,
+  KC_KB_POWER,
+  KC_KP_EQUAL,
+  KC_F13 = 0x68, KC_F14, KC_F15, KC_F16, KC_F17, KC_F18, KC_F19, KC_F20,
+  KC_F21, KC_F22, KC_F23, KC_F24,
+  KC_AUDIO_MUTE = 0xA8,
+  KC_AUDIO_VOL_UP,
+  KC_AUDIO_VOL_DOWN,
+  KC_MEDIA_NEXT_TRACK,
+  KC_MEDIA_PREV_TRACK,
+  KC_MEDIA_STOP,
+  KC_MEDIA_PLAY_PAUSE,
+  KC_WWW_BACK = 0xB6,
+  KC_WWW_FORWARD,
+  QK_MOUSE_CURSOR_UP = 0xCD,
+  QK_MOUSE_CURSOR_DOWN,
+  QK_MOUSE_CURSOR_LEFT,
+  QK_MOUSE_CURSOR_RIGHT,
+  QK_MOUSE_BUTTON_1,
+  QK_MOUSE_BUTTON_2,
+  QK_MOUSE_BUTTON_3,
+  QK_MOUSE_BUTTON_4,
+  QK_MOUSE_BUTTON_5,
+  QK_MOUSE_BUTTON_6,
+  QK_MOUSE_BUTTON_7,
+  QK_MOUSE_BUTTON_8,
+  QK_MOUSE_WHEEL_UP,
+  QK_MOUSE_WHEEL_DOWN,
+  QK_MOUSE_WHEEL_LEFT,
+  QK_MOUSE_WHEEL_RIGHT,
+  QK_MOUSE_ACCELERATION_0,
+  QK_MOUSE_ACCELERATION_1,
+  QK_MOUSE_ACCELERATION_2,
+  KC_LEFT_CTRL = 0xE0,
+  KC_LEFT_SHIFT,
+  KC_LEFT_ALT,
+  KC_LEFT_GUI,
+  KC_RIGHT_CTRL,
+  KC_RIGHT_SHIFT,
+  KC_RIGHT_ALT,
+  KC_RIGHT_GUI,
+
+  QK_BOOTLOADER = 0x7C00,
+  QK_REBOOT = 0x7C01,
+  QK_DEBUG_TOGGLE = 0x7C02,
+  QK_GRAVE_ESCAPE = 0x7C16,
+  QK_SWAP_HANDS_TOGGLE = 0x56F0,
+  QK_SWAP_HANDS_ONE_SHOT = 0x56F6,
+  QK_CAPS_WORD_TOGGLE = 0x7C73,
+  QK_AUTOCORRECT_ON = 0x7C74,
+  QK_AUTOCORRECT_OFF = 0x7C75,
+  QK_AUTOCORRECT_TOGGLE = 0x7C76,
+  QK_TRI_LAYER_LOWER = 0x7C77,
+  QK_TRI_LAYER_UPPER = 0x7C78,
+  QK_REPEAT_KEY = 0x7C79,
+  QK_ALT_REPEAT_KEY = 0x7C7A,
+  QK_LAYER_LOCK = 0x7C7B,
+
+  QK_KB_0 = 0x7E00,
+  QK_KB_31 = 0x7E1F,
+  QK_USER_0 = 0x7E40,
+  QK_USER_31 = 0x7E5F,
+};
+
+// Short aliases.
+#define XXXXXXX KC_NO
+#define _______ KC_TRANSPARENT
+#define KC_TRNS KC_TRANSPARENT
+#define KC_ENT  KC_ENTER
+#define KC_ESC  KC_ESCAPE
+#define KC_BSPC KC_BACKSPACE
+#define KC_SPC  KC_SPACE
+#define KC_MINS KC_MINUS
+#define KC_EQL  KC_EQUAL
+#define KC_LBRC KC_LEFT_BRACKET
+#define KC_RBRC KC_RIGHT_BRACKET
+#define KC_BSLS KC_BACKSLASH
+#define KC_SCLN KC_SEMICOLON
+#define KC_QUOT KC_QUOTE
+#define KC_GRV  KC_GRAVE
+#define KC_COMM KC_COMMA
+#define KC_SLSH KC_SLASH
+#define KC_CAPS KC_CAPS_LOCK
+#define KC_PSCR KC_PRINT_SCREEN
+#define KC_INS  KC_INSERT
+#define KC_PGUP KC_PAGE_UP
+#define KC_DEL  KC_DELETE
+#define KC_PGDN KC_PAGE_DOWN
+#define KC_RGHT KC_RIGHT
+#define KC_APP  KC_APPLICATION
+#define KC_MUTE KC_AUDIO_MUTE
+#define KC_VOLU KC_AUDIO_VOL_UP
+#define KC_VOLD KC_AUDIO_VOL_DOWN
+#define KC_MNXT KC_MEDIA_NEXT_TRACK
+#define KC_MPRV KC_MEDIA_PREV_TRACK
+#define KC_MSTP KC_MEDIA_STOP
+#define KC_MPLY KC_MEDIA_PLAY_PAUSE
+#define KC_WBAK KC_WWW_BACK
+#define KC_WFWD KC_WWW_FORWARD
+#define KC_LCTL KC_LEFT_CTRL
+#define KC_LSFT KC_LEFT_SHIFT
+#define KC_LALT KC_LEFT_ALT
+#define KC_LGUI KC_LEFT_GUI
+#define KC_RCTL KC_RIGHT_CTRL
+#define KC_RSFT KC_RIGHT_SHIFT
+#define KC_RALT KC_RIGHT_ALT
+#define KC_RGUI KC_RIGHT_GUI
+#define MS_UP   QK_MOUSE_CURSOR_UP
+#define MS_DOWN QK_MOUSE_CURSOR_DOWN
+#define MS_LEFT QK_MOUSE_CURSOR_LEFT
+#define MS_RGHT QK_MOUSE_CURSOR_RIGHT
+#define MS_BTN1 QK_MOUSE_BUTTON_1
+#define MS_BTN2 QK_MOUSE_BUTTON_2
+#define MS_BTN3 QK_MOUSE_BUTTON_3
+#define MS_BTN4 QK_MOUSE_BUTTON_4
+#define MS_BTN5 QK_MOUSE_BUTTON_5
+#define MS_BTN6 QK_MOUSE_BUTTON_6
+#define MS_BTN7 QK_MOUSE_BUTTON_7
+#define MS_BTN8 QK_MOUSE_BUTTON_8
+#define MS_WHLU QK_MOUSE_WHEEL_UP
+#define MS_WHLD QK_MOUSE_WHEEL_DOWN
+#define MS_WHLL QK_MOUSE_WHEEL_LEFT
+#define MS_WHLR QK_MOUSE_WHEEL_RIGHT
+#define MS_ACL0 QK_MOUSE_ACCELERATION_0
+#define MS_ACL1 QK_MOUSE_ACCELERATION_1
+#define MS_ACL2 QK_MOUSE_ACCELERATION_2
+#define KC_BTN1 MS_BTN1
+#define KC_BTN2 MS_BTN2
+#define KC_BTN3 MS_BTN3
+#define KC_MS_U MS_UP
+#define KC_MS_D MS_DOWN
+#define KC_MS_L MS_LEFT
+#define KC_MS_R MS_RGHT
+#define KC_WH_U MS_WHLU
+#define KC_WH_D MS_WHLD
+#define KC_WH_L MS_WHLL
+#define KC_WH_R MS_WHLR
+#define DB_TOGG QK_DEBUG_TOGGLE
+#define QK_GESC QK_GRAVE_ESCAPE
+#define CW_TOGG QK_CAPS_WORD_TOGGLE
+#define AC_TOGG QK_AUTOCORRECT_TOGGLE
+#define TL_LOWR QK_TRI_LAYER_LOWER
+#define TL_UPPR QK_TRI_LAYER_UPPER
+#define QK_REP  QK_REPEAT_KEY
+#define QK_AREP QK_ALT_REPEAT_KEY
+#define QK_LLCK QK_LAYER_LOCK
+#define SAFE_RANGE QK_USER
+
+// Modifier bits, as in QMK's modifiers.h.
+enum mods_bit {
+  MOD_LCTL = 0x01,
+  MOD_LSFT = 0x02,
+  MOD_LALT = 0x04,
+  MOD_LGUI = 0x08,
+  MOD_RCTL = 0x11,
+  MOD_RSFT = 0x12,
+  MOD_RALT = 0x14,
+  MOD_RGUI = 0x18,
+};
+#define MOD_BIT(code) (1 << ((code) & 0x07))
+#define MOD_BIT_LCTRL MOD_BIT(KC_LEFT_CTRL)
+#define MOD_BIT_LSHIFT MOD_BIT(KC_LEFT_SHIFT)
+#define MOD_BIT_LALT MOD_BIT(KC_LEFT_ALT)
+#define MOD_BIT_LGUI MOD_BIT(KC_LEFT_GUI)
+#define MOD_BIT_RCTRL MOD_BIT(KC_RIGHT_CTRL)
+#define MOD_BIT_RSHIFT MOD_BIT(KC_RIGHT_SHIFT)
+#define MOD_BIT_RALT MOD_BIT(KC_RIGHT_ALT)
+#define MOD_BIT_RGUI MOD_BIT(KC_RIGHT_GUI)
+#define MOD_MASK_CTRL (MOD_BIT_LCTRL | MOD_BIT_RCTRL)
+#define MOD_MASK_SHIFT (MOD_BIT_LSHIFT | MOD_BIT_RSHIFT)
+#define MOD_MASK_ALT (MOD_BIT_LALT | MOD_BIT_RALT)
+#define MOD_MASK_GUI (MOD_BIT_LGUI | MOD_BIT_RGUI)
+#define MOD_MASK_CS (MOD_MASK_CTRL | MOD_MASK_SHIFT)
+#define MOD_MASK_CA (MOD_MASK_CTRL | MOD_MASK_ALT)
+#define MOD_MASK_CG (MOD_MASK_CTRL | MOD_MASK_GUI)
+#define MOD_MASK_SA (MOD_MASK_SHIFT | MOD_MASK_ALT)
+#define MOD_MASK_SG (MOD_MASK_SHIFT | MOD_MASK_GUI)
+#define MOD_MASK_AG (MOD_MASK_ALT | MOD_MASK_GUI)
+#define MOD_MASK_CSA (MOD_MASK_CS | MOD_MASK_ALT)
+#define MOD_MASK_CSAG (MOD_MASK_CSA | MOD_MASK_GUI)
+
+// Modified keycodes.
+#define QK_LCTL 0x0100
+#define QK_LSFT 0x0200
+#define QK_LALT 0x0400
+#define QK_LGUI 0x0800
+#define QK_RMODS_MIN 0x1000
+#define QK_RCTL 0x1100
+#define QK_RSFT 0x1200
+#define QK_RALT 0x1400
+#define QK_RGUI 0x1800
+#define LCTL(kc) (QK_LCTL | (kc))
+#define LSFT(kc) (QK_LSFT | (kc))
+#define LALT(kc) (QK_LALT | (kc))
+#define LGUI(kc) (QK_LGUI | (kc))
+#define RCTL(kc) (QK_RCTL | (kc))
+#define RSFT(kc) (QK_RSFT | (kc))
+#define RALT(kc) (QK_RALT | (kc))
+#define RGUI(kc) (QK_RGUI | (kc))
+#define C(kc) LCTL(kc)
+#define S(kc) LSFT(kc)
+#define A(kc) LALT(kc)
+#define G(kc) LGUI(kc)
+#define QK_MODS_GET_MODS(kc) (((kc) >> 8) & 0x1F)
+#define QK_MODS_GET_BASIC_KEYCODE(kc) ((kc) & 0xFF)
+
+#define KC_TILD S(KC_GRAVE)
+#define KC_EXLM S(KC_1)
+#define KC_AT   S(KC_2)
+#define KC_HASH S(KC_3)
+#define KC_DLR  S(KC_4)
+#define KC_PERC S(KC_5)
+#define KC_CIRC S(KC_6)
+#define KC_AMPR S(KC_7)
+#define KC_ASTR S(KC_8)
+#define KC_LPRN S(KC_9)
+#define KC_RPRN S(KC_0)
+#define KC_UNDS S(KC_MINUS)
+#define KC_PLUS S(KC_EQUAL)
+#define KC_LCBR S(KC_LEFT_BRACKET)
+#define KC_RCBR S(KC_RIGHT_BRACKET)
+#define KC_PIPE S(KC_BACKSLASH)
+#define KC_COLN S(KC_SEMICOLON)
+#define KC_DQUO S(KC_QUOTE)
+#define KC_LABK S(KC_COMMA)
+#define KC_RABK S(KC_DOT)
+#define KC_QUES S(KC_SLASH)
+
+// Mod-tap, layer, and other quantum keycodes.
+#define MT(mod, kc) (QK_MOD_TAP | (((mod) & 0x1F) << 8) | ((kc) & 0xFF))
+#define LCTL_T(kc) MT(MOD_LCTL, kc)
+#define LSFT_T(kc) MT(MOD_LSFT, kc)
+#define LALT_T(kc) MT(MOD_LALT, kc)
+#define LGUI_T(kc) MT(MOD_LGUI, kc)
+#define RCTL_T(kc) MT(MOD_RCTL, kc)
+#define RSFT_T(kc) MT(MOD_RSFT, kc)
+#define RALT_T(kc) MT(MOD_RALT, kc)
+#define RGUI_T(kc) MT(MOD_RGUI, kc)
+#define QK_MOD_TAP_GET_MODS(kc) (((kc) >> 8) & 0x1F)
+#define QK_MOD_TAP_GET_TAP_KEYCODE(kc) ((kc) & 0xFF)
+#define LT(layer, kc) (QK_LAYER_TAP | (((layer) & 0xF) << 8) | ((kc) & 0xFF))
+#define QK_LAYER_TAP_GET_LAYER(kc) (((kc) >> 8) & 0xF)
+#define QK_LAYER_TAP_GET_TAP_KEYCODE(kc) ((kc) & 0xFF)
+#define LM(layer, mod) \
+  (QK_LAYER_MOD | (((layer) & 0xF) << 5) | ((mod) & 0x1F))
+#define QK_LAYER_MOD_GET_LAYER(kc) (((kc) >> 5) & 0xF)
+#define QK_LAYER_MOD_GET_MODS(kc) ((kc) & 0x1F)
+#define TO(layer) (QK_TO | ((layer) & 0x1F))
+#define QK_TO_GET_LAYER(kc) ((kc) & 0x1F)
+#define MO(layer) (QK_MOMENTARY | ((layer) & 0x1F))
+#define QK_MOMENTARY_GET_LAYER(kc) ((kc) & 0x1F)
+#define DF(layer) (QK_DEF_LAYER | ((layer) & 0x1F))
+#define QK_DEF_LAYER_GET_LAYER(kc) ((kc) & 0x1F)
+#define PDF(layer) (QK_PERSISTENT_DEF_LAYER | ((layer) & 0x1F))
+#define QK_PERSISTENT_DEF_LAYER_GET_LAYER(kc) ((kc) & 0x1F)
+#define TG(layer) (QK_TOGGLE_LAYER | ((layer) & 0x1F))
+#define QK_TOGGLE_LAYER_GET_LAYER(kc) ((kc) & 0x1F)
+#define OSL(layer) (QK_ONE_SHOT_LAYER | ((layer) & 0x1F))
+#define QK_ONE_SHOT_LAYER_GET_LAYER(kc) ((kc) & 0x1F)
+#define OSM(mod) (QK_ONE_SHOT_MOD | ((mod) & 0x1F))
+#define QK_ONE_SHOT_MOD_GET_MODS(kc) ((kc) & 0x1F)
+#define TT(layer) (QK_LAYER_TAP_TOGGLE | ((layer) & 0x1F))
+#define QK_LAYER_TAP_TOGGLE_GET_LAYER(kc) ((kc) & 0x1F)
+#define SH_T(kc) (QK_SWAP_HANDS | ((kc) & 0xFF))
+#define QK_SWAP_HANDS_GET_TAP_KEYCODE(kc) ((kc) & 0xFF)
+#define IS_SWAP_HANDS_KEYCODE(code) \
+  ((code) >= QK_SWAP_HANDS_TOGGLE && (code) <= QK_SWAP_HANDS_ONE_SHOT)
+#define TD(i) (QK_TAP_DANCE | ((i) & 0xFF))
+#define QK_TAP_DANCE_GET_INDEX(kc) ((kc) & 0xFF)
+#define UC(c) (QK_UNICODE | ((c) & 0x7FFF))
+#define QK_UNICODE_GET_CODE_POINT(kc) ((kc) & 0x7FFF)
+#define UM(i) (QK_UNICODEMAP | ((i) & 0x3FFF))
+#define QK_UNICODEMAP_GET_INDEX(kc) ((kc) & 0x3FFF)
+#define UP(i, j) (QK_UNICODEMAP_PAIR | ((i) & 0x7F) | (((j) & 0x7F) << 7))
+#define QK_UNICODEMAP_PAIR_GET_UNSHIFTED_INDEX(kc) ((kc) & 0x7F)
+#define QK_UNICODEMAP_PAIR_GET_SHIFTED_INDEX(kc) (((kc) >> 7) & 0x7F)
+
+#define IS_QK_BASIC(code) ((code) <= QK_BASIC_MAX)
+#define IS_QK_MODS(code) ((code) >= QK_MODS && (code) <= QK_MODS_MAX)
+#define IS_QK_MOD_TAP(code) ((code) >= QK_MOD_TAP && (code) <= QK_MOD_TAP_MAX)
+#define IS_QK_LAYER_TAP(code) \
+  ((code) >= QK_LAYER_TAP && (code) <= QK_LAYER_TAP_MAX)
+#define IS_QK_ONE_SHOT_MOD(code) \
+  ((code) >= QK_ONE_SHOT_MOD && (code) <= QK_ONE_SHOT_MOD_MAX)
+#define IS_MODIFIER_KEYCODE(code) \
+  ((code) >= KC_LEFT_CTRL && (code) <= KC_RIGHT_GUI)
+#define IS_MOUSE_KEYCODE(code) \
+  ((code) >= QK_MOUSE_CURSOR_UP && (code) <= QK_MOUSE_ACCELERATION_2)
+#define MODIFIER_KEYCODE_RANGE KC_LEFT_CTRL ... KC_RIGHT_GUI
+#define KB_KEYCODE_RANGE QK_KB_0 ... QK_KB_31
+#define USER_KEYCODE_RANGE QK_USER_0 ... QK_USER_31
+// clang-format on
+
+///////////////////////////////////////////////////////////////////////////////
+// Key events.
+///////////////////////////////////////////////////////////////////////////////
+typedef struct {
+  uint8_t col;
+  uint8_t row;
+} keypos_t;
+
+typedef enum {
+  TICK_EVENT = 0,
+  KEY_EVENT = 1,
+  ENCODER_CW_EVENT = 2,
+  ENCODER_CCW_EVENT = 3,
+  COMBO_EVENT = 4,
+} keyevent_type_t;
+
+typedef struct {
+  keypos_t key;
+  uint16_t time;
+  keyevent_type_t type;
+  bool pressed;
+} keyevent_t;
+
+typedef struct {
+  bool interrupted : 1;
+  bool reserved2 : 1;
+  bool reserved1 : 1;
+  bool reserved0 : 1;
+  uint8_t count : 4;
+} tap_t;
+
+typedef struct {
+  keyevent_t event;
+  tap_t tap;
+  uint16_t keycode;
+} keyrecord_t;
+
+#define KEYEQ(keya, keyb) \
+  ((keya).row == (keyb).row && (keya).col == (keyb).col)
+#define IS_KEYEVENT(event) ((event).type == KEY_EVENT)
+#define IS_COMBOEVENT(event) ((event).type == COMBO_EVENT)
+
+typedef union {
+  uint16_t code;
+} action_t;
+
+#define ACTION_MODS(mods) ((uint16_t)(((mods) & 0x1F) << 8))
+#define ACTION_MODS_TAP_KEY(mods, key) \
+  ((uint16_t)(0x2000 | (((mods) & 0x1F) << 8) | ((key) & 0xFF)))
+
+/** Runs the keymap's handlers and then the default action for `record`. */
+void process_record(keyrecord_t* record);
+/** Applies a mods or mod-tap `action` for `record`. */
+void process_action(keyrecord_t* record, action_t action);
+
+bool process_record_user(uint16_t keycode, keyrecord_t* record);
+void housekeeping_task_user(void);
+void keyboard_post_init_user(void);
+
+///////////////////////////////////////////////////////////////////////////////
+// Timer. Time is virtual and advanced by the host program.
+///////////////////////////////////////////////////////////////////////////////
+uint16_t timer_read(void);
+uint32_t timer_read32(void);
+uint16_t timer_elapsed(uint16_t last);
+uint32_t timer_elapsed32(uint32_t last);
+#define timer_expired(current, future) \
+  ((uint16_t)((current) - (future)) < UINT16_MAX / 2)
+#define timer_expired32(current, future) \
+  ((uint32_t)((current) - (future)) < UINT32_MAX / 2)
+void wait_ms(uint16_t ms);
+
+///////////////////////////////////////////////////////////////////////////////
+// Mods and keyboard report.
+///////////////////////////////////////////////////////////////////////////////
+uint8_t get_mods(void);
+void add_mods(uint8_t mods);
+void del_mods(uint8_t mods);
+void set_mods(uint8_t mods);
+void clear_mods(void);
+uint8_t get_weak_mods(void);
+void add_weak_mods(uint8_t mods);
+void del_weak_mods(uint8_t mods);
+void set_weak_mods(uint8_t mods);
+void clear_weak_mods(void);
+uint8_t get_oneshot_mods(void);
+void add_oneshot_mods(uint8_t mods);
+void del_oneshot_mods(uint8_t mods);
+void set_oneshot_mods(uint8_t mods);
+void clear_oneshot_mods(void);
+void register_mods(uint8_t mods);
+void unregister_mods(uint8_t mods);
+void register_weak_mods(uint8_t mods);
+void unregister_weak_mods(uint8_t mods);
+#define mod_config(mod) (mod)
+
+void add_key(uint8_t key);
+void del_key(uint8_t key);
+void clear_keys(void);
+void send_keyboard_report(void);
+
+// The host driver, through which send_keyboard_report() sends changed reports.
+// The stub's report is the mods followed by a bitmap of held basic keycodes.
+typedef struct {
+  uint8_t mods;
+  uint8_t bits[32];
+} report_keyboard_t;
+
+typedef struct {
+  void (*send_keyboard)(report_keyboard_t* report);
+} host_driver_t;
+
+void host_set_driver(host_driver_t* driver);
+host_driver_t* host_get_driver(void);
+
+void register_code(uint8_t kc);
+void unregister_code(uint8_t kc);
+void register_code16(uint16_t kc);
+void unregister_code16(uint16_t kc);
+void tap_code(uint8_t kc);
+void tap_code16(uint16_t kc);
+void tap_code_delay(uint8_t kc, uint16_t delay);
+
+///////////////////////////////////////////////////////////////////////////////
+// Layers.
+///////////////////////////////////////////////////////////////////////////////
+typedef uint32_t layer_state_t;
+extern layer_state_t layer_state;
+extern layer_state_t default_layer_state;
+uint8_t get_highest_layer(layer_state_t state);
+void layer_on(uint8_t layer);
+void layer_off(uint8_t layer);
+void layer_move(uint8_t layer);
+bool layer_state_is(uint8_t layer);
+#define IS_LAYER_ON(layer) layer_state_is(layer)
+uint8_t read_source_layers_cache(keypos_t key);
+uint16_t keymap_key_to_keycode(uint8_t layer, keypos_t key);
+
+///////////////////////////////////////////////////////////////////////////////
+// Mouse.
+///////////////////////////////////////////////////////////////////////////////
+typedef struct {
+  uint8_t buttons;
+  int8_t x;
+  int8_t y;
+  int8_t v;
+  int8_t h;
+} report_mouse_t;
+
+void host_mouse_send(report_mouse_t* report);
+
+///////////////////////////////////////////////////////////////////////////////
+// Deferred execution.
+///////////////////////////////////////////////////////////////////////////////
+typedef uint8_t deferred_token;
+#define INVALID_DEFERRED_TOKEN 0
+typedef uint32_t (*deferred_exec_callback)(uint32_t trigger_time,
+                                           void* cb_arg);
+deferred_token defer_exec(uint32_t delay_ms, deferred_exec_callback callback,
+                          void* cb_arg);
+bool extend_deferred_exec(deferred_token token, uint32_t delay_ms);
+bool cancel_deferred_exec(deferred_token token);
+/** Runs due deferred callbacks. The host program calls this every tick. */
+void deferred_exec_task(void);
+
+///////////////////////////////////////////////////////////////////////////////
+// EEPROM user datablock, kept in RAM.
+///////////////////////////////////////////////////////////////////////////////
+#if defined(EECONFIG_USER_DATA_SIZE) && EECONFIG_USER_DATA_SIZE > 0
+uint32_t eeconfig_read_user_datablock(void* data, uint32_t offset,
+                                      uint32_t length);
+uint32_t eeconfig_update_user_datablock(const void* data, uint32_t offset,
+                                        uint32_t length);
+#endif  // defined(EECONFIG_USER_DATA_SIZE) && EECONFIG_USER_DATA_SIZE > 0
+
+///////////////////////////////////////////////////////////////////////////////
+// Send string, Unicode, Caps Word, Repeat Key.
+///////////////////////////////////////////////////////////////////////////////
+void send_char(char ascii_code);
+void send_string(const char* str);
+void send_string_P(const char* str);
+void send_string_with_delay(const char* str, uint8_t interval);
+void send_string_with_delay_P(const char* str, uint8_t interval);
+void send_unicode_string(const char* str);
+// Lookup tables from ASCII to keycodes, US layout.
+extern const uint8_t ascii_to_keycode_lut[128];
+extern const uint8_t ascii_to_shift_lut[16];
+extern const uint8_t ascii_to_altgr_lut[16];
+#define PGM_LOADBIT(mem, pos) \
+  ((pgm_read_byte(&((mem)[(pos) / 8])) >> ((pos) % 8)) & 0x01)
+#define SEND_STRING(string) send_string_P(PSTR(string))
+#define SEND_STRING_DELAY(string, interval) \
+  send_string_with_delay_P(PSTR(string), interval)
+#define SS_TAP(keycode) ""
+#define SS_DOWN(keycode) ""
+#define SS_UP(keycode) ""
+#define SS_DELAY(ms) ""
+#define SS_LCTL(string) string
+#define SS_LSFT(string) string
+#define SS_LALT(string) string
+#define SS_LGUI(string) string
+
+bool is_caps_word_on(void);
+void caps_word_on(void);
+void caps_word_off(void);
+bool process_caps_word(uint16_t keycode, keyrecord_t* record);
+
+uint16_t get_last_keycode(void);
+uint8_t get_last_mods(void);
+void set_last_keycode(uint16_t keycode);
+void set_last_mods(uint8_t mods);
+int8_t get_repeat_key_count(void);
+
+///////////////////////////////////////////////////////////////////////////////
+// Combos. Combos are not simulated, but getreuer.c defines a combo table.
+///////////////////////////////////////////////////////////////////////////////
+typedef struct {
+  const uint16_t* keys;
+  uint16_t keycode;
+} combo_t;
+#define COMBO_END 0
+#define COMBO(ck, ca) {.keys = &(ck)[0], .keycode = (ca)}
+
+///////////////////////////////////////////////////////////////////////////////
+// Debug printing. Output is discarded unless the host program enables it.
+///////////////////////////////////////////////////////////////////////////////
+extern bool debug_enable;
+int stub_printf(const char* format, ...)
+    __attribute__((format(printf, 1, 2)));
+#define dprint(s) \
+  do {            \
+  } while (0)
+#define dprintln(s) \
+  do {              \
+  } while (0)
+#define dprintf(...) \
+  do {               \
+  } while (0)
+#define xprintf(...) stub_printf(__VA_ARGS__)
+#define uprintf(...) stub_printf(__VA_ARGS__)
+/** Sends a char to the console, like xprintf(). */
+int8_t sendchar(uint8_t c);
+
+/** Returns the index of the most significant set bit, as in QMK's biton(). */
+uint8_t biton(uint8_t bits);
+uint8_t biton32(uint32_t bits);
+
+#ifdef __cplusplus
+}
+#endif
@@ -0,0 +1,254 @@
+// Copyright 2025 Google LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     https://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+/**
+ * @file rgb_matrix.h
+ * @brief Minimal host stand-in for QMK's RGB Matrix effect API.
+ *
+ * This header declares what custom RGB Matrix effects like palettefx.inc use:
+ * the LED config, RGB Matrix config and timer, the key hit tracker, the
+ * effect iteration macros, and the lib8tion math functions. The math
+ * functions are copied from QMK's lib8tion so that effects compute the same
+ * colors on the host as on the keyboard. The program including this header
+ * defines RGB_MATRIX_LED_COUNT first and provides the variables and the
+ * functions declared at the bottom.
+ */
+
+#pragma once
+
+#include <stdbool.h>
+#include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#ifndef RGB_MATRIX_LED_COUNT
+#error "Define RGB_MATRIX_LED_COUNT before including rgb_matrix.h."
+#endif  // RGB_MATRIX_LED_COUNT
+
+#define PROGMEM
+#define pgm_read_byte(address) (*(const uint8_t*)(address))
+#define pgm_read_word(address) (*(const uint16_t*)(address))
+
+#ifndef RGB_MATRIX_LED_PROCESS_LIMIT
+#define RGB_MATRIX_LED_PROCESS_LIMIT ((RGB_MATRIX_LED_COUNT + 4) / 5)
+#endif  // RGB_MATRIX_LED_PROCESS_LIMIT
+#ifndef RGB_MATRIX_HUE_STEP
+#define RGB_MATRIX_HUE_STEP 8
+#endif  // RGB_MATRIX_HUE_STEP
+#ifndef LED_HITS_TO_REMEMBER
+#define LED_HITS_TO_REMEMBER 8
+#endif  // LED_HITS_TO_REMEMBER
+
+///////////////////////////////////////////////////////////////////////////////
+// Types and state.
+///////////////////////////////////////////////////////////////////////////////
+typedef uint8_t led_flags_t;
+#define LED_FLAG_ALL 0xff
+#define LED_FLAG_KEYLIGHT 0x04
+#define HAS_ANY_FLAGS(bits, flags) (((bits) & (flags)) != 0)
+
+typedef struct {
+  uint8_t h;
+  uint8_t s;
+  uint8_t v;
+} hsv_t;
+
+typedef struct {
+  uint8_t r;
+  uint8_t g;
+  uint8_t b;
+} rgb_t;
+
+typedef struct {
+  uint8_t x;
+  uint8_t y;
+} led_point_t;
+
+typedef struct {
+  led_point_t point[RGB_MATRIX_LED_COUNT];
+  uint8_t flags[RGB_MATRIX_LED_COUNT];
+} led_config_t;
+
+typedef struct {
+  uint8_t enable : 2;
+  uint8_t mode : 6;
+  hsv_t hsv;
+  uint8_t speed;
+  led_flags_t flags;
+} rgb_config_t;
+
+typedef struct {
+  uint8_t iter;
+  led_flags_t flags;
+  bool init;
+} effect_params_t;
+
+typedef struct {
+  uint8_t count;
+  uint8_t x[LED_HITS_TO_REMEMBER];
+  uint8_t y[LED_HITS_TO_REMEMBER];
+  uint8_t index[LED_HITS_TO_REMEMBER];
+  uint16_t tick[LED_HITS_TO_REMEMBER];
+} last_hit_t;
+
+extern led_config_t g_led_config;
+extern rgb_config_t rgb_matrix_config;
+extern uint32_t g_rgb_timer;
+extern last_hit_t g_last_hit_tracker;
+static const led_point_t k_rgb_matrix_center = {112, 32};
+
+///////////////////////////////////////////////////////////////////////////////
+// Effect iteration.
+///////////////////////////////////////////////////////////////////////////////
+#define RGB_MATRIX_USE_LIMITS(min, max)                                 \
+  uint8_t min = RGB_MATRIX_LED_PROCESS_LIMIT * params->iter;            \
+  uint8_t max = min + RGB_MATRIX_LED_PROCESS_LIMIT;                     \
+  if (max > RGB_MATRIX_LED_COUNT) max = RGB_MATRIX_LED_COUNT;
+#define RGB_MATRIX_TEST_LED_FLAGS() \
+  if (!HAS_ANY_FLAGS(g_led_config.flags[i], params->flags)) continue
+
+static inline bool rgb_matrix_check_finished_leds(uint8_t led_idx) {
+  return led_idx < RGB_MATRIX_LED_COUNT;
+}
+
+static inline uint8_t rgb_matrix_get_hue(void) {
+  return rgb_matrix_config.hsv.h;
+}
+
+static inline hsv_t rgb_matrix_get_hsv(void) { return rgb_matrix_config.hsv; }
+
+static inline void rgb_matrix_sethsv_noeeprom(uint8_t h, uint8_t s,
+                                              uint8_t v) {
+  rgb_matrix_config.hsv = (hsv_t){h, s, v};
+}
+
+static inline bool timer_expired32(uint32_t current, uint32_t future) {
+  return (uint32_t)(current - future) < UINT32_MAX / 2;
+}
+
+///////////////////////////////////////////////////////////////////////////////
+// lib8tion.
+///////////////////////////////////////////////////////////////////////////////
+static inline uint8_t scale8(uint8_t i, uint8_t scale) {
+  return ((uint16_t)i * (1 + (uint16_t)scale)) >> 8;
+}
+
+static inline uint16_t scale16by8(uint16_t i, uint8_t scale) {
+  return ((uint32_t)i * (1 + (uint32_t)scale)) >> 8;
+}
+
+static inline uint8_t lerp8by8(uint8_t a, uint8_t b, uint8_t frac) {
+  return (b > a) ? a + scale8(b - a, frac) : a - scale8(a - b, frac);
+}
+
+static inline uint8_t qadd8(uint8_t i, uint8_t j) {
+  const uint16_t t = i + j;
+  return (t > 255) ? 255 : t;
+}
+
+static inline uint8_t abs8(int8_t i) { return (i < 0) ? -i : i; }
+
+static inline uint8_t sin8(uint8_t theta) {
+  static const uint8_t b_m16_interleave[] = {0, 49, 49, 41, 90, 27, 117, 10};
+  uint8_t offset = theta;
+  if (theta & 0x40) {
+    offset = 255 - offset;
+  }
+  offset &= 0x3f;
+  uint8_t secoffset = offset & 0x0f;
+  if (theta & 0x40) {
+    ++secoffset;
+  }
+  const uint8_t* p = b_m16_interleave + 2 * (offset >> 4);
+  const uint8_t mx = (p[1] * secoffset) >> 4;
+  int8_t y = mx + p[0];
+  if (theta & 0x80) {
+    y = -y;
+  }
+  return y + 128;
+}
+
+static inline uint8_t cos8(uint8_t theta) { return sin8(theta + 64); }
+
+static inline uint8_t sqrt16(uint16_t x) {
+  if (x <= 1) {
+    return x;
+  }
+  uint8_t low = 1;
+  uint8_t hi = (x > 7904) ? 255 : (x >> 5) + 8;
+  do {
+    const uint8_t mid = (low + hi) >> 1;
+    if ((uint16_t)(mid * mid) > x) {
+      hi = mid - 1;
+    } else {
+      if (mid == 255) {
+        return 255;
+      }
+      low = mid + 1;
+    }
+  } while (hi >= low);
+  return low - 1;
+}
+
+static inline uint8_t ease8InOutApprox(uint8_t i) {
+  if (i < 64) {
+    i /= 2;
+  } else if (i > 255 - 64) {
+    i = 255 - (255 - i) / 2;
+  } else {
+    i -= 64;
+    i += i / 2;
+    i += 32;
+  }
+  return i;
+}
+
+static inline uint8_t atan2_8(int16_t dy, int16_t dx) {
+  if (dy == 0) {
+    return (dx >= 0) ? 0 : 128;
+  }
+  const int16_t abs_y = (dy > 0) ? dy : -dy;
+  int8_t a;
+  if (dx >= 0) {
+    a = 32 - (32 * (dx - abs_y) / (dx + abs_y));
+  } else {
+    a = 96 - (32 * (dx + abs_y) / (abs_y - dx));
+  }
+  return (dy < 0) ? -a : a;
+}
+
+extern uint16_t rand16seed;
+
+static inline uint8_t random8(void) {
+  rand16seed = rand16seed * 2053 + 13849;
+  return (uint8_t)(rand16seed & 0xff) + (uint8_t)(rand16seed >> 8);
+}
+
+static inline uint8_t random8_max(uint8_t lim) {
+  return (random8() * lim) >> 8;
+}
+
+///////////////////////////////////////////////////////////////////////////////
+// Provided by the program.
+///////////////////////////////////////////////////////////////////////////////
+void rgb_matrix_set_color(int index, uint8_t red, uint8_t green, uint8_t blue);
+rgb_t rgb_matrix_hsv_to_rgb(hsv_t hsv);
+
+#ifdef __cplusplus
+}
+#endif
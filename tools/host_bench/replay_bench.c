@@ -0,0 +1,365 @@
+// Copyright 2025 Google LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     https://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+/**
+ * @file replay_bench.c
+ * @brief Replays recorded key events through getreuer.c on the host.
+ *
+ * The event log is a text file with one key event per line:
+ *
+ *     # time_ms row col p|r keycode [tap_count]
+ *     1000 2 3 p 0x2217 1
+ *     1090 2 3 r 0x2217 1
+ *
+ * where `keycode` is the keycode at that position (as QMK would pass to
+ * process_record_user()) in decimal or hex and `tap_count` is the tap count
+ * that QMK's tap-hold logic settled on, default 0. Lines starting with # are
+ * comments. Events must be sorted by time. make_replay_log.py generates logs
+ * from plain text.
+ *
+ * Events are replayed in virtual time. Between events, housekeeping is run
+ * once per millisecond as if the keyboard were scanning. Each feature handler
+ * and task is timed through linker wrappers (see the Makefile), so times are
+ * inclusive: when Achordion replays an event, handlers it calls recursively
+ * are counted both on their own line and within Achordion's. Tick counts are
+ * CPU cycles from the time stamp counter where available and otherwise
+ * nanoseconds.
+ *
+ * Usage: replay_bench [-n iterations] [-v] log [log...]
+ *
+ * With `replay_bench -k`, keycodes read from stdin are instead printed one per
+ * line as formatted by keycode_string() with the keymap's custom names. The
+ * event trace decoder tools/trace_decode.py uses this to name keycodes.
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+#if defined(__x86_64__) || defined(__i386__)
+#include <x86intrin.h>
+#endif
+
+#include "qmk_stub.h"
+#ifdef KEYCODE_STRING_ENABLE
+#include "features/keycode_string.h"
+#endif  // KEYCODE_STRING_ENABLE
+
+typedef struct {
+  uint32_t time;
+  keypos_t key;
+  bool pressed;
+  uint16_t keycode;
+  uint8_t tap_count;
+} replay_event_t;
+
+typedef struct {
+  const char* name;
+  uint64_t calls;
+  uint64_t ticks;
+  uint8_t depth;
+} counter_t;
+
+enum {
+  COUNTER_PROCESS_RECORD,
+  COUNTER_ACHORDION,
+  COUNTER_ORBITAL_MOUSE,
+  COUNTER_SENTENCE_CASE,
+  COUNTER_CUSTOM_SHIFT_KEYS,
+  COUNTER_HOUSEKEEPING,
+  COUNTER_ACHORDION_TASK,
+  COUNTER_ORBITAL_MOUSE_TASK,
+  COUNTER_SENTENCE_CASE_TASK,
+  COUNTER_DEFERRED_EXEC,
+  NUM_COUNTERS,
+};
+
+static counter_t counters[NUM_COUNTERS] = {
+    [COUNTER_PROCESS_RECORD] = {"process_record (per event)"},
+    [COUNTER_ACHORDION] = {"  process_achordion"},
+    [COUNTER_ORBITAL_MOUSE] = {"  process_orbital_mouse"},
+    [COUNTER_SENTENCE_CASE] = {"  process_sentence_case"},
+    [COUNTER_CUSTOM_SHIFT_KEYS] = {"  process_custom_shift_keys"},
+    [COUNTER_HOUSEKEEPING] = {"housekeeping_task_user (per ms)"},
+    [COUNTER_ACHORDION_TASK] = {"  achordion_task"},
+    [COUNTER_ORBITAL_MOUSE_TASK] = {"  orbital_mouse_task"},
+    [COUNTER_SENTENCE_CASE_TASK] = {"  sentence_case_task"},
+    [COUNTER_DEFERRED_EXEC] = {"deferred_exec_task (per ms)"},
+};
+
+// Cost of an empty start/stop measurement, subtracted from each call.
+static uint64_t clock_overhead = 0;
+
+static inline uint64_t read_ticks(void) {
+#if defined(__x86_64__) || defined(__i386__)
+  return __rdtsc();
+#else
+  struct timespec ts;
+  clock_gettime(CLOCK_MONOTONIC, &ts);
+  return (uint64_t)ts.tv_sec * 1000000000 + ts.tv_nsec;
+#endif
+}
+
+static uint64_t read_ns(void) {
+  struct timespec ts;
+  clock_gettime(CLOCK_MONOTONIC, &ts);
+  return (uint64_t)ts.tv_sec * 1000000000 + ts.tv_nsec;
+}
+
+static void calibrate_clock_overhead(void) {
+  uint64_t best = UINT64_MAX;
+  for (int i = 0; i < 10000; ++i) {
+    const uint64_t start = read_ticks();
+    const uint64_t elapsed = read_ticks() - start;
+    if (elapsed < best) {
+      best = elapsed;
+    }
+  }
+  clock_overhead = best;
+}
+
+static inline uint64_t counter_start(counter_t* c) {
+  return (c->depth++ == 0) ? read_ticks() : 0;
+}
+
+static inline void counter_stop(counter_t* c, uint64_t start) {
+  if (--c->depth == 0) {
+    const uint64_t elapsed = read_ticks() - start;
+    c->ticks += (elapsed > clock_overhead) ? elapsed - clock_overhead : 0;
+    ++c->calls;
+  }
+}
+
+// Times a call to `__real_<fun>`, which the linker resolves to the original
+// definition of `fun` when linking with `-Wl,--wrap=<fun>`.
+#define WRAP_HANDLER(fun, counter)                                  \
+  bool __real_##fun(uint16_t keycode, keyrecord_t* record);         \
+  bool __wrap_##fun(uint16_t keycode, keyrecord_t* record) {        \
+    const uint64_t start = counter_start(&counters[counter]);       \
+    const bool result = __real_##fun(keycode, record);              \
+    counter_stop(&counters[counter], start);                        \
+    return result;                                                  \
+  }
+#define WRAP_TASK(fun, counter)                                     \
+  void __real_##fun(void);                                          \
+  void __wrap_##fun(void) {                                         \
+    const uint64_t start = counter_start(&counters[counter]);       \
+    __real_##fun();                                                 \
+    counter_stop(&counters[counter], start);                        \
+  }
+
+#ifdef ACHORDION_ENABLE
+WRAP_HANDLER(process_achordion, COUNTER_ACHORDION)
+WRAP_TASK(achordion_task, COUNTER_ACHORDION_TASK)
+#endif  // ACHORDION_ENABLE
+#ifdef ORBITAL_MOUSE_ENABLE
+WRAP_HANDLER(process_orbital_mouse, COUNTER_ORBITAL_MOUSE)
+WRAP_TASK(orbital_mouse_task, COUNTER_ORBITAL_MOUSE_TASK)
+#endif  // ORBITAL_MOUSE_ENABLE
+#ifdef SENTENCE_CASE_ENABLE
+WRAP_HANDLER(process_sentence_case, COUNTER_SENTENCE_CASE)
+#ifndef IDLE_TIMEOUT_ENABLE  // Otherwise sentence_case_task() is inline.
+WRAP_TASK(sentence_case_task, COUNTER_SENTENCE_CASE_TASK)
+#endif  // IDLE_TIMEOUT_ENABLE
+#endif  // SENTENCE_CASE_ENABLE
+#ifdef CUSTOM_SHIFT_KEYS_ENABLE
+WRAP_HANDLER(process_custom_shift_keys, COUNTER_CUSTOM_SHIFT_KEYS)
+#endif  // CUSTOM_SHIFT_KEYS_ENABLE
+
+static replay_event_t* events = NULL;
+static size_t num_events = 0;
+static size_t events_capacity = 0;
+
+static bool load_log(const char* filename) {
+  FILE* f = fopen(filename, "r");
+  if (!f) {
+    fprintf(stderr, "Error: Could not open \"%s\".\n", filename);
+    return false;
+  }
+  // Logs are concatenated in time, each continuing after the previous.
+  const uint32_t time_offset =
+      num_events ? events[num_events - 1].time + 1000 : 0;
+  char line[256];
+  int line_number = 0;
+  while (fgets(line, sizeof(line), f)) {
+    ++line_number;
+    char* s = line + strspn(line, " \t");
+    if (*s == '#' || *s == '\n' || *s == '\0') {
+      continue;
+    }
+    unsigned long time, row, col, keycode, tap_count = 0;
+    char action;
+    char keycode_str[16];
+    const int n = sscanf(s, "%lu %lu %lu %c %15s %lu", &time, &row, &col,
+                         &action, keycode_str, &tap_count);
+    keycode = strtoul(keycode_str, NULL, 0);
+    if (n < 5 || (action != 'p' && action != 'r') || row >= MATRIX_ROWS ||
+        col >= MATRIX_COLS || keycode > 0xFFFF || tap_count > 15) {
+      fprintf(stderr, "%s:%d: Error: Invalid event.\n", filename, line_number);
+      fclose(f);
+      return false;
+    }
+    if (num_events == events_capacity) {
+      events_capacity = events_capacity ? 2 * events_capacity : 1024;
+      events = realloc(events, events_capacity * sizeof(replay_event_t));
+    }
+    replay_event_t* e = &events[num_events++];
+    e->time = time_offset + (uint32_t)time;
+    e->key = (keypos_t){.row = (uint8_t)row, .col = (uint8_t)col};
+    e->pressed = (action == 'p');
+    e->keycode = (uint16_t)keycode;
+    e->tap_count = (uint8_t)tap_count;
+    if (num_events > 1 && e->time < e[-1].time) {
+      fprintf(stderr, "%s:%d: Error: Events must be sorted by time.\n",
+              filename, line_number);
+      fclose(f);
+      return false;
+    }
+  }
+  fclose(f);
+  return true;
+}
+
+// Runs one scan's worth of housekeeping.
+static void tick(void) {
+  const uint64_t start = counter_start(&counters[COUNTER_HOUSEKEEPING]);
+  housekeeping_task_user();
+  counter_stop(&counters[COUNTER_HOUSEKEEPING], start);
+  counter_t* deferred = &counters[COUNTER_DEFERRED_EXEC];
+  const uint64_t deferred_start = counter_start(deferred);
+  deferred_exec_task();
+  counter_stop(deferred, deferred_start);
+}
+
+static void replay(uint32_t start_time) {
+  uint32_t now = start_time;
+  for (size_t i = 0; i < num_events; ++i) {
+    const replay_event_t* e = &events[i];
+    const uint32_t event_time = start_time + e->time;
+    while (now < event_time) {
+      stub_set_time(++now);
+      tick();
+    }
+
+    keyrecord_t record = {
+        .event =
+            {
+                .key = e->key,
+                .time = (uint16_t)(event_time | 1),
+                .type = KEY_EVENT,
+                .pressed = e->pressed,
+            },
+        .tap = {.count = e->tap_count},
+    };
+    stub_set_keycode(e->key, e->keycode);
+    const uint64_t start = counter_start(&counters[COUNTER_PROCESS_RECORD]);
+    process_record(&record);
+    counter_stop(&counters[COUNTER_PROCESS_RECORD], start);
+    tick();
+  }
+  // Let timeouts in the features expire before the next iteration.
+  for (uint32_t end = now + 3000; now < end;) {
+    stub_set_time(++now);
+    tick();
+  }
+}
+
+// Prints the name of each keycode read from stdin.
+static int print_keycode_names(void) {
+#ifdef KEYCODE_STRING_ENABLE
+  char word[32];
+  while (scanf("%31s", word) == 1) {
+    const uint16_t keycode = (uint16_t)strtoul(word, NULL, 0);
+    printf("%s\n", keycode_string(keycode));
+  }
+  return 0;
+#else
+  fprintf(stderr, "Error: -k requires KEYCODE_STRING_ENABLE.\n");
+  return 1;
+#endif  // KEYCODE_STRING_ENABLE
+}
+
+int main(int argc, char** argv) {
+  int iterations = 20;
+  bool verbose = false;
+  int i;
+  for (i = 1; i < argc && argv[i][0] == '-'; ++i) {
+    if (!strcmp(argv[i], "-n") && i + 1 < argc) {
+      iterations = atoi(argv[++i]);
+    } else if (!strcmp(argv[i], "-v")) {
+      verbose = true;
+    } else if (!strcmp(argv[i], "-k")) {
+      return print_keycode_names();
+    } else {
+      fprintf(stderr,
+              "Usage: %s [-n iterations] [-v] log [log...]\n"
+              "       %s -k < keycodes\n",
+              argv[0], argv[0]);
+      return 1;
+    }
+  }
+  if (i == argc) {
+    fprintf(stderr, "Error: No log specified.\n");
+    return 1;
+  }
+  for (; i < argc; ++i) {
+    if (!load_log(argv[i])) {
+      return 1;
+    }
+  }
+  if (num_events == 0 || iterations < 1) {
+    fprintf(stderr, "Error: Nothing to replay.\n");
+    return 1;
+  }
+
+  calibrate_clock_overhead();
+  stub_reset();
+  debug_enable = verbose;
+  stub_set_print_enabled(verbose);
+  keyboard_post_init_user();
+
+  // Measure ticks per nanosecond over the whole run.
+  const uint64_t start_ns = read_ns();
+  const uint64_t start_ticks = read_ticks();
+  const uint32_t period = events[num_events - 1].time + 5000;
+  for (int iter = 0; iter < iterations; ++iter) {
+    replay(1000 + (uint32_t)iter * period);
+  }
+  const double ticks_per_ns =
+      (double)(read_ticks() - start_ticks) / (double)(read_ns() - start_ns);
+
+  printf("Replayed %zu events x %d iterations.\n\n", num_events, iterations);
+  printf("%-34s %10s %10s %10s\n", "", "calls", "ns/call", "ticks/call");
+  for (int c = 0; c < NUM_COUNTERS; ++c) {
+    const counter_t* counter = &counters[c];
+    if (counter->calls == 0) {
+      continue;
+    }
+    const double ticks = (double)counter->ticks / (double)counter->calls;
+    printf("%-34s %10llu %10.1f %10.1f\n", counter->name,
+           (unsigned long long)counter->calls, ticks / ticks_per_ns, ticks);
+  }
+
+  const double events_run = (double)num_events * iterations;
+  printf("\nKeyboard reports per event: %.2f (%.2f changed)\n",
+         stub_counters.keyboard_reports / events_run,
+         stub_counters.keyboard_report_changes / events_run);
+  printf("Mouse reports per event:    %.2f\n",
+         stub_counters.mouse_reports / events_run);
+  printf("Chars sent per event:       %.2f\n",
+         stub_counters.chars_sent / events_run);
+  free(events);
+  return 0;
+}
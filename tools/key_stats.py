@@ -0,0 +1,183 @@
+# Copyright 2025 Google LLC
+#
+# Licensed under the Apache License, Version 2.0 (the "License");
+# you may not use this file except in compliance with the License.
+# You may obtain a copy of the License at
+#
+#     https://www.apache.org/licenses/LICENSE-2.0
+#
+# Unless required by applicable law or agreed to in writing, software
+# distributed under the License is distributed on an "AS IS" BASIS,
+# WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+# See the License for the specific language governing permissions and
+# limitations under the License.
+
+"""Reads key stats from the keyboard and prints frequency reports.
+
+The stats are counted on the keyboard by features/key_stats.c and read over raw
+HID, which requires the hidapi Python package (`pip install hid`). Reports are
+printed in the same format as count_chars.py, one for key presses and one for
+same-hand bigrams. Keys are named by their base layer keycodes, using
+`replay_bench -k` as in trace_decode.py, and their (row,col) positions.
+
+Usage:
+
+    python3 key_stats.py [--bigrams N] [--save stats.json]
+    python3 key_stats.py --load stats.json
+    python3 key_stats.py --reset
+"""
+
+import argparse
+import json
+import struct
+import sys
+from typing import Dict, List, NamedTuple, Tuple
+
+from trace_decode import DEFAULT_BENCH, keycode_names
+
+RAW_HID_USAGE_PAGE = 0xFF60  # QMK's default RAW_USAGE_PAGE.
+RAW_HID_USAGE = 0x61  # QMK's default RAW_USAGE_ID.
+REPORT_SIZE = 32  # QMK's RAW_EPSIZE.
+KEY_STATS_RAW_HID_ID = 0x4B  # Matches features/key_stats.h.
+HEADER_SIZE = 4  # ID, command, and 2-byte argument.
+
+
+class Stats(NamedTuple):
+  rows: int
+  cols: int
+  keycodes: List[int]
+  key_counts: List[int]
+  bigrams: List[Tuple[int, int, int]]  # (first, second, count).
+
+
+class Device:
+  """Raw HID connection to the keyboard."""
+
+  def __init__(self):
+    try:
+      import hid  # pylint: disable=import-outside-toplevel
+    except ImportError:
+      sys.exit('Error: Reading the keyboard requires hidapi: pip install hid')
+    for info in hid.enumerate():
+      if (info['usage_page'] == RAW_HID_USAGE_PAGE and
+          info['usage'] == RAW_HID_USAGE):
+        self._device = hid.device()
+        self._device.open_path(info['path'])
+        return
+    sys.exit('Error: No keyboard with raw HID found.')
+
+  def request(self, command: str, arg: int = 0) -> bytes:
+    """Sends a request and returns the reply's payload."""
+    report = bytes([KEY_STATS_RAW_HID_ID, ord(command), arg & 0xff, arg >> 8])
+    # The first byte written is the report ID, which is 0 for QMK.
+    self._device.write(b'\0' + report.ljust(REPORT_SIZE, b'\0'))
+    while True:
+      reply = bytes(self._device.read(REPORT_SIZE, 1000))
+      if not reply:
+        sys.exit('Error: No reply from the keyboard.')
+      if reply[:HEADER_SIZE] == report:
+        return reply[HEADER_SIZE:]
+
+
+def read_stats(device: Device) -> Stats:
+  """Reads the stats from the keyboard."""
+  info = device.request('i')
+  rows, cols, num_bigrams = info[0], info[1], info[2]
+  size = info[3] | info[4] << 8
+
+  data = b''
+  while len(data) < size:
+    data += device.request('r', len(data))
+  keycodes = []
+  while len(keycodes) < rows * cols:
+    payload = device.request('k', len(keycodes))
+    count = min(len(payload) // 2, rows * cols - len(keycodes))
+    keycodes += struct.unpack_from(f'<{count}H', payload)
+  return parse_stats(rows, cols, num_bigrams, keycodes, data[:size])
+
+
+def parse_stats(rows: int, cols: int, num_bigrams: int, keycodes: List[int],
+                data: bytes) -> Stats:
+  """Parses `key_stats_t` from its bytes."""
+  num_keys = rows * cols
+  key_counts = list(struct.unpack_from(f'<{num_keys}H', data, 2))
+  bigrams = [
+      struct.unpack_from('<BBH', data, 2 + 2 * num_keys + 4 * i)
+      for i in range(num_bigrams)
+  ]
+  return Stats(rows, cols, keycodes, key_counts,
+               [b for b in bigrams if b[2] > 0])
+
+
+def save_stats(stats: Stats, file_name: str) -> None:
+  with open(file_name, 'wt') as f:
+    json.dump(stats._asdict(), f)
+
+
+def load_stats(file_name: str) -> Stats:
+  with open(file_name, 'rt') as f:
+    d = json.load(f)
+  return Stats(d['rows'], d['cols'], d['keycodes'], d['key_counts'],
+               [tuple(b) for b in d['bigrams']])
+
+
+def print_count_table(title: str, counts: Dict[str, int],
+                      limit: int) -> None:
+  """Prints a table of counts like count_chars.py."""
+  width = max([5] + [len(label) for label in counts])
+  ranked = sorted(counts, key=lambda label: -counts[label])
+  total = sum(counts.values())
+  print(f'{"Rank":<4} {title:>{width}} {"count":>8} {"%":>8}')
+  for i, label in enumerate(ranked[:limit]):
+    percent = (100.0 / total) * counts[label]
+    print(f'#{(i + 1):<3} {label:>{width}} {counts[label]:8} {percent:8.3f}')
+
+  print(f'\ntotal {title}s: {total}\n')
+
+
+def print_reports(stats: Stats, num_bigrams: int, bench: str) -> None:
+  """Prints the key press and bigram reports."""
+  names = keycode_names(stats.keycodes, bench)
+
+  def key_label(index: int) -> str:
+    row, col = divmod(index, stats.cols)
+    return f'{names[stats.keycodes[index]]} ({row},{col})'
+
+  print_count_table(
+      'key', {key_label(i): count for i, count in enumerate(stats.key_counts)
+              if count > 0}, len(stats.key_counts))
+  print_count_table(
+      'bigram', {f'{key_label(a)} {key_label(b)}': count
+                 for a, b, count in stats.bigrams}, num_bigrams)
+
+
+def main(argv):
+  parser = argparse.ArgumentParser(description=__doc__.split('\n')[0])
+  parser.add_argument('--load', help='Read stats saved with --save instead '
+                      'of from the keyboard.')
+  parser.add_argument('--save', help='Also save the stats to this file.')
+  parser.add_argument('--reset', action='store_true',
+                      help='Clear the stats on the keyboard.')
+  parser.add_argument('--bigrams', type=int, default=30,
+                      help='Number of bigrams to print.')
+  parser.add_argument('--bench', default=DEFAULT_BENCH,
+                      help='Path of replay_bench, for naming keycodes.')
+  args = parser.parse_args(argv[1:])
+
+  if args.load:
+    stats = load_stats(args.load)
+  else:
+    device = Device()
+    if args.reset:
+      device.request('z')
+      print('Cleared key stats.')
+      return
+    stats = read_stats(device)
+
+  if args.save:
+    save_stats(stats, args.save)
+  print_reports(stats, args.bigrams, args.bench)
+
+
+if __name__ == '__main__':
+  main(sys.argv)
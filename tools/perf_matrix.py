@@ -0,0 +1,355 @@
+# Copyright 2025 Google LLC
+#
+# Licensed under the Apache License, Version 2.0 (the "License");
+# you may not use this file except in compliance with the License.
+# You may obtain a copy of the License at
+#
+#     https://www.apache.org/licenses/LICENSE-2.0
+#
+# Unless required by applicable law or agreed to in writing, software
+# distributed under the License is distributed on an "AS IS" BASIS,
+# WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+# See the License for the specific language governing permissions and
+# limitations under the License.
+
+"""Measures firmware size and event latency across boards and features.
+
+Each board's getreuer keymap is compiled with `qmk compile`, first with the
+defaults and then with each toggle of the shared rules.mk flipped one at a time,
+like `-e ACHORDION_ENABLE=no`. The .text, .data, and .bss sizes of each build
+are read from its .elf, so the difference from the default row is what a
+feature costs. With --objects, each board is also compiled once without LTO to
+report the sizes of getreuer.o and the features/*.o objects. These are before
+the linker drops unused sections, so the toggle rows are the accurate measure.
+
+The host replay benchmark in host_bench/ is likewise built and run with each of
+its toggles flipped, reporting ns per call of each handler (the best of --runs
+runs) and reports per event. Host times are only comparable on the same
+machine.
+
+Results may be saved with --save and compared with --baseline, which adds the
+change of each value from the baseline to the report:
+
+    python3 perf_matrix.py --save baseline.json
+    # ... make changes ...
+    python3 perf_matrix.py --baseline baseline.json
+
+Without qmk, or with --no-firmware, only the host benchmark runs.
+
+Usage:
+
+    python3 perf_matrix.py [--boards B,...] [--features F,...] [--objects]
+        [--no-firmware] [--no-host] [--runs 3] [--save F] [--baseline F]
+"""
+
+import argparse
+import glob
+import json
+import os
+import re
+import shutil
+import subprocess
+import sys
+from typing import Dict, List, Optional, Tuple
+
+TOOLS_DIR = os.path.dirname(os.path.abspath(__file__))
+ROOT_DIR = os.path.dirname(TOOLS_DIR)
+HOST_BENCH_DIR = os.path.join(TOOLS_DIR, 'host_bench')
+KEYMAP = 'getreuer'
+
+# Flash available to the firmware, or None if it's not a concern. The Dactyl's
+# Pro Micro is an ATmega32U4 with 32 KB flash, 4 KB of which is the bootloader.
+BOARDS = {
+    'zsa/moonlander': None,
+    'zsa/voyager': None,
+    'handwired/dactyl_promicro': 28672,
+}
+
+# ELF e_machine values and the size program for each.
+SIZE_PROGRAMS = {83: 'avr-size', 40: 'arm-none-eabi-size'}
+
+TOGGLE_PATTERN = re.compile(r'^(\w+_ENABLE) \?= (yes|no)\s*$', re.MULTILINE)
+BENCH_ROW_PATTERN = re.compile(
+    r'^(\s*\S.*?)\s{2,}(\d+)\s+([\d.]+)\s+([\d.]+)$')
+BENCH_RATE_PATTERN = re.compile(r'^(\w[\w ]*? per event):\s+([\d.]+)')
+
+Sizes = Dict[str, int]  # .text, .data, .bss, flash, and ram.
+
+
+def read_toggles(makefile: str) -> Dict[str, str]:
+  """Reads the feature toggles `X_ENABLE ?= yes|no` of a makefile."""
+  with open(makefile, 'rt') as f:
+    return dict(TOGGLE_PATTERN.findall(f.read()))
+
+
+def config_list(toggles: Dict[str, str],
+                features: Optional[List[str]]) -> List[Tuple[str, List[str]]]:
+  """Returns (name, assignments) of the default and each flipped toggle.
+
+  `features` selects which toggles to flip, default all. Toggles joined with
+  "+", like KEY_EVENT_ENABLE+KEY_HISTORY_ENABLE, are flipped together. Groups
+  with toggles that aren't in `toggles` are skipped.
+  """
+  configs = [('default', [])]
+  for group in features or toggles:
+    names = group.split('+')
+    if not all(name in toggles for name in names):
+      continue
+    assignments = [f'{name}={"no" if toggles[name] == "yes" else "yes"}'
+                   for name in names]
+    configs.append((' '.join(assignments), assignments))
+  return configs
+
+
+def run(args: List[str], cwd: Optional[str] = None) -> Optional[str]:
+  """Runs a command, returning its stdout or None with its output on failure."""
+  result = subprocess.run(args, cwd=cwd, capture_output=True, text=True)
+  if result.returncode != 0:
+    output = (result.stdout + result.stderr).splitlines()
+    print(f'Error: {" ".join(args)} failed:', *output[-10:], sep='\n',
+          file=sys.stderr)
+    return None
+  return result.stdout
+
+
+###############################################################################
+# Firmware.
+###############################################################################
+
+
+def size_program(elf: str) -> str:
+  """Chooses the size program for the architecture of `elf`."""
+  with open(elf, 'rb') as f:
+    header = f.read(20)
+  return SIZE_PROGRAMS.get(int.from_bytes(header[18:20], 'little'), 'size')
+
+
+def read_sizes(files: List[str]) -> Dict[str, Sizes]:
+  """Reads section sizes of ELF files, mapped by file name."""
+  if not files:
+    return {}
+  output = run([size_program(files[0])] + files)
+  if output is None:
+    return {}
+  sizes = {}
+  for line in output.splitlines()[1:]:
+    text, data, bss, _, _, file_name = line.split(maxsplit=5)
+    text, data, bss = int(text), int(data), int(bss)
+    sizes[file_name] = {'text': text, 'data': data, 'bss': bss,
+                        'flash': text + data, 'ram': data + bss}
+  return sizes
+
+
+def build_firmware(qmk_home: str, board: str,
+                   assignments: List[str]) -> Optional[str]:
+  """Compiles the keymap for `board`, returning the path of its .elf."""
+  args = ['qmk', 'compile', '-kb', board, '-km', KEYMAP]
+  for assignment in assignments:
+    args += ['-e', assignment]
+  if run(args, cwd=ROOT_DIR) is None:
+    return None
+  return os.path.join(qmk_home, '.build',
+                      f'{board.replace("/", "_")}_{KEYMAP}.elf')
+
+
+def measure_firmware(boards: List[str], features: Optional[List[str]],
+                     objects: bool) -> Dict[str, Dict]:
+  """Builds each board in each configuration and reads the sizes."""
+  qmk_home = (run(['qmk', 'config', '-ro', 'user.qmk_home']) or '')
+  qmk_home = qmk_home.strip().partition('=')[2]
+  if not qmk_home or qmk_home == 'None':
+    print('Error: `qmk config -ro user.qmk_home` is not set.', file=sys.stderr)
+    return {}
+  toggles = read_toggles(os.path.join(ROOT_DIR, 'rules.mk'))
+
+  results = {}
+  for board in boards:
+    results[board] = {'configs': {}, 'objects': {}}
+    for name, assignments in config_list(toggles, features):
+      print(f'Compiling {board} {name} ...', file=sys.stderr)
+      elf = build_firmware(qmk_home, board, assignments)
+      results[board]['configs'][name] = (
+          read_sizes([elf]).get(elf) if elf else None)
+
+    if objects:
+      print(f'Compiling {board} without LTO ...', file=sys.stderr)
+      if build_firmware(qmk_home, board, ['LTO_ENABLE=no']):
+        obj_dir = os.path.join(qmk_home, '.build',
+                               f'obj_{board.replace("/", "_")}_{KEYMAP}')
+        files = sorted(
+            glob.glob(os.path.join(obj_dir, '**', f'{KEYMAP}.o'),
+                      recursive=True) +
+            glob.glob(os.path.join(obj_dir, '**', 'features', '*.o'),
+                      recursive=True))
+        results[board]['objects'] = {
+            os.path.basename(f): s for f, s in read_sizes(files).items()}
+  return results
+
+
+###############################################################################
+# Host benchmark.
+###############################################################################
+
+
+def parse_bench(output: str) -> Dict[str, float]:
+  """Parses replay_bench output to {row name: ns per call or rate}."""
+  values = {}
+  for line in output.splitlines():
+    match = BENCH_ROW_PATTERN.match(line)
+    if match:
+      values[match.group(1).rstrip()] = float(match.group(3))
+      continue
+    match = BENCH_RATE_PATTERN.match(line)
+    if match:
+      values[match.group(1)] = float(match.group(2))
+  return values
+
+
+def measure_host(features: Optional[List[str]], runs: int) -> Dict[str, Dict]:
+  """Builds and runs replay_bench in each configuration."""
+  toggles = read_toggles(os.path.join(HOST_BENCH_DIR, 'Makefile'))
+  results = {}
+  for name, assignments in config_list(toggles, features):
+    build = os.path.join('build', 'perf', re.sub(r'\W', '_', name))
+    bench = os.path.join(HOST_BENCH_DIR, build, 'replay_bench')
+    log = os.path.join(HOST_BENCH_DIR, build, 'sample.log')
+    print(f'Running host bench {name} ...', file=sys.stderr)
+    if run(['make', '-s', f'BUILD={build}'] + assignments +
+           ['all', f'{build}/sample.log'], cwd=HOST_BENCH_DIR) is None:
+      results[name] = None
+      continue
+    best = {}
+    for _ in range(runs):
+      output = run([bench, log])
+      if output is None:
+        break
+      for row, value in parse_bench(output).items():
+        best[row] = min(value, best.get(row, value))
+    results[name] = best
+  return results
+
+
+###############################################################################
+# Report.
+###############################################################################
+
+
+def format_delta(value: float, base: Optional[float], percent: bool) -> str:
+  """Formats the change from `base`, or an empty string if no base."""
+  if base is None:
+    return ''
+  if percent:
+    return f'{100.0 * (value - base) / base:+.1f}%' if base else ''
+  return f'{value - base:+d}'
+
+
+def print_size_table(title: str, sizes: Dict[str, Sizes],
+                     baseline: Dict[str, Sizes],
+                     budget: Optional[int] = None) -> None:
+  """Prints a table of sizes with changes from the default and baseline."""
+  width = max([6] + [len(name) for name in sizes])
+  print(title)
+  print(f'{"":<{width}} {".text":>7} {".data":>6} {".bss":>6} {"flash":>7} '
+        f'{"RAM":>6} {"saved":>6} {"flash+-":>8} {"RAM+-":>6}')
+  default = sizes.get('default')
+  for name, s in sizes.items():
+    if s is None:
+      print(f'{name:<{width}} build failed')
+      continue
+    saved = ''
+    if default and name != 'default':
+      saved = f'{default["flash"] - s["flash"]:d}'
+    base = baseline.get(name) or {}
+    print(f'{name:<{width}} {s["text"]:7} {s["data"]:6} {s["bss"]:6} '
+          f'{s["flash"]:7} {s["ram"]:6} {saved:>6} '
+          f'{format_delta(s["flash"], base.get("flash"), False):>8} '
+          f'{format_delta(s["ram"], base.get("ram"), False):>6}')
+  if budget and default:
+    free = budget - default['flash']
+    print(f'default uses {default["flash"]} of {budget} bytes flash, ' +
+          (f'{free} free.' if free >= 0 else f'{-free} OVER BUDGET.'))
+  print()
+
+
+def print_host_table(results: Dict[str, Dict], baseline: Dict[str, Dict]):
+  """Prints host bench values with changes from the default and baseline."""
+  default = results.get('default') or {}
+  print('Host replay bench, ns per call (best of runs) and reports per event')
+  print(f'{"":<40} {"value":>9} {"default+-":>10} {"baseline+-":>10}')
+  for name, values in results.items():
+    base = baseline.get(name) or {}
+    if values is None:
+      print(f'{name} build failed')
+      continue
+    print(name)
+    for row, value in values.items():
+      vs_default = ''
+      if name != 'default':
+        vs_default = format_delta(value, default.get(row), True)
+      print(f'  {row:<38} {value:9.2f} {vs_default:>10} '
+            f'{format_delta(value, base.get(row), True):>10}')
+  print()
+
+
+def print_report(results: Dict, baseline: Dict) -> None:
+  firmware = results.get('firmware', {})
+  base_firmware = baseline.get('firmware', {})
+  if firmware:
+    print('Firmware sizes in bytes. flash = .text + .data, RAM = .data + .bss,'
+          '\n"saved" is the flash saved relative to the default config.\n')
+  for board, board_results in firmware.items():
+    base = base_firmware.get(board, {})
+    print_size_table(board, board_results['configs'], base.get('configs', {}),
+                     BOARDS.get(board))
+    if board_results['objects']:
+      print_size_table(f'{board} objects, without LTO',
+                       board_results['objects'], base.get('objects', {}))
+  if results.get('host'):
+    print_host_table(results['host'], baseline.get('host', {}))
+
+
+def main(argv):
+  parser = argparse.ArgumentParser(description=__doc__.split('\n')[0])
+  parser.add_argument('--boards', default=','.join(BOARDS),
+                      help='Comma-separated boards to compile.')
+  parser.add_argument('--features',
+                      help='Comma-separated toggles to flip, default all. '
+                      'Toggles joined with + are flipped together.')
+  parser.add_argument('--objects', action='store_true',
+                      help='Also report sizes of feature objects.')
+  parser.add_argument('--no-firmware', action='store_true',
+                      help='Skip compiling firmware.')
+  parser.add_argument('--no-host', action='store_true',
+                      help='Skip the host replay bench.')
+  parser.add_argument('--runs', type=int, default=3,
+                      help='Runs of the host bench per config.')
+  parser.add_argument('--save', help='Save results to this JSON file.')
+  parser.add_argument('--baseline', help='Compare with results saved with '
+                      '--save.')
+  args = parser.parse_args(argv[1:])
+  features = args.features.split(',') if args.features else None
+
+  baseline = {}
+  if args.baseline:
+    with open(args.baseline, 'rt') as f:
+      baseline = json.load(f)
+
+  results = {}
+  if not args.no_firmware:
+    if shutil.which('qmk'):
+      results['firmware'] = measure_firmware(
+          args.boards.split(','), features, args.objects)
+    else:
+      print('Warning: qmk not found. Skipping firmware sizes.',
+            file=sys.stderr)
+  if not args.no_host:
+    results['host'] = measure_host(features, args.runs)
+
+  if args.save:
+    with open(args.save, 'wt') as f:
+      json.dump(results, f, indent=2)
+  print_report(results, baseline)
+
+
+if __name__ == '__main__':
+  main(sys.argv)
@@ -0,0 +1,141 @@
+# Copyright 2025 Google LLC
+#
+# Licensed under the Apache License, Version 2.0 (the "License");
+# you may not use this file except in compliance with the License.
+# You may obtain a copy of the License at
+#
+#     https://www.apache.org/licenses/LICENSE-2.0
+#
+# Unless required by applicable law or agreed to in writing, software
+# distributed under the License is distributed on an "AS IS" BASIS,
+# WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+# See the License for the specific language governing permissions and
+# limitations under the License.
+
+"""Decodes event trace records in a console log to text.
+
+Lines of the form "ET <16 hex digits>", sent by features/event_trace.c, are
+replaced with the same text as the keymap's text log (dlog_record() in
+getreuer.c), like
+
+    L0  ( 2, 3) tap  press   LSFT_T(KC_S)
+
+Other lines are passed through unchanged. Keycodes are named with
+keycode_string() by running the host bench as `replay_bench -k`, so build it
+first with `make -C tools/host_bench`. Without it, keycodes are written in hex.
+
+Usage:
+
+    python3 trace_decode.py [--time] [--bench PATH] console.log > decoded.txt
+"""
+
+import argparse
+import os
+import re
+import subprocess
+import sys
+from typing import Dict, Iterable, List, NamedTuple
+
+# Bits of the flags byte, matching features/event_trace.h.
+PRESSED = 1 << 0
+TAP_HOLD = 1 << 1
+TAP = 1 << 2
+COMBO = 1 << 3
+DROPPED = 1 << 7
+
+RECORD_PATTERN = re.compile(r'\bET ([0-9a-fA-F]{16})\b')
+DEFAULT_BENCH = os.path.join(
+    os.path.dirname(os.path.abspath(__file__)),
+    'host_bench', 'build', 'replay_bench')
+
+
+class Record(NamedTuple):
+  dt: int
+  row: int
+  col: int
+  layer: int
+  flags: int
+  keycode: int
+
+
+def parse_record(hex_digits: str) -> Record:
+  """Parses a record from its 8 bytes in hex. Multibyte fields are LE."""
+  b = bytes.fromhex(hex_digits)
+  return Record(dt=b[0] | b[1] << 8, row=b[2], col=b[3], layer=b[4],
+                flags=b[5], keycode=b[6] | b[7] << 8)
+
+
+def keycode_names(keycodes: Iterable[int], bench: str) -> Dict[int, str]:
+  """Names `keycodes` with keycode_string(), or in hex if `bench` fails."""
+  keycodes = sorted(set(keycodes))
+  try:
+    result = subprocess.run(
+        [bench, '-k'], input=' '.join(f'0x{k:04X}' for k in keycodes),
+        capture_output=True, text=True, check=True)
+    names = result.stdout.splitlines()
+    if len(names) == len(keycodes):
+      return dict(zip(keycodes, names))
+  except (OSError, subprocess.CalledProcessError):
+    pass
+  print(f'Warning: Could not run "{bench} -k". Writing keycodes in hex.',
+        file=sys.stderr)
+  return {k: f'0x{k:04X}' for k in keycodes}
+
+
+def format_record(r: Record, names: Dict[int, str]) -> str:
+  """Formats a record like dlog_record() in getreuer.c."""
+  if r.flags & COMBO:
+    position = 'combo   '
+  else:
+    position = f'({r.row:2},{r.col:2}) '
+  tap_hold = ''
+  if r.flags & TAP_HOLD:
+    tap_hold = 'tap' if r.flags & TAP else 'hold'
+  action = 'press' if r.flags & PRESSED else 'release'
+  name = names[r.keycode]
+  return f'L{r.layer:<2} {position}{tap_hold:<4} {action:<7} {name}'
+
+
+def decode(lines: List[str], show_time: bool, bench: str) -> Iterable[str]:
+  """Decodes records in `lines`, yielding the output lines."""
+  parsed = []
+  for line in lines:
+    match = RECORD_PATTERN.search(line)
+    parsed.append(parse_record(match.group(1)) if match else line)
+  names = keycode_names(
+      (r.keycode for r in parsed if isinstance(r, Record)), bench)
+
+  time = None
+  for r in parsed:
+    if not isinstance(r, Record):
+      yield r
+      continue
+    if r.flags & DROPPED:
+      yield '# Events dropped: the trace ring was full.'
+    time = 0 if time is None else time + r.dt
+    text = format_record(r, names)
+    yield f'{time:8} {text}' if show_time else text
+
+
+def main(argv):
+  parser = argparse.ArgumentParser(description=__doc__.split('\n')[0])
+  parser.add_argument('input', nargs='?', help='Console log, default stdin.')
+  parser.add_argument('--time', action='store_true',
+                      help='Prefix each event with its time in ms since the '
+                      'first record.')
+  parser.add_argument('--bench', default=DEFAULT_BENCH,
+                      help='Path of replay_bench, for naming keycodes.')
+  args = parser.parse_args(argv[1:])
+
+  if args.input:
+    with open(args.input, 'rt', encoding='utf-8', errors='replace') as f:
+      lines = f.read().splitlines()
+  else:
+    lines = sys.stdin.read().splitlines()
+
+  for line in decode(lines, args.time, args.bench):
+    print(line)
+
+
+if __name__ == '__main__':
+  main(sys.argv)